@@ -1,78 +1,66 @@
 #include "Backend.h"
 
+#include "../core/CatalogSnapshotFile.h"
+#include "../core/Metrics.h"
+#include "../core/Trace.h"
+#include "../shared/ConnectionPool.h"
 #include "../shared/DatabaseUtils.h"
+#include "Thumbnails.h"
 
 #include <QDebug>
 #include <QDateTime>
-#include <QDir>
 #include <QFile>
-#include <QFileInfo>
+#include <QJSEngine>
+#include <QSaveFile>
 #include <memory>
+#include <unordered_map>
 #include <utility>
 #include <QSqlDatabase>
 #include <QSqlQuery>
 #include <QString>
 #include <QSqlError>
-#include <QUrl>
 #include <QDate>
 
 namespace
 {
-QString copyMediaFile(const QString &sourcePath, const QString &targetDir, const QString &prefix)
+const char *kNewTitleType = "movie";
+const char *kNewTitleRating = "PG";
+const char *kNewTitleAccent = "#4F46E5";
+// Stays below the connection pool's limit so async requests leave room for reloads.
+const int kRequestThreads = 4;
+// Each login holds 128 * r * N bytes (16 MiB at the default cost) while it hashes.
+const int kAuthThreads = 2;
+
+Metrics::Histogram &methodDuration(const char *method)
 {
-    const QString trimmed = sourcePath.trimmed();
-    if (trimmed.isEmpty())
-    {
-        return QString();
-    }
-
-    const QUrl url(trimmed);
-    const QString localPath = url.isLocalFile() ? url.toLocalFile() : trimmed;
-
-    QFileInfo info(localPath);
-    if (!info.exists() || !info.isFile())
-    {
-        return QString();
-    }
-
-    QDir dir(targetDir);
-    if (!dir.exists() && !dir.mkpath(QStringLiteral(".")))
-    {
-        return QString();
-    }
-
-    const QString ext = info.suffix().isEmpty() ? QStringLiteral("dat") : info.suffix();
-    const QString baseName = info.completeBaseName().isEmpty() ? prefix : info.completeBaseName();
-    const QString stamp = QDateTime::currentDateTimeUtc().toString(QStringLiteral("yyyyMMddHHmmsszzz"));
-    const QString fileName = QStringLiteral("%1_%2.%3").arg(baseName).arg(stamp).arg(ext);
-    const QString destination = dir.filePath(fileName);
-    QFile::remove(destination);
-    if (!QFile::copy(info.absoluteFilePath(), destination))
-    {
-        return QString();
-    }
-
-    const QString projectRoot = QDir(DatabaseUtils::projectRoot()).filePath(QStringLiteral("FinalProject"));
-    return QDir(projectRoot).relativeFilePath(destination);
+    return Metrics::histogram("finalproject_backend_call_duration_seconds", "Time spent in Backend methods",
+                              {{"method", method}});
 }
 
+// Traces and times one Backend entry point; the histogram is looked up once per method.
+#define BACKEND_METHOD(name)                                                    \
+    TRACE_SCOPE("Backend::" name);                                              \
+    static Metrics::Histogram &backendMethodDuration = methodDuration(name);    \
+    const Metrics::ScopedTimer backendMethodTimer(backendMethodDuration)
+
 class QtSqlDataProvider : public IDataProvider
 {
 public:
     QtSqlDataProvider()
     {
         DatabaseUtils::ensureDatabase();
-        m_db = DatabaseUtils::openDatabase(QStringLiteral("finalproject-backend"));
     }
 
     std::optional<RawMediaItem> fetchFeatured() override
     {
-        if (!m_db.isOpen())
+        auto connection = ConnectionPool::instance().acquire();
+        QSqlDatabase db = connection.database();
+        if (!db.isOpen())
         {
             return std::nullopt;
         }
 
-        QSqlQuery query(m_db);
+        QSqlQuery query(db);
         const QString heroSql = QStringLiteral(
             "SELECT t.id, t.type, t.name, t.description, t.age_rating, t.runtime_min, t.accent_color, "
             "IFNULL(m.thumbnail_url, '') AS thumbnail_url, IFNULL(m.video_url, '') AS video_url, "
@@ -81,7 +69,7 @@ public:
             "FROM titles t LEFT JOIN media_files m ON m.title_id = t.id "
             "ORDER BY t.created_at DESC LIMIT 1");
 
-        if (!query.exec(heroSql) || !query.next())
+        if (!DatabaseUtils::exec(query, heroSql) || !query.next())
         {
             return std::nullopt;
         }
@@ -92,64 +80,79 @@ public:
     std::vector<CategoryWithItems> fetchCategories() override
     {
         std::vector<CategoryWithItems> result;
-        if (!m_db.isOpen())
+        auto connection = ConnectionPool::instance().acquire();
+        QSqlDatabase db = connection.database();
+        if (!db.isOpen())
         {
             return result;
         }
 
-        QSqlQuery genresQuery(m_db);
-        if (!genresQuery.exec(QStringLiteral("SELECT id, name FROM genres ORDER BY name")))
+        // One ordered pass over every (genre, title) pair; rows arrive grouped by genre so
+        // categories can be closed off as the cursor moves instead of querying per genre.
+        QSqlQuery query(db);
+        query.setForwardOnly(true);
+        if (!DatabaseUtils::exec(query, QStringLiteral(
+                "SELECT t.id, t.type, t.name, t.description, t.age_rating, t.runtime_min, t.accent_color, "
+                "IFNULL(m.thumbnail_url, ''), IFNULL(m.video_url, ''), g.id, g.name "
+                "FROM genres g "
+                "JOIN title_genres tg ON tg.genre_id = g.id "
+                "JOIN titles t ON t.id = tg.title_id "
+                "LEFT JOIN media_files m ON m.title_id = t.id "
+                "ORDER BY g.name, g.id, t.created_at DESC")))
         {
             return result;
         }
 
-        while (genresQuery.next())
+        // A title listed under several genres is only converted once.
+        std::unordered_map<int, RawMediaItem> converted;
+        while (query.next())
         {
-            CategoryWithItems item;
-            item.category.id = genresQuery.value(0).toInt();
-            item.category.name = genresQuery.value(1).toString().toStdString();
-            item.items = itemsForGenre(item.category.id, item.category.name);
-            if (!item.items.empty())
+            const int genreId = query.value(9).toInt();
+            if (result.empty() || result.back().category.id != genreId)
+            {
+                CategoryWithItems category;
+                category.category.id = genreId;
+                category.category.name = query.value(10).toString().toStdString();
+                result.push_back(std::move(category));
+            }
+
+            auto &category = result.back();
+            const int titleId = query.value(0).toInt();
+            auto it = converted.find(titleId);
+            if (it == converted.end())
             {
-                result.push_back(std::move(item));
+                it = converted.emplace(titleId, buildItem(query, std::string())).first;
             }
+
+            RawMediaItem item = it->second;
+            item.genre = category.category.name;
+            category.items.push_back(std::move(item));
         }
 
         return result;
     }
 
-private:
-    QSqlDatabase m_db;
-
-    std::vector<RawMediaItem> itemsForGenre(int genreId, const std::string &genreName)
+    std::optional<std::uint64_t> catalogVersion() override
     {
-        std::vector<RawMediaItem> items;
-        QSqlQuery query(m_db);
-        query.prepare(QStringLiteral(
-            "SELECT t.id, t.type, t.name, t.description, t.age_rating, t.runtime_min, t.accent_color, "
-            "IFNULL(m.thumbnail_url, ''), IFNULL(m.video_url, '') "
-            "FROM titles t "
-            "JOIN title_genres tg ON tg.title_id = t.id "
-            "LEFT JOIN media_files m ON m.title_id = t.id "
-            "WHERE tg.genre_id = ? ORDER BY t.created_at DESC"));
-        query.addBindValue(genreId);
-
-        if (!query.exec())
+        auto connection = ConnectionPool::instance().acquire();
+        if (!connection.database().isOpen())
         {
-            return items;
+            return std::nullopt;
         }
 
-        while (query.next())
+        QSqlQuery &query = connection.prepare(QStringLiteral("SELECT version FROM catalog_version WHERE id = 1"));
+        if (!DatabaseUtils::exec(query) || !query.next())
         {
-            items.push_back(buildItem(query, genreName));
+            return std::nullopt;
         }
-
-        return items;
+        return query.value(0).toULongLong();
     }
 
+private:
     RawMediaItem buildItem(const QSqlQuery &query, const std::string &genreName)
     {
         RawMediaItem item;
+        item.id = query.value(0).toInt();
         item.type = query.value(1).toString().toStdString();
         item.title = query.value(2).toString().toStdString();
         item.genre = genreName;
@@ -163,173 +166,406 @@ private:
     }
 };
 
+std::string catalogOrigin()
+{
+    return DatabaseUtils::projectRoot().toStdString();
+}
+
+void saveCatalogFile(const CatalogSnapshot &snapshot, std::uint64_t version)
+{
+    TRACE_SCOPE("saveCatalogFile");
+    const std::string data = CatalogSnapshotFile::serialize(snapshot, version, catalogOrigin());
+    QSaveFile file(DatabaseUtils::catalogSnapshotPath());
+    if (!file.open(QIODevice::WriteOnly) || file.write(data.data(), static_cast<qint64>(data.size())) != static_cast<qint64>(data.size())
+        || !file.commit())
+    {
+        qWarning() << "Unable to write catalog snapshot" << file.fileName() << ":" << file.errorString();
+    }
+}
+
+// The user's first profile, created if they have none yet.
+int ensureDefaultProfile(ConnectionPool::Lease &connection, int userId)
+{
+    QSqlQuery &profileQuery = connection.prepare(QStringLiteral("SELECT id FROM profiles WHERE user_id = ? ORDER BY created_at LIMIT 1"));
+    profileQuery.addBindValue(userId);
+    if (DatabaseUtils::exec(profileQuery) && profileQuery.next())
+    {
+        return profileQuery.value(0).toInt();
+    }
+
+    QSqlQuery &createProfile = connection.prepare(QStringLiteral("INSERT INTO profiles (user_id, name, avatar_url, is_kid) VALUES (?, ?, '', 0)"));
+    createProfile.addBindValue(userId);
+    createProfile.addBindValue(QStringLiteral("Profile 1"));
+    if (!DatabaseUtils::exec(createProfile))
+    {
+        return -1;
+    }
+    return createProfile.lastInsertId().toInt();
+}
+
 class QtAuthRepository : public IAuthRepository
 {
 public:
     QtAuthRepository()
     {
         DatabaseUtils::ensureDatabase();
-        m_db = DatabaseUtils::openDatabase(QStringLiteral("finalproject-auth"));
-        ensureRoleColumn();
-        ensureAdminUser("admin", "admin1234");
+        ensureAdminUser("admin", []() { return PasswordHash::hash("admin1234", PasswordHash::Cost()); });
     }
 
-    bool ensureAdminUser(const std::string &identifier, const std::string &password) override
+    bool ensureAdminUser(const std::string &identifier, const std::function<std::string()> &hashPassword) override
     {
-        if (!ensureOpen())
+        auto connection = ConnectionPool::instance().acquire();
+        QSqlDatabase db = connection.database();
+        if (!db.isOpen())
         {
             return false;
         }
-        QSqlQuery query(m_db);
+        QSqlQuery query(db);
         query.prepare(QStringLiteral("SELECT id FROM users WHERE email = ? LIMIT 1"));
         query.addBindValue(QString::fromStdString(identifier));
-        if (query.exec() && query.next())
+        if (DatabaseUtils::exec(query) && query.next())
         {
             return true;
         }
 
-        QSqlQuery insert(m_db);
+        QSqlQuery insert(db);
         insert.prepare(QStringLiteral("INSERT INTO users (email, password, role) VALUES (?, ?, 'admin')"));
         insert.addBindValue(QString::fromStdString(identifier));
-        insert.addBindValue(QString::fromStdString(password));
-        return insert.exec();
+        insert.addBindValue(QString::fromStdString(hashPassword()));
+        return DatabaseUtils::exec(insert);
     }
 
-    std::optional<AuthUser> findUser(const std::string &identifier, const std::string &password) override
+    std::optional<StoredUser> findUser(const std::string &identifier) override
     {
-        std::optional<AuthUser> result;
-        if (!ensureOpen())
+        std::optional<StoredUser> result;
+        auto connection = ConnectionPool::instance().acquire();
+        QSqlDatabase db = connection.database();
+        if (!db.isOpen())
         {
             return result;
         }
 
-        QSqlQuery query(m_db);
-        query.prepare(QStringLiteral("SELECT role FROM users WHERE email = ? AND password = ? LIMIT 1"));
+        // The password is checked by the caller, off the connection.
+        QSqlQuery &query = connection.prepare(QStringLiteral("SELECT id, role, password FROM users WHERE email = ? LIMIT 1"));
         query.addBindValue(QString::fromStdString(identifier));
-        query.addBindValue(QString::fromStdString(password));
 
-        if (query.exec() && query.next())
+        if (DatabaseUtils::exec(query) && query.next())
         {
-            AuthUser user;
-            user.identifier = identifier;
-            user.role = query.value(0).toString().toStdString();
-            result = user;
+            StoredUser stored;
+            stored.user.identifier = identifier;
+            stored.user.userId = query.value(0).toInt();
+            stored.user.role = query.value(1).toString().toStdString();
+            stored.passwordHash = query.value(2).toString().toStdString();
+            result = std::move(stored);
         }
         return result;
     }
 
-    std::optional<AuthUser> createUser(const std::string &identifier, const std::string &password) override
+    std::optional<AuthUser> createUser(const std::string &identifier, const std::string &passwordHash) override
     {
         std::optional<AuthUser> result;
-        if (!ensureOpen())
+        auto connection = ConnectionPool::instance().acquire();
+        QSqlDatabase db = connection.database();
+        if (!db.isOpen())
         {
             return result;
         }
 
-        if (identifier == "admin")
+        if (identifier == "admin" || passwordHash.empty())
         {
             return result;
         }
 
-        QSqlQuery exists(m_db);
-        exists.prepare(QStringLiteral("SELECT id FROM users WHERE email = ? LIMIT 1"));
+        QSqlQuery &exists = connection.prepare(QStringLiteral("SELECT id FROM users WHERE email = ? LIMIT 1"));
         exists.addBindValue(QString::fromStdString(identifier));
-        if (exists.exec() && exists.next())
+        if (DatabaseUtils::exec(exists) && exists.next())
         {
             return result;
         }
 
-        QSqlQuery insert(m_db);
-        insert.prepare(QStringLiteral("INSERT INTO users (email, password, role) VALUES (?, ?, 'user')"));
+        QSqlQuery &insert = connection.prepare(QStringLiteral("INSERT INTO users (email, password, role) VALUES (?, ?, 'user')"));
         insert.addBindValue(QString::fromStdString(identifier));
-        insert.addBindValue(QString::fromStdString(password));
-        if (insert.exec())
+        insert.addBindValue(QString::fromStdString(passwordHash));
+        if (DatabaseUtils::exec(insert))
         {
             AuthUser user;
             user.identifier = identifier;
             user.role = "user";
-            result = user;
+            user.userId = insert.lastInsertId().toInt();
+            user.profileId = ensureDefaultProfile(connection, user.userId);
+            if (user.profileId >= 0)
+            {
+                result = user;
+            }
         }
         return result;
     }
 
-private:
-    QSqlDatabase m_db;
-
-    bool ensureOpen()
-    {
-        return m_db.isOpen() || m_db.open();
-    }
-
-    void ensureRoleColumn()
+    bool updatePasswordHash(int userId, const std::string &passwordHash) override
     {
-        if (!ensureOpen())
-        {
-            return;
-        }
-
-        QSqlQuery infoQuery(m_db);
-        if (!infoQuery.exec(QStringLiteral("PRAGMA table_info(users)")))
+        auto connection = ConnectionPool::instance().acquire();
+        QSqlDatabase db = connection.database();
+        if (!db.isOpen() || passwordHash.empty())
         {
-            return;
+            return false;
         }
 
-        bool hasRole = false;
-        while (infoQuery.next())
-        {
-            if (infoQuery.value(1).toString() == QStringLiteral("role"))
-            {
-                hasRole = true;
-                break;
-            }
-        }
+        QSqlQuery &update = connection.prepare(QStringLiteral("UPDATE users SET password = ? WHERE id = ?"));
+        update.addBindValue(QString::fromStdString(passwordHash));
+        update.addBindValue(userId);
+        return DatabaseUtils::exec(update);
+    }
 
-        if (!hasRole)
+    std::optional<int> defaultProfile(int userId) override
+    {
+        auto connection = ConnectionPool::instance().acquire();
+        if (!connection.database().isOpen())
         {
-            QSqlQuery alter(m_db);
-            alter.exec(QStringLiteral("ALTER TABLE users ADD COLUMN role TEXT NOT NULL DEFAULT 'user'"));
+            return std::nullopt;
         }
+        const int profileId = ensureDefaultProfile(connection, userId);
+        return profileId >= 0 ? std::optional<int>(profileId) : std::nullopt;
     }
 };
-
-QVariantMap makeVariantItem(const MediaItem &item)
-{
-    QVariantMap map;
-    map.insert(QStringLiteral("type"), QString::fromStdString(item.type));
-    map.insert(QStringLiteral("title"), QString::fromStdString(item.title));
-    map.insert(QStringLiteral("genre"), QString::fromStdString(item.genre));
-    map.insert(QStringLiteral("duration"), QString::fromStdString(item.duration));
-    map.insert(QStringLiteral("rating"), QString::fromStdString(item.rating));
-    map.insert(QStringLiteral("description"), QString::fromStdString(item.description));
-    map.insert(QStringLiteral("accentColor"), QString::fromStdString(item.accentColor));
-    map.insert(QStringLiteral("thumbnailUrl"), QString::fromStdString(item.thumbnailUrl));
-    map.insert(QStringLiteral("videoUrl"), QString::fromStdString(item.videoUrl));
-    return map;
-}
 } // namespace
 
 Backend::Backend(std::unique_ptr<IDataProvider> provider, QObject *parent)
     : QObject(parent)
     , m_service(std::move(provider))
+    , m_movieCatalogModel(QStringLiteral("movie"))
+    , m_seriesCatalogModel(QStringLiteral("series"))
     , m_authRepository(std::make_unique<QtAuthRepository>())
     , m_authService(m_authRepository.get())
 {
+    m_reloadPool.setMaxThreadCount(1);
+    m_requestPool.setMaxThreadCount(kRequestThreads);
+    m_authPool.setMaxThreadCount(kAuthThreads);
+    m_movieCatalogModel.setSourceModel(&m_catalogModel);
+    m_seriesCatalogModel.setSourceModel(&m_catalogModel);
+    connect(&m_ingestor, &MediaIngestor::progress, this, &Backend::ingestionProgress);
+    connect(&m_ingestor, &MediaIngestor::finished, this, &Backend::ingestionFinished);
+}
+
+Backend::~Backend()
+{
+    ++m_reloadGeneration;
+    for (const auto &request : std::as_const(m_pendingRequests))
+    {
+        *request.cancelled = true;
+    }
+    m_reloadPool.waitForDone();
+    m_requestPool.waitForDone();
+    m_authPool.waitForDone();
 }
 
 void Backend::reload()
 {
-    m_service.reload();
+    BACKEND_METHOD("reload");
+    const auto call = m_recorder.begin("reload");
+    requestReload();
+}
+
+void Backend::requestReload()
+{
+    // Whatever build is in flight is stale from here on; it is cancelled at its next
+    // checkpoint and a single follow-up build covers every request made meanwhile.
+    ++m_reloadGeneration;
+    if (m_reloadRunning)
+    {
+        m_reloadQueued = true;
+        return;
+    }
+    startReload();
+}
+
+bool Backend::loadCachedCatalog()
+{
+    TRACE_SCOPE("Backend::loadCachedCatalog");
+    // Only meaningful before the first reload; afterwards the published catalog is newer.
+    if (m_reloadGeneration.load() != 0)
+    {
+        return false;
+    }
+
+    QFile file(DatabaseUtils::catalogSnapshotPath());
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        return false;
+    }
+
+    const qint64 size = file.size();
+    uchar *mapped = size > 0 ? file.map(0, size) : nullptr;
+    QByteArray contents;
+    if (!mapped)
+    {
+        contents = file.readAll();
+    }
+    const char *data = mapped ? reinterpret_cast<const char *>(mapped) : contents.constData();
+    auto decoded = CatalogSnapshotFile::deserialize(data, static_cast<std::size_t>(size), catalogOrigin());
+    if (mapped)
+    {
+        file.unmap(mapped);
+    }
+    if (!decoded)
+    {
+        qDebug() << "Ignoring unusable catalog snapshot" << file.fileName();
+        return false;
+    }
+
+    m_service.publish(decoded->snapshot);
+    m_catalogModel.setSnapshot(std::move(decoded->snapshot));
+    m_catalogVersion = decoded->catalogVersion;
+    rebuildSearchIndex();
     emit dataChanged();
+    emit heroItemChanged();
+    return true;
+}
+
+void Backend::startReload()
+{
+    m_reloadRunning = true;
+    m_reloadQueued = false;
+
+    const quint64 generation = m_reloadGeneration.load();
+    const std::optional<std::uint64_t> publishedVersion = m_catalogVersion;
+    m_reloadPool.start([this, generation, publishedVersion]() {
+        TRACE_SCOPE("Backend::buildCatalog");
+        // Read before building: a change that lands mid-build leaves the saved version behind
+        // the data, which only costs one extra rebuild on the next start.
+        const auto version = m_service.catalogVersion();
+        StreamingService::Snapshot snapshot;
+        if (!version || version != publishedVersion)
+        {
+            const auto started = std::chrono::steady_clock::now();
+            snapshot = m_service.buildSnapshot([this, generation]() {
+                return m_reloadGeneration.load() != generation;
+            });
+            // Cancelled builds would only blur the figure.
+            if (snapshot)
+            {
+                static Metrics::Histogram &reloadDuration = Metrics::histogram(
+                    "finalproject_catalog_reload_duration_seconds", "Time to build the catalog from the database");
+                reloadDuration.record(static_cast<std::uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - started).count()));
+            }
+            if (snapshot && version)
+            {
+                saveCatalogFile(*snapshot, *version);
+            }
+        }
+        QMetaObject::invokeMethod(this, [this, generation, snapshot, version]() {
+            finishReload(generation, snapshot, version);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void Backend::finishReload(quint64 generation, StreamingService::Snapshot snapshot, std::optional<std::uint64_t> version)
+{
+    TRACE_SCOPE("Backend::finishReload");
+    m_reloadRunning = false;
+    if (snapshot && generation == m_reloadGeneration.load())
+    {
+        m_catalogVersion = version;
+        m_service.publish(snapshot);
+        m_catalogModel.setSnapshot(std::move(snapshot));
+        rebuildSearchIndex();
+        emit dataChanged();
+        emit heroItemChanged();
+    }
+
+    if (m_reloadQueued)
+    {
+        startReload();
+    }
+}
+
+void Backend::applyDelta(const CatalogDelta &delta)
+{
+    TRACE_SCOPE("Backend::applyDelta");
+    if (delta.empty())
+    {
+        return;
+    }
+
+    // A build that is still running may have read the tables before this insert landed.
+    if (m_reloadRunning)
+    {
+        requestReload();
+    }
+
+    m_catalogModel.applyDelta(m_service.snapshot(), delta);
+    rebuildSearchIndex();
+
+    for (const auto row : delta.insertedCategories)
+    {
+        emit categoryInserted(static_cast<int>(row));
+    }
+    for (const auto &insert : delta.insertedItems)
+    {
+        emit categoryItemsInserted(static_cast<int>(insert.category), static_cast<int>(insert.first),
+                                   static_cast<int>(insert.count));
+    }
+    if (delta.featuredChanged)
+    {
+        emit heroItemChanged();
+    }
+}
+
+void Backend::rebuildSearchIndex()
+{
+    m_reloadPool.start([this, snapshot = m_service.snapshot()]() {
+        TRACE_SCOPE("Backend::buildSearchIndex");
+        auto index = std::make_shared<const SearchIndex>(snapshot);
+        QMetaObject::invokeMethod(this, [this, index = std::move(index)]() {
+            // A later publish has its own build queued behind this one.
+            if (m_service.snapshot() == index->snapshot())
+            {
+                m_searchIndex = index;
+            }
+        }, Qt::QueuedConnection);
+    });
 }
 
 QVariantMap Backend::heroItem() const
 {
-    return toVariant(m_service.featuredItem());
+    BACKEND_METHOD("heroItem");
+    const auto call = m_recorder.begin("heroItem");
+    const auto snapshot = m_service.snapshot();
+    const MediaItem *featured = snapshot->featuredItem();
+    return featured ? toVariant(*featured) : QVariantMap();
 }
 
-QVariantList Backend::categories() const
+QVariantList Backend::search(const QString &query, int limit) const
 {
-    return toVariant(m_service.categories());
+    BACKEND_METHOD("search");
+    const auto call = m_recorder.begin("search", query, limit);
+    QVariantList results;
+    if (!m_searchIndex || limit <= 0)
+    {
+        return results;
+    }
+
+    const auto &snapshot = m_searchIndex->snapshot();
+    for (const auto &hit : m_searchIndex->search(query.toStdString(), static_cast<std::size_t>(limit)))
+    {
+        results.append(toVariant(snapshot->item(hit.item)));
+    }
+    return results;
+}
+
+QAbstractItemModel *Backend::catalog()
+{
+    return &m_catalogModel;
+}
+
+QAbstractItemModel *Backend::movieCatalog()
+{
+    return &m_movieCatalogModel;
+}
+
+QAbstractItemModel *Backend::seriesCatalog()
+{
+    return &m_seriesCatalogModel;
 }
 
 QVariantMap Backend::authenticate(const QString &mode,
@@ -338,6 +574,8 @@ QVariantMap Backend::authenticate(const QString &mode,
                                   const QString &password,
                                   const QString &confirmPassword)
 {
+    BACKEND_METHOD("authenticate");
+    auto call = m_recorder.begin("authenticate", mode, role, identifier);
     const auto result = m_authService.authenticate(mode.toStdString(),
                                                    role.toStdString(),
                                                    identifier.toStdString(),
@@ -348,20 +586,42 @@ QVariantMap Backend::authenticate(const QString &mode,
     map.insert(QStringLiteral("success"), result.success);
     map.insert(QStringLiteral("message"), QString::fromStdString(result.message));
     map.insert(QStringLiteral("role"), QString::fromStdString(result.role.empty() ? "user" : result.role));
+    if (result.session)
+    {
+        map.insert(QStringLiteral("token"), QString::fromStdString(result.session->token));
+        map.insert(QStringLiteral("userId"), result.session->userId);
+        map.insert(QStringLiteral("profileId"), result.session->profileId);
+    }
+    call.setResult(map);
     return map;
 }
 
+void Backend::endSession(const QString &token)
+{
+    BACKEND_METHOD("endSession");
+    const auto call = m_recorder.begin("endSession", token);
+    m_authService.endSession(token.toStdString());
+}
+
+std::optional<Session> Backend::session(const QString &token) const
+{
+    return m_authService.session(token.toStdString());
+}
+
 QVariantList Backend::listUsers() const
 {
+    BACKEND_METHOD("listUsers");
+    const auto call = m_recorder.begin("listUsers");
     QVariantList users;
-    auto db = DatabaseUtils::openDatabase(QStringLiteral("finalproject-admin-list"));
+    auto connection = ConnectionPool::instance().acquire();
+    QSqlDatabase db = connection.database();
     if (!db.isOpen())
     {
         return users;
     }
 
     QSqlQuery query(db);
-    if (!query.exec(QStringLiteral("SELECT email, role, created_at FROM users ORDER BY created_at DESC")))
+    if (!DatabaseUtils::exec(query, QStringLiteral("SELECT email, role, created_at FROM users ORDER BY created_at DESC")))
     {
         return users;
     }
@@ -379,15 +639,18 @@ QVariantList Backend::listUsers() const
 
 QVariantList Backend::listGenres() const
 {
+    BACKEND_METHOD("listGenres");
+    const auto call = m_recorder.begin("listGenres");
     QVariantList genres;
-    auto db = DatabaseUtils::openDatabase(QStringLiteral("finalproject-admin-genres"));
+    auto connection = ConnectionPool::instance().acquire();
+    QSqlDatabase db = connection.database();
     if (!db.isOpen())
     {
         return genres;
     }
 
     QSqlQuery query(db);
-    if (!query.exec(QStringLiteral("SELECT name FROM genres ORDER BY name")))
+    if (!DatabaseUtils::exec(query, QStringLiteral("SELECT name FROM genres ORDER BY name")))
     {
         return genres;
     }
@@ -401,10 +664,13 @@ QVariantList Backend::listGenres() const
 
 QVariantMap Backend::addGenre(const QString &name)
 {
+    BACKEND_METHOD("addGenre");
+    const auto call = m_recorder.begin("addGenre", name);
     QVariantMap result;
     result.insert(QStringLiteral("success"), false);
 
-    auto db = DatabaseUtils::openDatabase(QStringLiteral("finalproject-admin-add-genre"));
+    auto connection = ConnectionPool::instance().acquire();
+    QSqlDatabase db = connection.database();
     if (!db.isOpen())
     {
         result.insert(QStringLiteral("message"), QStringLiteral("Database unavailable"));
@@ -421,7 +687,7 @@ QVariantMap Backend::addGenre(const QString &name)
     QSqlQuery exists(db);
     exists.prepare(QStringLiteral("SELECT id FROM genres WHERE lower(name) = lower(?) LIMIT 1"));
     exists.addBindValue(trimmed);
-    if (exists.exec() && exists.next())
+    if (DatabaseUtils::exec(exists) && exists.next())
     {
         result.insert(QStringLiteral("message"), QStringLiteral("Genre already exists"));
         return result;
@@ -430,7 +696,7 @@ QVariantMap Backend::addGenre(const QString &name)
     QSqlQuery insert(db);
     insert.prepare(QStringLiteral("INSERT INTO genres (name) VALUES (?)"));
     insert.addBindValue(trimmed);
-    if (!insert.exec())
+    if (!DatabaseUtils::exec(insert))
     {
         result.insert(QStringLiteral("message"), QStringLiteral("Failed to add genre"));
         return result;
@@ -447,17 +713,30 @@ QVariantMap Backend::addMovie(const QString &name,
                               int runtimeMinutes,
                               const QString &thumbnailPath,
                               const QString &videoPath)
+{
+    BACKEND_METHOD("addMovie");
+    const auto call = m_recorder.begin("addMovie", name, description, genre, runtimeMinutes, thumbnailPath, videoPath);
+    return startMovieIngestion(name, description, genre, runtimeMinutes, thumbnailPath, videoPath, {});
+}
+
+void Backend::cancelIngestion(int jobId)
+{
+    BACKEND_METHOD("cancelIngestion");
+    const auto call = m_recorder.begin("cancelIngestion", jobId);
+    m_ingestor.cancel(jobId);
+}
+
+QVariantMap Backend::startMovieIngestion(const QString &name,
+                                         const QString &description,
+                                         const QString &genre,
+                                         int runtimeMinutes,
+                                         const QString &thumbnailPath,
+                                         const QString &videoPath,
+                                         std::function<void(const QVariantMap &)> whenLanded)
 {
     QVariantMap result;
     result.insert(QStringLiteral("success"), false);
 
-    auto db = DatabaseUtils::openDatabase(QStringLiteral("finalproject-admin-add"));
-    if (!db.isOpen())
-    {
-        result.insert(QStringLiteral("message"), QStringLiteral("Database unavailable"));
-        return result;
-    }
-
     const QString trimmedName = name.trimmed();
     if (trimmedName.isEmpty())
     {
@@ -472,14 +751,72 @@ QVariantMap Backend::addMovie(const QString &name,
         return result;
     }
 
-    DatabaseUtils::ensureStorageDirectories();
+    // The title is only written once its media has landed, so the catalog never lists a
+    // movie whose files are still being copied.
+    const QVector<IngestFile> files = {
+        {videoPath, DatabaseUtils::videosDirectory()},
+        {thumbnailPath, DatabaseUtils::imagesDirectory()},
+    };
+    auto inserted = std::make_shared<std::optional<TitleWithGenres>>();
+    const int jobId = m_ingestor.start(
+        trimmedName, files,
+        [this, trimmedName, description, trimmedGenre, runtimeMinutes, inserted](const QVector<StoredBlob> &stored) {
+            const QString thumbnail = stored.value(1).path;
+            QString error;
+            if (!thumbnail.isEmpty() && !Thumbnails::generate(DatabaseUtils::toAbsoluteMediaPath(thumbnail), &error))
+            {
+                // Views fall back to decoding the original at their size.
+                qWarning() << "Thumbnail variants failed for" << thumbnail << ":" << error;
+            }
+            return insertMovie(trimmedName, description, trimmedGenre, runtimeMinutes, stored.value(1), stored.value(0), *inserted);
+        },
+        [this, inserted, whenLanded = std::move(whenLanded)](const QVariantMap &landed) {
+            // refresh cache for UI without re-reading the whole catalog
+            if (*inserted)
+            {
+                applyDelta(m_service.insertTitles({**inserted}));
+            }
+            if (whenLanded)
+            {
+                whenLanded(landed);
+            }
+        });
+
+    result.insert(QStringLiteral("success"), true);
+    result.insert(QStringLiteral("message"), QStringLiteral("Upload started"));
+    result.insert(QStringLiteral("jobId"), jobId);
+    return result;
+}
+
+QVariantMap Backend::insertMovie(const QString &name,
+                                 const QString &description,
+                                 const QString &genre,
+                                 int runtimeMinutes,
+                                 const StoredBlob &thumbnail,
+                                 const StoredBlob &video,
+                                 std::optional<TitleWithGenres> &inserted) const
+{
+    TRACE_SCOPE("Backend::insertMovie");
+    QVariantMap result;
+    result.insert(QStringLiteral("success"), false);
+
+    auto connection = ConnectionPool::instance().acquire();
+    QSqlDatabase db = connection.database();
+    if (!db.isOpen() || !db.transaction())
+    {
+        result.insert(QStringLiteral("message"), QStringLiteral("Database unavailable"));
+        return result;
+    }
+
+    const QString trimmedName = name.trimmed();
+    const QString trimmedGenre = genre.trimmed();
 
     QSqlQuery genreQuery(db);
     genreQuery.prepare(QStringLiteral("SELECT id FROM genres WHERE name = ? LIMIT 1"));
     genreQuery.addBindValue(trimmedGenre);
 
     int genreId = -1;
-    if (genreQuery.exec() && genreQuery.next())
+    if (DatabaseUtils::exec(genreQuery) && genreQuery.next())
     {
         genreId = genreQuery.value(0).toInt();
     }
@@ -488,7 +825,7 @@ QVariantMap Backend::addMovie(const QString &name,
         QSqlQuery insertGenre(db);
         insertGenre.prepare(QStringLiteral("INSERT INTO genres (name) VALUES (?)"));
         insertGenre.addBindValue(trimmedGenre);
-        if (insertGenre.exec())
+        if (DatabaseUtils::exec(insertGenre))
         {
             genreId = insertGenre.lastInsertId().toInt();
         }
@@ -497,14 +834,17 @@ QVariantMap Backend::addMovie(const QString &name,
     QSqlQuery titleQuery(db);
     titleQuery.prepare(QStringLiteral(
         "INSERT INTO titles (type, name, description, age_rating, runtime_min, accent_color) "
-        "VALUES ('movie', ?, ?, 'PG', ?, ?)"));
+        "VALUES (?, ?, ?, ?, ?, ?)"));
+    titleQuery.addBindValue(QString::fromLatin1(kNewTitleType));
     titleQuery.addBindValue(trimmedName);
     titleQuery.addBindValue(description.trimmed());
+    titleQuery.addBindValue(QString::fromLatin1(kNewTitleRating));
     titleQuery.addBindValue(runtimeMinutes);
-    titleQuery.addBindValue(QStringLiteral("#4F46E5"));
+    titleQuery.addBindValue(QString::fromLatin1(kNewTitleAccent));
 
-    if (!titleQuery.exec())
+    if (!DatabaseUtils::exec(titleQuery))
     {
+        db.rollback();
         result.insert(QStringLiteral("message"), QStringLiteral("Failed to insert title"));
         return result;
     }
@@ -517,67 +857,99 @@ QVariantMap Backend::addMovie(const QString &name,
         linkQuery.prepare(QStringLiteral("INSERT INTO title_genres (title_id, genre_id) VALUES (?, ?)"));
         linkQuery.addBindValue(titleId);
         linkQuery.addBindValue(genreId);
-        linkQuery.exec();
+        DatabaseUtils::exec(linkQuery);
     }
 
-    const QString storedVideoPath = copyMediaFile(videoPath, DatabaseUtils::videosDirectory(), QStringLiteral("video"));
-    const QString storedThumbnailPath = copyMediaFile(thumbnailPath, DatabaseUtils::imagesDirectory(), QStringLiteral("thumb"));
+    // Blobs are registered before media_files so its triggers find them to count the reference.
+    QSqlQuery blobQuery(db);
+    blobQuery.prepare(QStringLiteral(
+        "INSERT INTO media_blobs (path, hash, size) VALUES (?, ?, ?) ON CONFLICT (path) DO NOTHING"));
+    bool blobsStored = true;
+    for (const StoredBlob *blob : {&video, &thumbnail})
+    {
+        if (blob->path.isEmpty())
+        {
+            continue;
+        }
+        blobQuery.addBindValue(blob->path);
+        blobQuery.addBindValue(blob->hash);
+        blobQuery.addBindValue(blob->size);
+        blobsStored = DatabaseUtils::exec(blobQuery) && blobsStored;
+    }
 
     QSqlQuery mediaQuery(db);
     mediaQuery.prepare(QStringLiteral(
         "INSERT INTO media_files (title_id, video_url, thumbnail_url) VALUES (?, ?, ?)"));
     mediaQuery.addBindValue(titleId);
-    mediaQuery.addBindValue(storedVideoPath);
-    mediaQuery.addBindValue(storedThumbnailPath);
-    mediaQuery.exec();
+    mediaQuery.addBindValue(video.path);
+    mediaQuery.addBindValue(thumbnail.path);
+    if (!blobsStored || !DatabaseUtils::exec(mediaQuery) || !db.commit())
+    {
+        db.rollback();
+        result.insert(QStringLiteral("message"), QStringLiteral("Failed to store media"));
+        return result;
+    }
 
     result.insert(QStringLiteral("success"), true);
     result.insert(QStringLiteral("message"), QStringLiteral("Movie added"));
 
-    // refresh cache for UI
-    m_service.reload();
-    emit dataChanged();
+    TitleWithGenres title;
+    title.item.id = titleId;
+    title.item.type = kNewTitleType;
+    title.item.title = trimmedName.toStdString();
+    title.item.description = description.trimmed().toStdString();
+    title.item.rating = kNewTitleRating;
+    title.item.durationMinutes = runtimeMinutes;
+    title.item.accentColor = kNewTitleAccent;
+    title.item.thumbnailUrl = DatabaseUtils::toFileUrl(thumbnail.path).toStdString();
+    title.item.videoUrl = DatabaseUtils::toFileUrl(video.path).toStdString();
+    if (genreId > 0)
+    {
+        title.genres.push_back({genreId, trimmedGenre.toStdString()});
+    }
+    inserted = std::move(title);
     return result;
 }
 
-QVariantMap Backend::userProfile(const QString &identifier) const
+QVariantMap Backend::userProfile(const QString &token) const
 {
+    BACKEND_METHOD("userProfile");
+    const auto call = m_recorder.begin("userProfile", token);
     QVariantMap result;
     result.insert(QStringLiteral("success"), false);
 
-    auto db = DatabaseUtils::openDatabase(QStringLiteral("finalproject-user-profile"));
-    if (!db.isOpen())
+    const auto current = session(token);
+    if (!current)
     {
-        result.insert(QStringLiteral("message"), QStringLiteral("Database unavailable"));
+        result.insert(QStringLiteral("message"), QStringLiteral("Not signed in"));
         return result;
     }
 
-    const QString email = identifier.trimmed();
-    if (email.isEmpty())
+    auto connection = ConnectionPool::instance().acquire();
+    QSqlDatabase db = connection.database();
+    if (!db.isOpen())
     {
-        result.insert(QStringLiteral("message"), QStringLiteral("Identifier is required"));
+        result.insert(QStringLiteral("message"), QStringLiteral("Database unavailable"));
         return result;
     }
 
-    QSqlQuery userQuery(db);
-    userQuery.prepare(QStringLiteral("SELECT id, email, created_at, role FROM users WHERE email = ? LIMIT 1"));
-    userQuery.addBindValue(email);
-    if (!userQuery.exec() || !userQuery.next())
+    const int userId = current->userId;
+    QSqlQuery &userQuery = connection.prepare(QStringLiteral("SELECT email, created_at, role FROM users WHERE id = ?"));
+    userQuery.addBindValue(userId);
+    if (!DatabaseUtils::exec(userQuery) || !userQuery.next())
     {
         result.insert(QStringLiteral("message"), QStringLiteral("User not found"));
         return result;
     }
 
-    const int userId = userQuery.value(0).toInt();
     QVariantMap userInfo;
-    userInfo.insert(QStringLiteral("email"), userQuery.value(1).toString());
-    userInfo.insert(QStringLiteral("createdAt"), userQuery.value(2).toString());
-    userInfo.insert(QStringLiteral("role"), userQuery.value(3).toString());
+    userInfo.insert(QStringLiteral("email"), userQuery.value(0).toString());
+    userInfo.insert(QStringLiteral("createdAt"), userQuery.value(1).toString());
+    userInfo.insert(QStringLiteral("role"), userQuery.value(2).toString());
     result.insert(QStringLiteral("user"), userInfo);
 
     QVariantMap subscription;
-    QSqlQuery subQuery(db);
-    subQuery.prepare(QStringLiteral(
+    QSqlQuery &subQuery = connection.prepare(QStringLiteral(
         "SELECT sp.name, sp.price_month, sp.duration_days, sp.max_quality, "
         "us.start_date, us.end_date, us.is_active "
         "FROM user_subscriptions us "
@@ -585,7 +957,7 @@ QVariantMap Backend::userProfile(const QString &identifier) const
         "WHERE us.user_id = ? "
         "ORDER BY us.created_at DESC LIMIT 1"));
     subQuery.addBindValue(userId);
-    if (subQuery.exec() && subQuery.next())
+    if (DatabaseUtils::exec(subQuery) && subQuery.next())
     {
         subscription.insert(QStringLiteral("planName"), subQuery.value(0).toString());
         subscription.insert(QStringLiteral("priceMonth"), subQuery.value(1).toDouble());
@@ -598,12 +970,11 @@ QVariantMap Backend::userProfile(const QString &identifier) const
     result.insert(QStringLiteral("subscription"), subscription);
 
     QVariantList profiles;
-    QSqlQuery profilesQuery(db);
-    profilesQuery.prepare(QStringLiteral(
+    QSqlQuery &profilesQuery = connection.prepare(QStringLiteral(
         "SELECT id, name, avatar_url, is_kid, created_at FROM profiles "
         "WHERE user_id = ? ORDER BY created_at DESC"));
     profilesQuery.addBindValue(userId);
-    if (profilesQuery.exec())
+    if (DatabaseUtils::exec(profilesQuery))
     {
         while (profilesQuery.next())
         {
@@ -619,8 +990,7 @@ QVariantMap Backend::userProfile(const QString &identifier) const
     result.insert(QStringLiteral("profiles"), profiles);
 
     QVariantList history;
-    QSqlQuery historyQuery(db);
-    historyQuery.prepare(QStringLiteral(
+    QSqlQuery &historyQuery = connection.prepare(QStringLiteral(
         "SELECT t.name, t.runtime_min, IFNULL(m.thumbnail_url, ''), IFNULL(m.video_url, ''), "
         "wh.position_sec, wh.is_finished, wh.updated_at "
         "FROM watch_history wh "
@@ -629,7 +999,7 @@ QVariantMap Backend::userProfile(const QString &identifier) const
         "WHERE wh.profile_id IN (SELECT id FROM profiles WHERE user_id = ?) "
         "ORDER BY wh.updated_at DESC LIMIT 15"));
     historyQuery.addBindValue(userId);
-    if (historyQuery.exec())
+    if (DatabaseUtils::exec(historyQuery))
     {
         while (historyQuery.next())
         {
@@ -647,8 +1017,7 @@ QVariantMap Backend::userProfile(const QString &identifier) const
     result.insert(QStringLiteral("history"), history);
 
     QVariantList myList;
-    QSqlQuery listQuery(db);
-    listQuery.prepare(QStringLiteral(
+    QSqlQuery &listQuery = connection.prepare(QStringLiteral(
         "SELECT t.name, IFNULL(m.thumbnail_url, ''), IFNULL(m.video_url, ''), "
         "t.runtime_min, t.accent_color, l.added_at "
         "FROM my_list l "
@@ -657,7 +1026,7 @@ QVariantMap Backend::userProfile(const QString &identifier) const
         "WHERE l.profile_id IN (SELECT id FROM profiles WHERE user_id = ?) "
         "ORDER BY l.added_at DESC LIMIT 20"));
     listQuery.addBindValue(userId);
-    if (listQuery.exec())
+    if (DatabaseUtils::exec(listQuery))
     {
         while (listQuery.next())
         {
@@ -683,83 +1052,56 @@ QVariantMap Backend::userProfile(const QString &identifier) const
     return result;
 }
 
-QVariantMap Backend::addToMyList(const QString &identifier, const QString &title) const
+QVariantMap Backend::addToMyList(const QString &token, int titleId) const
 {
+    BACKEND_METHOD("addToMyList");
+    const auto call = m_recorder.begin("addToMyList", token, titleId);
     QVariantMap result;
     result.insert(QStringLiteral("success"), false);
 
-    auto db = DatabaseUtils::openDatabase(QStringLiteral("finalproject-mylist-add"));
-    if (!db.isOpen())
+    const auto current = session(token);
+    if (!current)
     {
-        result.insert(QStringLiteral("message"), QStringLiteral("Database unavailable"));
+        result.insert(QStringLiteral("message"), QStringLiteral("Not signed in"));
         return result;
     }
 
-    const QString email = identifier.trimmed();
-    const QString titleName = title.trimmed();
-    if (email.isEmpty() || titleName.isEmpty())
+    auto connection = ConnectionPool::instance().acquire();
+    QSqlDatabase db = connection.database();
+    if (!db.isOpen())
     {
-        result.insert(QStringLiteral("message"), QStringLiteral("User and title are required"));
+        result.insert(QStringLiteral("message"), QStringLiteral("Database unavailable"));
         return result;
     }
 
-    QSqlQuery userQuery(db);
-    userQuery.prepare(QStringLiteral("SELECT id FROM users WHERE email = ? LIMIT 1"));
-    userQuery.addBindValue(email);
-    if (!userQuery.exec() || !userQuery.next())
+    if (titleId <= 0)
     {
-        result.insert(QStringLiteral("message"), QStringLiteral("User not found"));
+        result.insert(QStringLiteral("message"), QStringLiteral("Title is required"));
         return result;
     }
-    const int userId = userQuery.value(0).toInt();
+    const int profileId = current->profileId;
 
-    int profileId = -1;
-    QSqlQuery profileQuery(db);
-    profileQuery.prepare(QStringLiteral("SELECT id FROM profiles WHERE user_id = ? ORDER BY created_at LIMIT 1"));
-    profileQuery.addBindValue(userId);
-    if (profileQuery.exec() && profileQuery.next())
-    {
-        profileId = profileQuery.value(0).toInt();
-    }
-    else
-    {
-        QSqlQuery createProfile(db);
-        createProfile.prepare(QStringLiteral("INSERT INTO profiles (user_id, name, avatar_url, is_kid) VALUES (?, ?, '', 0)"));
-        createProfile.addBindValue(userId);
-        createProfile.addBindValue(QStringLiteral("Profile 1"));
-        if (!createProfile.exec())
-        {
-            result.insert(QStringLiteral("message"), QStringLiteral("Failed to create profile"));
-            return result;
-        }
-        profileId = createProfile.lastInsertId().toInt();
-    }
-
-    QSqlQuery titleQuery(db);
-    titleQuery.prepare(QStringLiteral("SELECT id FROM titles WHERE lower(name) = lower(?) ORDER BY created_at DESC LIMIT 1"));
-    titleQuery.addBindValue(titleName);
-    if (!titleQuery.exec() || !titleQuery.next())
+    QSqlQuery &titleQuery = connection.prepare(QStringLiteral("SELECT 1 FROM titles WHERE id = ?"));
+    titleQuery.addBindValue(titleId);
+    if (!DatabaseUtils::exec(titleQuery) || !titleQuery.next())
     {
         result.insert(QStringLiteral("message"), QStringLiteral("Title not found"));
         return result;
     }
-    const int titleId = titleQuery.value(0).toInt();
 
-    QSqlQuery exists(db);
-    exists.prepare(QStringLiteral("SELECT 1 FROM my_list WHERE profile_id = ? AND title_id = ? LIMIT 1"));
+    QSqlQuery &exists = connection.prepare(QStringLiteral("SELECT 1 FROM my_list WHERE profile_id = ? AND title_id = ? LIMIT 1"));
     exists.addBindValue(profileId);
     exists.addBindValue(titleId);
-    if (exists.exec() && exists.next())
+    if (DatabaseUtils::exec(exists) && exists.next())
     {
         result.insert(QStringLiteral("message"), QStringLiteral("Already in My List"));
         return result;
     }
 
-    QSqlQuery insert(db);
-    insert.prepare(QStringLiteral("INSERT INTO my_list (profile_id, title_id) VALUES (?, ?)"));
+    QSqlQuery &insert = connection.prepare(QStringLiteral("INSERT INTO my_list (profile_id, title_id) VALUES (?, ?)"));
     insert.addBindValue(profileId);
     insert.addBindValue(titleId);
-    if (!insert.exec())
+    if (!DatabaseUtils::exec(insert))
     {
         result.insert(QStringLiteral("message"), QStringLiteral("Failed to add to My List"));
         return result;
@@ -772,15 +1114,18 @@ QVariantMap Backend::addToMyList(const QString &identifier, const QString &title
 
 QVariantList Backend::listPlans() const
 {
+    BACKEND_METHOD("listPlans");
+    const auto call = m_recorder.begin("listPlans");
     QVariantList plans;
-    auto db = DatabaseUtils::openDatabase(QStringLiteral("finalproject-plans"));
+    auto connection = ConnectionPool::instance().acquire();
+    QSqlDatabase db = connection.database();
     if (!db.isOpen())
     {
         return plans;
     }
 
     QSqlQuery seed(db);
-    if (seed.exec(QStringLiteral("SELECT COUNT(1) FROM subscription_plans")) && seed.next())
+    if (DatabaseUtils::exec(seed, QStringLiteral("SELECT COUNT(1) FROM subscription_plans")) && seed.next())
     {
         if (seed.value(0).toInt() == 0)
         {
@@ -791,12 +1136,12 @@ QVariantList Backend::listPlans() const
                 "('Basic', 9.99, 30, 1, 'HD'),"
                 "('Standard', 14.99, 30, 2, 'Full HD'),"
                 "('Premium', 19.99, 30, 4, '4K')"));
-            insert.exec();
+            DatabaseUtils::exec(insert);
         }
     }
 
     QSqlQuery query(db);
-    if (!query.exec(QStringLiteral("SELECT id, name, price_month, duration_days, max_profiles, max_quality FROM subscription_plans ORDER BY price_month ASC")))
+    if (!DatabaseUtils::exec(query, QStringLiteral("SELECT id, name, price_month, duration_days, max_profiles, max_quality FROM subscription_plans ORDER BY price_month ASC")))
     {
         return plans;
     }
@@ -815,136 +1160,424 @@ QVariantList Backend::listPlans() const
     return plans;
 }
 
-QVariantMap Backend::subscribePlan(const QString &identifier, int planId) const
+QVariantMap Backend::subscribePlan(const QString &token, int planId)
 {
+    BACKEND_METHOD("subscribePlan");
+    const auto call = m_recorder.begin("subscribePlan", token, planId);
     QVariantMap result;
     result.insert(QStringLiteral("success"), false);
 
-    auto db = DatabaseUtils::openDatabase(QStringLiteral("finalproject-plans-subscribe"));
-    if (!db.isOpen())
+    const auto current = session(token);
+    if (!current)
     {
-        result.insert(QStringLiteral("message"), QStringLiteral("Database unavailable"));
+        result.insert(QStringLiteral("message"), QStringLiteral("Not signed in"));
         return result;
     }
 
-    const QString email = identifier.trimmed();
-    if (email.isEmpty() || planId <= 0)
+    auto connection = ConnectionPool::instance().acquire();
+    QSqlDatabase db = connection.database();
+    if (!db.isOpen())
     {
-        result.insert(QStringLiteral("message"), QStringLiteral("User and plan are required"));
+        result.insert(QStringLiteral("message"), QStringLiteral("Database unavailable"));
         return result;
     }
 
-    QSqlQuery userQuery(db);
-    userQuery.prepare(QStringLiteral("SELECT id FROM users WHERE email = ? LIMIT 1"));
-    userQuery.addBindValue(email);
-    if (!userQuery.exec() || !userQuery.next())
+    if (planId <= 0)
     {
-        result.insert(QStringLiteral("message"), QStringLiteral("User not found"));
+        result.insert(QStringLiteral("message"), QStringLiteral("Plan is required"));
         return result;
     }
-    const int userId = userQuery.value(0).toInt();
+    const int userId = current->userId;
 
-    QSqlQuery planQuery(db);
-    planQuery.prepare(QStringLiteral("SELECT id, duration_days FROM subscription_plans WHERE id = ? LIMIT 1"));
+    QSqlQuery &planQuery = connection.prepare(QStringLiteral("SELECT id, duration_days FROM subscription_plans WHERE id = ? LIMIT 1"));
     planQuery.addBindValue(planId);
-    if (!planQuery.exec() || !planQuery.next())
+    if (!DatabaseUtils::exec(planQuery) || !planQuery.next())
     {
         result.insert(QStringLiteral("message"), QStringLiteral("Plan not found"));
         return result;
     }
     const int durationDays = planQuery.value(1).toInt();
+    planQuery.finish();
 
-    // deactivate previous
-    QSqlQuery deactivate(db);
-    deactivate.prepare(QStringLiteral("UPDATE user_subscriptions SET is_active = 0 WHERE user_id = ?"));
+    // The old plan stays active unless the new one lands.
+    if (!db.transaction())
+    {
+        result.insert(QStringLiteral("message"), QStringLiteral("Database unavailable"));
+        return result;
+    }
+
+    QSqlQuery &deactivate = connection.prepare(QStringLiteral("UPDATE user_subscriptions SET is_active = 0 WHERE user_id = ?"));
     deactivate.addBindValue(userId);
-    deactivate.exec();
 
     const QDate startDate = QDate::currentDate();
     const QDate endDate = startDate.addDays(durationDays > 0 ? durationDays : 30);
 
-    QSqlQuery insert(db);
-    insert.prepare(QStringLiteral(
+    QSqlQuery &insert = connection.prepare(QStringLiteral(
         "INSERT INTO user_subscriptions (user_id, plan_id, start_date, end_date, is_active) "
         "VALUES (?, ?, ?, ?, 1)"));
     insert.addBindValue(userId);
     insert.addBindValue(planId);
     insert.addBindValue(startDate.toString(Qt::ISODate));
     insert.addBindValue(endDate.toString(Qt::ISODate));
-    if (!insert.exec())
+    if (!DatabaseUtils::exec(deactivate) || !DatabaseUtils::exec(insert) || !db.commit())
     {
+        db.rollback();
         result.insert(QStringLiteral("message"), QStringLiteral("Failed to subscribe"));
         return result;
     }
+    // After the commit, so a canPlay that read the old rows cannot store them; see
+    // EntitlementCache::generation.
+    m_entitlements.invalidate(userId);
 
     result.insert(QStringLiteral("success"), true);
     result.insert(QStringLiteral("message"), QStringLiteral("Subscription activated"));
     return result;
 }
 
-void Backend::logPlayback(const QString &identifier, const QString &title, int positionSec, bool finished) const
+bool Backend::canPlay(const QString &token)
 {
-    auto db = DatabaseUtils::openDatabase(QStringLiteral("finalproject-playback"));
+    BACKEND_METHOD("canPlay");
+    const auto call = m_recorder.begin("canPlay", token);
+    const auto current = session(token);
+    if (!current)
+    {
+        return false;
+    }
+
+    const QDateTime now = QDateTime::currentDateTime();
+    if (const auto cached = m_entitlements.find(current->userId, now))
+    {
+        return cached->allowsPlaybackOn(now.date());
+    }
+    // Taken before the read, so a subscribePlan that commits meanwhile voids what is read.
+    const quint64 generation = m_entitlements.generation(current->userId);
+
+    auto connection = ConnectionPool::instance().acquire();
+    QSqlDatabase db = connection.database();
     if (!db.isOpen())
     {
-        return;
+        return false;
     }
 
-    const QString email = identifier.trimmed();
-    const QString titleName = title.trimmed();
-    if (email.isEmpty() || titleName.isEmpty())
+    QSqlQuery &query = connection.prepare(QStringLiteral(
+        "SELECT u.role, us.end_date "
+        "FROM users u "
+        "LEFT JOIN user_subscriptions us ON us.user_id = u.id AND us.is_active = 1 "
+        "WHERE u.id = ? "
+        "ORDER BY us.created_at DESC LIMIT 1"));
+    query.addBindValue(current->userId);
+    if (!DatabaseUtils::exec(query) || !query.next())
     {
-        return;
+        return false;
     }
 
-    QSqlQuery userQuery(db);
-    userQuery.prepare(QStringLiteral("SELECT id FROM users WHERE email = ? LIMIT 1"));
-    userQuery.addBindValue(email);
-    if (!userQuery.exec() || !userQuery.next())
+    Entitlement entitlement;
+    entitlement.unrestricted = query.value(0).toString() == QStringLiteral("admin");
+    entitlement.subscribed = !query.value(1).isNull();
+    entitlement.endDate = QDate::fromString(query.value(1).toString(), Qt::ISODate);
+    m_entitlements.store(current->userId, entitlement, now, generation);
+    return entitlement.allowsPlaybackOn(now.date());
+}
+
+void Backend::logPlayback(const QString &token, int titleId, int positionSec, bool finished)
+{
+    BACKEND_METHOD("logPlayback");
+    const auto call = m_recorder.begin("logPlayback", token, titleId, positionSec, finished);
+    const auto current = session(token);
+    if (!current || titleId <= 0)
     {
         return;
     }
-    const int userId = userQuery.value(0).toInt();
 
-    int profileId = -1;
-    QSqlQuery profileQuery(db);
-    profileQuery.prepare(QStringLiteral("SELECT id FROM profiles WHERE user_id = ? ORDER BY created_at LIMIT 1"));
-    profileQuery.addBindValue(userId);
-    if (profileQuery.exec() && profileQuery.next())
+    m_playbackLogger.enqueue(PlaybackEvent{current->profileId, titleId, positionSec, finished});
+}
+
+void Backend::setPlaybackFlushInterval(std::chrono::milliseconds interval)
+{
+    m_playbackLogger.setFlushInterval(interval);
+}
+
+void Backend::setPasswordCost(const PasswordHash::Cost &cost)
+{
+    m_authService.setPasswordCost(cost);
+}
+
+void Backend::setLoginLimits(const LoginRateLimits &limits)
+{
+    m_authService.setLoginLimits(limits);
+}
+
+void Backend::setTracingEnabled(bool enabled)
+{
+    Trace::setEnabled(enabled);
+}
+
+QVariantMap Backend::writeTrace(const QString &path) const
+{
+    QVariantMap result;
+    const bool written = Trace::writeChromeJson(QFile::encodeName(path).toStdString());
+    result.insert(QStringLiteral("success"), written);
+    result.insert(QStringLiteral("message"), written ? QStringLiteral("Trace written to %1").arg(path)
+                                                     : QStringLiteral("Unable to write trace to %1").arg(path));
+    return result;
+}
+
+void Backend::updateMetrics() const
+{
+    const auto snapshot = m_service.snapshot();
+    Metrics::gauge("finalproject_catalog_titles", "Titles in the published catalog")
+        .set(static_cast<std::int64_t>(snapshot->items.size()));
+    Metrics::gauge("finalproject_catalog_categories", "Category rows in the published catalog")
+        .set(static_cast<std::int64_t>(snapshot->categories.size()));
+
+    const ConnectionPoolStats pool = ConnectionPool::instance().stats();
+    Metrics::gauge("finalproject_db_connections", "Open SQLite connections", {{"state", "open"}}).set(pool.openConnections);
+    Metrics::gauge("finalproject_db_connections", "Open SQLite connections", {{"state", "leased"}}).set(pool.leasedConnections);
+    Metrics::gauge("finalproject_db_connections_max", "Connection pool limit").set(pool.maxConnections);
+}
+
+bool Backend::startCallRecording(const QString &path)
+{
+    return m_recorder.open(path);
+}
+
+void Backend::stopCallRecording()
+{
+    m_recorder.close();
+}
+
+int Backend::authenticateAsync(const QString &mode,
+                               const QString &role,
+                               const QString &identifier,
+                               const QString &password,
+                               const QString &confirmPassword,
+                               const QJSValue &callback,
+                               const QString &tag)
+{
+    BACKEND_METHOD("authenticateAsync");
+    auto call = m_recorder.begin("authenticateAsync", mode, role, identifier, tag);
+    return trackRequest(std::move(call),
+                        startRequest(m_authPool, tag, callback, [this, mode, role, identifier, password, confirmPassword]() {
+                            return QVariant(authenticate(mode, role, identifier, password, confirmPassword));
+                        }));
+}
+
+int Backend::listUsersAsync(const QJSValue &callback, const QString &tag)
+{
+    BACKEND_METHOD("listUsersAsync");
+    auto call = m_recorder.begin("listUsersAsync", tag);
+    return trackRequest(std::move(call), startRequest(tag, callback, [this]() { return QVariant(listUsers()); }));
+}
+
+int Backend::listGenresAsync(const QJSValue &callback, const QString &tag)
+{
+    BACKEND_METHOD("listGenresAsync");
+    auto call = m_recorder.begin("listGenresAsync", tag);
+    return trackRequest(std::move(call), startRequest(tag, callback, [this]() { return QVariant(listGenres()); }));
+}
+
+int Backend::addGenreAsync(const QString &name, const QJSValue &callback, const QString &tag)
+{
+    BACKEND_METHOD("addGenreAsync");
+    auto call = m_recorder.begin("addGenreAsync", name, tag);
+    return trackRequest(std::move(call),
+                        startRequest(tag, callback, [this, name]() { return QVariant(addGenre(name)); }));
+}
+
+int Backend::addMovieAsync(const QString &name,
+                           const QString &description,
+                           const QString &genre,
+                           int runtimeMinutes,
+                           const QString &thumbnailPath,
+                           const QString &videoPath,
+                           const QJSValue &callback,
+                           const QString &tag)
+{
+    // Completes once the title is visible, not when the upload starts.
+    BACKEND_METHOD("addMovieAsync");
+    auto call = m_recorder.begin("addMovieAsync", name, description, genre, runtimeMinutes, thumbnailPath, videoPath, tag);
+    const int requestId = trackRequest(std::move(call), registerRequest(tag, callback));
+    const QVariantMap started = startMovieIngestion(name, description, genre, runtimeMinutes, thumbnailPath, videoPath,
+                                                    [this, requestId](const QVariantMap &landed) {
+                                                        completeRequest(requestId, landed);
+                                                    });
+    if (!started.value(QStringLiteral("success")).toBool())
     {
-        profileId = profileQuery.value(0).toInt();
+        QMetaObject::invokeMethod(
+            this, [this, requestId, started]() { completeRequest(requestId, started); }, Qt::QueuedConnection);
     }
-    else
+    return requestId;
+}
+
+int Backend::userProfileAsync(const QString &token, const QJSValue &callback, const QString &tag)
+{
+    BACKEND_METHOD("userProfileAsync");
+    auto call = m_recorder.begin("userProfileAsync", token, tag);
+    return trackRequest(std::move(call),
+                        startRequest(tag, callback, [this, token]() { return QVariant(userProfile(token)); }));
+}
+
+int Backend::addToMyListAsync(const QString &token, int titleId, const QJSValue &callback, const QString &tag)
+{
+    BACKEND_METHOD("addToMyListAsync");
+    auto call = m_recorder.begin("addToMyListAsync", token, titleId, tag);
+    return trackRequest(std::move(call),
+                        startRequest(tag, callback, [this, token, titleId]() { return QVariant(addToMyList(token, titleId)); }));
+}
+
+int Backend::listPlansAsync(const QJSValue &callback, const QString &tag)
+{
+    BACKEND_METHOD("listPlansAsync");
+    auto call = m_recorder.begin("listPlansAsync", tag);
+    return trackRequest(std::move(call), startRequest(tag, callback, [this]() { return QVariant(listPlans()); }));
+}
+
+int Backend::subscribePlanAsync(const QString &token, int planId, const QJSValue &callback, const QString &tag)
+{
+    BACKEND_METHOD("subscribePlanAsync");
+    auto call = m_recorder.begin("subscribePlanAsync", token, planId, tag);
+    return trackRequest(std::move(call),
+                        startRequest(tag, callback, [this, token, planId]() { return QVariant(subscribePlan(token, planId)); }));
+}
+
+int Backend::collectMediaGarbageAsync(const QJSValue &callback, const QString &tag)
+{
+    BACKEND_METHOD("collectMediaGarbageAsync");
+    auto call = m_recorder.begin("collectMediaGarbageAsync", tag);
+    return trackRequest(std::move(call),
+                        startRequest(tag, callback, [this]() { return QVariant(collectMediaGarbage()); }));
+}
+
+int Backend::canPlayAsync(const QString &token, const QJSValue &callback, const QString &tag)
+{
+    BACKEND_METHOD("canPlayAsync");
+    auto call = m_recorder.begin("canPlayAsync", token, tag);
+    return trackRequest(std::move(call),
+                        startRequest(tag, callback, [this, token]() { return QVariant(canPlay(token)); }));
+}
+
+void Backend::cancelRequest(int requestId)
+{
+    BACKEND_METHOD("cancelRequest");
+    const auto call = m_recorder.begin("cancelRequest", requestId);
+    const auto it = m_pendingRequests.find(requestId);
+    if (it != m_pendingRequests.end())
     {
-        QSqlQuery createProfile(db);
-        createProfile.prepare(QStringLiteral("INSERT INTO profiles (user_id, name, avatar_url, is_kid) VALUES (?, ?, '', 0)"));
-        createProfile.addBindValue(userId);
-        createProfile.addBindValue(QStringLiteral("Profile 1"));
-        if (!createProfile.exec())
+        *it->cancelled = true;
+        m_pendingRequests.erase(it);
+    }
+}
+
+void Backend::cancelRequests(const QString &tag)
+{
+    BACKEND_METHOD("cancelRequests");
+    const auto call = m_recorder.begin("cancelRequests", tag);
+    for (auto it = m_pendingRequests.begin(); it != m_pendingRequests.end();)
+    {
+        if (it->tag == tag)
+        {
+            *it->cancelled = true;
+            it = m_pendingRequests.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+int Backend::startRequest(const QString &tag,
+                          const QJSValue &callback,
+                          std::function<QVariant()> work,
+                          std::function<void()> whenDone)
+{
+    return startRequest(m_requestPool, tag, callback, std::move(work), std::move(whenDone));
+}
+
+int Backend::startRequest(QThreadPool &pool,
+                          const QString &tag,
+                          const QJSValue &callback,
+                          std::function<QVariant()> work,
+                          std::function<void()> whenDone)
+{
+    const int requestId = registerRequest(tag, callback);
+    const auto cancelled = m_pendingRequests.value(requestId).cancelled;
+
+    pool.start([this, requestId, cancelled, work = std::move(work), whenDone = std::move(whenDone)]() {
+        // Work that already started still finishes; whenDone keeps the UI in step with
+        // whatever it wrote, even if nobody is waiting for the answer any more.
+        if (cancelled->load())
         {
             return;
         }
-        profileId = createProfile.lastInsertId().toInt();
+        CallRecorder::Suppress suppress;
+        const QVariant result = work();
+        QMetaObject::invokeMethod(
+            this,
+            [this, requestId, result, whenDone]() {
+                if (whenDone)
+                {
+                    whenDone();
+                }
+                completeRequest(requestId, result);
+            },
+            Qt::QueuedConnection);
+    });
+    return requestId;
+}
+
+int Backend::registerRequest(const QString &tag, const QJSValue &callback)
+{
+    const int requestId = ++m_lastRequestId;
+    m_pendingRequests.insert(requestId, PendingRequest{tag, callback, std::make_shared<std::atomic<bool>>(false)});
+    return requestId;
+}
+
+int Backend::trackRequest(CallRecorder::Scope call, int requestId)
+{
+    call.setRequestId(requestId);
+    const auto it = m_pendingRequests.find(requestId);
+    if (call && it != m_pendingRequests.end())
+    {
+        it->call = std::make_shared<CallRecorder::Scope>(std::move(call));
     }
+    return requestId;
+}
 
-    QSqlQuery titleQuery(db);
-    titleQuery.prepare(QStringLiteral("SELECT id FROM titles WHERE lower(name) = lower(?) ORDER BY created_at DESC LIMIT 1"));
-    titleQuery.addBindValue(titleName);
-    if (!titleQuery.exec() || !titleQuery.next())
+void Backend::completeRequest(int requestId, const QVariant &result)
+{
+    const auto it = m_pendingRequests.find(requestId);
+    if (it == m_pendingRequests.end())
     {
         return;
     }
-    const int titleId = titleQuery.value(0).toInt();
+    PendingRequest request = *it;
+    m_pendingRequests.erase(it);
+    if (request.call)
+    {
+        request.call->setResult(result);
+        request.call.reset();
+    }
 
-    QSqlQuery insert(db);
-    insert.prepare(QStringLiteral(
-        "INSERT INTO watch_history (profile_id, title_id, position_sec, is_finished, updated_at) "
-        "VALUES (?, ?, ?, ?, datetime('now'))"));
-    insert.addBindValue(profileId);
-    insert.addBindValue(titleId);
-    insert.addBindValue(positionSec);
-    insert.addBindValue(finished ? 1 : 0);
-    insert.exec();
+    emit requestFinished(requestId, request.tag, result);
+    if (!request.callback.isCallable())
+    {
+        return;
+    }
+
+    QJSEngine *engine = qjsEngine(this);
+    if (!engine)
+    {
+        qWarning() << "No JavaScript engine to deliver request" << requestId;
+        return;
+    }
+
+    QJSValue callback = request.callback;
+    const QJSValue outcome = callback.call({engine->toScriptValue(result)});
+    if (outcome.isError())
+    {
+        qWarning() << "Request callback failed:" << outcome.toString();
+    }
 }
 
 std::unique_ptr<IDataProvider> Backend::createSqlProvider()
@@ -954,27 +1587,55 @@ std::unique_ptr<IDataProvider> Backend::createSqlProvider()
 
 QVariantMap Backend::toVariant(const MediaItem &item) const
 {
-    return makeVariantItem(item);
+    return toVariantMap(item, textOf(item.genre));
 }
 
-QVariantList Backend::toVariant(const std::vector<MediaCategory> &categories) const
+QVariantMap Backend::databaseStats() const
 {
-    QVariantList list;
-    list.reserve(static_cast<int>(categories.size()));
-    for (const auto &category : categories)
-    {
-        QVariantMap map;
-        map.insert(QStringLiteral("name"), QString::fromStdString(category.name));
-
-        QVariantList items;
-        items.reserve(static_cast<int>(category.items.size()));
-        for (const auto &item : category.items)
-        {
-            items.append(makeVariantItem(item));
-        }
+    BACKEND_METHOD("databaseStats");
+    const auto call = m_recorder.begin("databaseStats");
+    const ConnectionPoolStats stats = ConnectionPool::instance().stats();
+    QVariantMap result;
+    result.insert(QStringLiteral("acquisitions"), stats.acquisitions);
+    result.insert(QStringLiteral("contendedAcquisitions"), stats.contendedAcquisitions);
+    result.insert(QStringLiteral("totalWaitMs"), static_cast<double>(stats.totalWaitNs) / 1e6);
+    result.insert(QStringLiteral("maxWaitMs"), static_cast<double>(stats.maxWaitNs) / 1e6);
+    result.insert(QStringLiteral("openConnections"), stats.openConnections);
+    result.insert(QStringLiteral("leasedConnections"), stats.leasedConnections);
+    result.insert(QStringLiteral("maxConnections"), stats.maxConnections);
+    result.insert(QStringLiteral("statementHits"), stats.statementHits);
+    result.insert(QStringLiteral("statementMisses"), stats.statementMisses);
+
+    const PlaybackLoggerStats playback = m_playbackLogger.stats();
+    result.insert(QStringLiteral("playbackEventsQueued"), playback.eventsQueued);
+    result.insert(QStringLiteral("playbackRowsWritten"), playback.rowsWritten);
+    result.insert(QStringLiteral("playbackBatches"), playback.batches);
+    result.insert(QStringLiteral("playbackFailedBatches"), playback.failedBatches);
+
+    const LoginRateLimiterStats logins = m_authService.loginStats();
+    result.insert(QStringLiteral("loginAttemptsAccepted"), static_cast<quint64>(logins.accepted));
+    result.insert(QStringLiteral("loginAttemptsRejected"), static_cast<quint64>(logins.rejected));
+    return result;
+}
 
-        map.insert(QStringLiteral("items"), items);
-        list.append(map);
+QVariantMap Backend::collectMediaGarbage() const
+{
+    BACKEND_METHOD("collectMediaGarbage");
+    const auto call = m_recorder.begin("collectMediaGarbage");
+    QVariantMap result;
+    auto connection = ConnectionPool::instance().acquire();
+    QSqlDatabase db = connection.database();
+    if (!db.isOpen())
+    {
+        result.insert(QStringLiteral("success"), false);
+        result.insert(QStringLiteral("message"), QStringLiteral("Database unavailable"));
+        return result;
     }
-    return list;
+
+    const GarbageReport report = MediaStore::collectGarbage(db, {DatabaseUtils::videosDirectory(), DatabaseUtils::imagesDirectory()});
+    result.insert(QStringLiteral("success"), true);
+    result.insert(QStringLiteral("removedBlobs"), report.removedBlobs);
+    result.insert(QStringLiteral("removedFiles"), report.removedFiles);
+    result.insert(QStringLiteral("removedBytes"), report.removedBytes);
+    return result;
 }
@@ -2,28 +2,57 @@
 
 #include "../core/AuthService.h"
 #include "../core/AuthRepository.h"
+#include "../core/SearchIndex.h"
 #include "../core/StreamingService.h"
+#include "CallRecorder.h"
+#include "CatalogModels.h"
+#include "EntitlementCache.h"
+#include "MediaIngestor.h"
+#include "PlaybackLogger.h"
 
+#include <QHash>
+#include <QJSValue>
 #include <QObject>
+#include <QThreadPool>
 #include <QVariant>
 
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <optional>
+
 class Backend : public QObject
 {
     Q_OBJECT
-    Q_PROPERTY(QVariantMap heroItem READ heroItem NOTIFY dataChanged)
-    Q_PROPERTY(QVariantList categories READ categories NOTIFY dataChanged)
+    Q_PROPERTY(QVariantMap heroItem READ heroItem NOTIFY heroItemChanged)
+    Q_PROPERTY(QAbstractItemModel *catalog READ catalog CONSTANT)
+    Q_PROPERTY(QAbstractItemModel *movieCatalog READ movieCatalog CONSTANT)
+    Q_PROPERTY(QAbstractItemModel *seriesCatalog READ seriesCatalog CONSTANT)
 
 public:
     explicit Backend(std::unique_ptr<IDataProvider> provider, QObject *parent = nullptr);
+    ~Backend() override;
 
+    // Publishes the catalog saved by the previous run, if it is intact, so the first frame
+    // does not wait for the database. Call before the first reload(), which then only
+    // rebuilds when the database's catalog version has moved on.
+    bool loadCachedCatalog();
     Q_INVOKABLE void reload();
     Q_INVOKABLE QVariantMap heroItem() const;
-    Q_INVOKABLE QVariantList categories() const;
+    // Titles matching query, best first. Empty until the index for the current catalog is built.
+    Q_INVOKABLE QVariantList search(const QString &query, int limit = 20) const;
+    QAbstractItemModel *catalog();
+    QAbstractItemModel *movieCatalog();
+    QAbstractItemModel *seriesCatalog();
+    // On success the result carries the session token the per-user calls below take. Checking
+    // the password hash takes tens of milliseconds, so QML should use authenticateAsync.
     Q_INVOKABLE QVariantMap authenticate(const QString &mode,
                                          const QString &role,
                                          const QString &identifier,
                                          const QString &password,
                                          const QString &confirmPassword);
+    Q_INVOKABLE void endSession(const QString &token);
     Q_INVOKABLE QVariantList listUsers() const;
     Q_INVOKABLE QVariantList listGenres() const;
     Q_INVOKABLE QVariantMap addGenre(const QString &name);
@@ -33,22 +62,154 @@ public:
                                      int runtimeMinutes,
                                      const QString &thumbnailPath,
                                      const QString &videoPath);
-    Q_INVOKABLE QVariantMap userProfile(const QString &identifier) const;
-    Q_INVOKABLE QVariantMap addToMyList(const QString &identifier, const QString &title) const;
+    Q_INVOKABLE void cancelIngestion(int jobId);
+    Q_INVOKABLE QVariantMap userProfile(const QString &token) const;
+    Q_INVOKABLE QVariantMap addToMyList(const QString &token, int titleId) const;
     Q_INVOKABLE QVariantList listPlans() const;
-    Q_INVOKABLE QVariantMap subscribePlan(const QString &identifier, int planId) const;
-    Q_INVOKABLE void logPlayback(const QString &identifier, const QString &title, int positionSec, bool finished) const;
+    Q_INVOKABLE QVariantMap subscribePlan(const QString &token, int planId);
+    Q_INVOKABLE bool canPlay(const QString &token);
+    Q_INVOKABLE void logPlayback(const QString &token, int titleId, int positionSec, bool finished);
+    Q_INVOKABLE QVariantMap databaseStats() const;
+    // Removes stored media that no title references any more.
+    Q_INVOKABLE QVariantMap collectMediaGarbage() const;
+    // Span tracing; writeTrace saves what has been collected as Chrome trace JSON, which
+    // chrome://tracing and ui.perfetto.dev open.
+    Q_INVOKABLE void setTracingEnabled(bool enabled);
+    Q_INVOKABLE QVariantMap writeTrace(const QString &path) const;
+
+    // Asynchronous variants run on a worker pool and return a request id. The result is
+    // passed to callback (if given) and announced through requestFinished on the GUI
+    // thread. Requests carry a tag so a page can cancel everything it started when it goes
+    // away; a cancelled request never reports back.
+    Q_INVOKABLE int authenticateAsync(const QString &mode,
+                                      const QString &role,
+                                      const QString &identifier,
+                                      const QString &password,
+                                      const QString &confirmPassword,
+                                      const QJSValue &callback = QJSValue(),
+                                      const QString &tag = QString());
+    Q_INVOKABLE int listUsersAsync(const QJSValue &callback = QJSValue(), const QString &tag = QString());
+    Q_INVOKABLE int listGenresAsync(const QJSValue &callback = QJSValue(), const QString &tag = QString());
+    Q_INVOKABLE int addGenreAsync(const QString &name, const QJSValue &callback = QJSValue(), const QString &tag = QString());
+    Q_INVOKABLE int addMovieAsync(const QString &name,
+                                  const QString &description,
+                                  const QString &genre,
+                                  int runtimeMinutes,
+                                  const QString &thumbnailPath,
+                                  const QString &videoPath,
+                                  const QJSValue &callback = QJSValue(),
+                                  const QString &tag = QString());
+    Q_INVOKABLE int userProfileAsync(const QString &token, const QJSValue &callback = QJSValue(), const QString &tag = QString());
+    Q_INVOKABLE int addToMyListAsync(const QString &token,
+                                     int titleId,
+                                     const QJSValue &callback = QJSValue(),
+                                     const QString &tag = QString());
+    Q_INVOKABLE int listPlansAsync(const QJSValue &callback = QJSValue(), const QString &tag = QString());
+    Q_INVOKABLE int subscribePlanAsync(const QString &token,
+                                       int planId,
+                                       const QJSValue &callback = QJSValue(),
+                                       const QString &tag = QString());
+    Q_INVOKABLE int canPlayAsync(const QString &token, const QJSValue &callback = QJSValue(), const QString &tag = QString());
+    Q_INVOKABLE int collectMediaGarbageAsync(const QJSValue &callback = QJSValue(), const QString &tag = QString());
+    Q_INVOKABLE void cancelRequest(int requestId);
+    Q_INVOKABLE void cancelRequests(const QString &tag);
+
+    void setPlaybackFlushInterval(std::chrono::milliseconds interval);
+    void setPasswordCost(const PasswordHash::Cost &cost);
+    void setLoginLimits(const LoginRateLimits &limits);
+
+    // Records every invokable call to path until stopped, for replay with CallReplay.
+    // Passwords are left out of the trace.
+    bool startCallRecording(const QString &path);
+    void stopCallRecording();
+
+    // Samples catalog and connection pool figures into their metrics gauges; call before
+    // rendering the metrics registry.
+    void updateMetrics() const;
 
     static std::unique_ptr<IDataProvider> createSqlProvider();
 
 signals:
     void dataChanged();
+    void heroItemChanged();
+    void categoryInserted(int row);
+    void categoryItemsInserted(int row, int first, int count);
+    void ingestionProgress(int jobId, const QString &title, qint64 copiedBytes, qint64 totalBytes);
+    void ingestionFinished(int jobId, const QString &title, const QVariantMap &result);
+    void requestFinished(int requestId, const QString &tag, const QVariant &result);
 
 private:
+    struct PendingRequest
+    {
+        QString tag;
+        QJSValue callback;
+        std::shared_ptr<std::atomic<bool>> cancelled;
+        // Held until the result is delivered, when recording.
+        std::shared_ptr<CallRecorder::Scope> call;
+    };
+
+    // Declared first so it outlives the calls still being timed.
+    mutable CallRecorder m_recorder;
+
     StreamingService m_service;
+    CategoryListModel m_catalogModel;
+    CategoryFilterModel m_movieCatalogModel;
+    CategoryFilterModel m_seriesCatalogModel;
+    QThreadPool m_reloadPool;
+    std::atomic<quint64> m_reloadGeneration{0};
+    bool m_reloadRunning = false;
+    bool m_reloadQueued = false;
+    // Catalog version the published snapshot was built from, when the provider has one.
+    std::optional<std::uint64_t> m_catalogVersion;
+    // Built on the reload pool for each published snapshot; only touched on the GUI thread.
+    std::shared_ptr<const SearchIndex> m_searchIndex;
+    QThreadPool m_requestPool;
+    // Password hashing only; small because every hash holds its scrypt buffer while it runs.
+    QThreadPool m_authPool;
+    QHash<int, PendingRequest> m_pendingRequests;
+    int m_lastRequestId = 0;
     std::unique_ptr<IAuthRepository> m_authRepository;
     AuthService m_authService;
+    EntitlementCache m_entitlements;
+    PlaybackLogger m_playbackLogger;
+    MediaIngestor m_ingestor;
+
+    std::optional<Session> session(const QString &token) const;
+    void requestReload();
+    void startReload();
+    void finishReload(quint64 generation, StreamingService::Snapshot snapshot, std::optional<std::uint64_t> version);
+    void applyDelta(const CatalogDelta &delta);
+    void rebuildSearchIndex();
+
+    QVariantMap startMovieIngestion(const QString &name,
+                                    const QString &description,
+                                    const QString &genre,
+                                    int runtimeMinutes,
+                                    const QString &thumbnailPath,
+                                    const QString &videoPath,
+                                    std::function<void(const QVariantMap &)> whenLanded);
+    QVariantMap insertMovie(const QString &name,
+                            const QString &description,
+                            const QString &genre,
+                            int runtimeMinutes,
+                            const StoredBlob &thumbnail,
+                            const StoredBlob &video,
+                            std::optional<TitleWithGenres> &inserted) const;
+
+    // Runs work on the request pool, then whenDone (if any) and the completion on the GUI thread.
+    int startRequest(const QString &tag,
+                     const QJSValue &callback,
+                     std::function<QVariant()> work,
+                     std::function<void()> whenDone = {});
+    int startRequest(QThreadPool &pool,
+                     const QString &tag,
+                     const QJSValue &callback,
+                     std::function<QVariant()> work,
+                     std::function<void()> whenDone = {});
+    int registerRequest(const QString &tag, const QJSValue &callback);
+    // Attaches a recorded async call to its request so it is timed until completion.
+    int trackRequest(CallRecorder::Scope call, int requestId);
+    void completeRequest(int requestId, const QVariant &result);
 
     QVariantMap toVariant(const MediaItem &item) const;
-    QVariantList toVariant(const std::vector<MediaCategory> &categories) const;
 };
@@ -0,0 +1,221 @@
+#include "CallRecorder.h"
+
+#include <QDebug>
+
+#include <utility>
+
+namespace
+{
+const quint32 kTraceMagic = 0x46504354; // "FPCT"
+const quint16 kTraceVersion = 1;
+const QDataStream::Version kStreamVersion = QDataStream::Qt_6_0;
+
+// Record kinds; a method is defined before the first call that uses it.
+const quint8 kMethodRecord = 1;
+const quint8 kCallRecord = 2;
+
+thread_local int t_suppressed = 0;
+} // namespace
+
+CallRecorder::Scope::Scope(CallRecorder *recorder, const char *method, QVariantList args)
+    : m_recorder(recorder)
+{
+    m_call.method = QByteArray(method);
+    m_call.args = std::move(args);
+    m_call.startNs = recorder->now();
+}
+
+CallRecorder::Scope::Scope(Scope &&other) noexcept
+    : m_recorder(std::exchange(other.m_recorder, nullptr))
+    , m_call(std::move(other.m_call))
+{
+}
+
+CallRecorder::Scope &CallRecorder::Scope::operator=(Scope &&other) noexcept
+{
+    if (this != &other)
+    {
+        finish();
+        m_recorder = std::exchange(other.m_recorder, nullptr);
+        m_call = std::move(other.m_call);
+    }
+    return *this;
+}
+
+CallRecorder::Scope::~Scope()
+{
+    finish();
+}
+
+void CallRecorder::Scope::setResult(const QVariant &result)
+{
+    if (m_recorder && result.typeId() == QMetaType::QVariantMap)
+    {
+        m_call.issuedToken = result.toMap().value(QStringLiteral("token")).toString();
+    }
+}
+
+void CallRecorder::Scope::setRequestId(int requestId)
+{
+    m_call.requestId = requestId;
+}
+
+void CallRecorder::Scope::finish()
+{
+    if (!m_recorder)
+    {
+        return;
+    }
+    m_call.durationNs = m_recorder->now() - m_call.startNs;
+    m_recorder->write(m_call);
+    m_recorder = nullptr;
+}
+
+CallRecorder::Suppress::Suppress()
+{
+    ++t_suppressed;
+}
+
+CallRecorder::Suppress::~Suppress()
+{
+    --t_suppressed;
+}
+
+CallRecorder::~CallRecorder()
+{
+    close();
+}
+
+bool CallRecorder::open(const QString &path)
+{
+    QMutexLocker lock(&m_mutex);
+    if (m_file.isOpen())
+    {
+        return false;
+    }
+
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        qWarning() << "Unable to record calls to" << path << ":" << m_file.errorString();
+        return false;
+    }
+
+    m_stream.setDevice(&m_file);
+    m_stream.setVersion(kStreamVersion);
+    m_stream << kTraceMagic << kTraceVersion;
+    m_methods.clear();
+    m_clock.start();
+    m_recording.store(true, std::memory_order_release);
+    return true;
+}
+
+void CallRecorder::close()
+{
+    QMutexLocker lock(&m_mutex);
+    m_recording.store(false, std::memory_order_release);
+    if (m_file.isOpen())
+    {
+        m_stream.setDevice(nullptr);
+        m_file.close();
+    }
+}
+
+bool CallRecorder::isRecording() const
+{
+    return m_recording.load(std::memory_order_acquire);
+}
+
+bool CallRecorder::suppressed()
+{
+    return t_suppressed > 0;
+}
+
+qint64 CallRecorder::now() const
+{
+    return m_clock.nsecsElapsed();
+}
+
+void CallRecorder::write(const RecordedCall &call)
+{
+    QMutexLocker lock(&m_mutex);
+    // Calls still running when recording stopped are dropped.
+    if (!m_file.isOpen())
+    {
+        return;
+    }
+
+    auto it = m_methods.find(call.method);
+    if (it == m_methods.end())
+    {
+        it = m_methods.insert(call.method, static_cast<quint16>(m_methods.size()));
+        m_stream << kMethodRecord << it.value() << call.method;
+    }
+    m_stream << kCallRecord << it.value() << call.startNs << call.durationNs << call.args << call.issuedToken
+             << static_cast<qint32>(call.requestId);
+}
+
+bool CallRecorder::read(const QString &path, std::vector<RecordedCall> &calls, QString *error)
+{
+    const auto fail = [error](const QString &message) {
+        if (error)
+        {
+            *error = message;
+        }
+        return false;
+    };
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        return fail(file.errorString());
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(kStreamVersion);
+    quint32 magic = 0;
+    quint16 version = 0;
+    stream >> magic >> version;
+    if (magic != kTraceMagic || version != kTraceVersion)
+    {
+        return fail(QStringLiteral("Not a call trace, or written by an incompatible version"));
+    }
+
+    QHash<quint16, QByteArray> methods;
+    while (!stream.atEnd())
+    {
+        quint8 kind = 0;
+        quint16 methodId = 0;
+        stream >> kind >> methodId;
+        if (kind == kMethodRecord)
+        {
+            QByteArray name;
+            stream >> name;
+            methods.insert(methodId, name);
+        }
+        else if (kind == kCallRecord && methods.contains(methodId))
+        {
+            RecordedCall call;
+            qint32 requestId = 0;
+            call.method = methods.value(methodId);
+            stream >> call.startNs >> call.durationNs >> call.args >> call.issuedToken >> requestId;
+            call.requestId = requestId;
+            calls.push_back(std::move(call));
+        }
+        else
+        {
+            return fail(QStringLiteral("Corrupt record at offset %1").arg(file.pos()));
+        }
+
+        // A trace cut short by a crash keeps every complete record before the damage.
+        if (stream.status() != QDataStream::Ok)
+        {
+            if (kind == kCallRecord && !calls.empty())
+            {
+                calls.pop_back();
+            }
+            break;
+        }
+    }
+    return true;
+}
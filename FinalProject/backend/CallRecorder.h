@@ -0,0 +1,108 @@
+#pragma once
+
+#include <QByteArray>
+#include <QDataStream>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <QVariant>
+
+#include <atomic>
+#include <vector>
+
+struct RecordedCall
+{
+    QByteArray method;
+    QVariantList args;
+    // Both relative to the start of the recording.
+    qint64 startNs = 0;
+    qint64 durationNs = 0;
+    // Session token the call handed out, so a replay can map later calls onto its own sessions.
+    QString issuedToken;
+    // Id an async call returned, for matching cancelRequest calls.
+    int requestId = 0;
+};
+
+// Opt-in log of the calls QML makes into Backend, for replaying a session's load later. The
+// trace is a QDataStream file: a header, then one record per finished call, with each method
+// name written once and referred to by number after that. Async calls are recorded when they
+// complete, so records are ordered by end time. Recording stays off unless open() succeeds,
+// and a call costs one atomic load while it is off.
+class CallRecorder
+{
+public:
+    // Times one call from begin() until it goes away, then writes it.
+    class Scope
+    {
+    public:
+        Scope() = default;
+        Scope(Scope &&other) noexcept;
+        Scope &operator=(Scope &&other) noexcept;
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+        ~Scope();
+
+        explicit operator bool() const { return m_recorder != nullptr; }
+
+        // Picks the session token out of an authenticate result.
+        void setResult(const QVariant &result);
+        void setRequestId(int requestId);
+
+    private:
+        friend class CallRecorder;
+        Scope(CallRecorder *recorder, const char *method, QVariantList args);
+
+        void finish();
+
+        CallRecorder *m_recorder = nullptr;
+        RecordedCall m_call;
+    };
+
+    // Suppresses recording on the current thread while alive, so work an async request runs
+    // through the synchronous methods is not recorded a second time.
+    class Suppress
+    {
+    public:
+        Suppress();
+        ~Suppress();
+        Suppress(const Suppress &) = delete;
+        Suppress &operator=(const Suppress &) = delete;
+    };
+
+    CallRecorder() = default;
+    ~CallRecorder();
+
+    CallRecorder(const CallRecorder &) = delete;
+    CallRecorder &operator=(const CallRecorder &) = delete;
+
+    bool open(const QString &path);
+    void close();
+    bool isRecording() const;
+
+    template <typename... Args>
+    Scope begin(const char *method, const Args &...args)
+    {
+        if (!isRecording() || suppressed())
+        {
+            return Scope();
+        }
+        return Scope(this, method, QVariantList{QVariant::fromValue(args)...});
+    }
+
+    // Reads a whole trace; returns false with a message when the file is not one.
+    static bool read(const QString &path, std::vector<RecordedCall> &calls, QString *error = nullptr);
+
+private:
+    std::atomic<bool> m_recording{false};
+    QMutex m_mutex;
+    QFile m_file;
+    QDataStream m_stream;
+    QElapsedTimer m_clock;
+    QHash<QByteArray, quint16> m_methods;
+
+    static bool suppressed();
+    qint64 now() const;
+    void write(const RecordedCall &call);
+};
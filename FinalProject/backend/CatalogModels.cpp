@@ -0,0 +1,331 @@
+#include "CatalogModels.h"
+
+#include <QQmlEngine>
+
+#include <algorithm>
+#include <utility>
+
+QVariantMap toVariantMap(const MediaItem &item, const std::string &genre)
+{
+    QVariantMap map;
+    map.insert(QStringLiteral("titleId"), item.id);
+    map.insert(QStringLiteral("type"), QString::fromStdString(textOf(item.type)));
+    map.insert(QStringLiteral("title"), QString::fromStdString(item.title));
+    map.insert(QStringLiteral("genre"), QString::fromStdString(genre));
+    map.insert(QStringLiteral("duration"), QString::fromStdString(textOf(item.duration)));
+    map.insert(QStringLiteral("rating"), QString::fromStdString(textOf(item.rating)));
+    map.insert(QStringLiteral("description"), QString::fromStdString(item.description));
+    map.insert(QStringLiteral("accentColor"), QString::fromStdString(textOf(item.accentColor)));
+    map.insert(QStringLiteral("thumbnailUrl"), QString::fromStdString(item.thumbnailUrl.str()));
+    map.insert(QStringLiteral("videoUrl"), QString::fromStdString(item.videoUrl.str()));
+    return map;
+}
+
+MediaItemListModel::MediaItemListModel(StreamingService::Snapshot snapshot, std::uint32_t category, QObject *parent)
+    : QAbstractListModel(parent)
+    , m_snapshot(std::move(snapshot))
+    , m_category(category)
+{
+}
+
+int MediaItemListModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : static_cast<int>(row().items.size());
+}
+
+QVariant MediaItemListModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= rowCount())
+    {
+        return QVariant();
+    }
+
+    const MediaItem &item = m_snapshot->item(row().items[static_cast<std::size_t>(index.row())]);
+    switch (role)
+    {
+    case TitleIdRole:
+        return item.id;
+    case TypeRole:
+        return QString::fromStdString(textOf(item.type));
+    case Qt::DisplayRole:
+    case TitleRole:
+        return QString::fromStdString(item.title);
+    case GenreRole:
+        // Rows list titles under their own genre, whatever the title's primary genre is.
+        return QString::fromStdString(textOf(row().name));
+    case DurationRole:
+        return QString::fromStdString(textOf(item.duration));
+    case RatingRole:
+        return QString::fromStdString(textOf(item.rating));
+    case DescriptionRole:
+        return QString::fromStdString(item.description);
+    case AccentColorRole:
+        return QString::fromStdString(textOf(item.accentColor));
+    case ThumbnailUrlRole:
+        return QString::fromStdString(item.thumbnailUrl.str());
+    case VideoUrlRole:
+        return QString::fromStdString(item.videoUrl.str());
+    default:
+        return QVariant();
+    }
+}
+
+QHash<int, QByteArray> MediaItemListModel::roleNames() const
+{
+    return {
+        {TitleIdRole, "titleId"},
+        {TypeRole, "type"},
+        {TitleRole, "title"},
+        {GenreRole, "genre"},
+        {DurationRole, "duration"},
+        {RatingRole, "rating"},
+        {DescriptionRole, "description"},
+        {AccentColorRole, "accentColor"},
+        {ThumbnailUrlRole, "thumbnailUrl"},
+        {VideoUrlRole, "videoUrl"},
+    };
+}
+
+QVariantMap MediaItemListModel::get(int index) const
+{
+    if (index < 0 || index >= rowCount())
+    {
+        return QVariantMap();
+    }
+    return toVariantMap(m_snapshot->item(row().items[static_cast<std::size_t>(index)]), textOf(row().name));
+}
+
+void MediaItemListModel::rebind(StreamingService::Snapshot snapshot, std::uint32_t category)
+{
+    m_snapshot = std::move(snapshot);
+    m_category = category;
+}
+
+void MediaItemListModel::insertItems(StreamingService::Snapshot snapshot, std::uint32_t category, int first, int count)
+{
+    beginInsertRows(QModelIndex(), first, first + count - 1);
+    rebind(std::move(snapshot), category);
+    endInsertRows();
+}
+
+const MediaCategory &MediaItemListModel::row() const
+{
+    return m_snapshot->categories[m_category];
+}
+
+CategoryListModel::CategoryListModel(QObject *parent)
+    : QAbstractListModel(parent)
+    , m_snapshot(std::make_shared<const CatalogSnapshot>())
+{
+}
+
+int CategoryListModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_rows.size();
+}
+
+QVariant CategoryListModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= rowCount())
+    {
+        return QVariant();
+    }
+
+    const auto &category = m_snapshot->categories[static_cast<std::size_t>(index.row())];
+    switch (role)
+    {
+    case Qt::DisplayRole:
+    case NameRole:
+        return QString::fromStdString(textOf(category.name));
+    case ItemsRole:
+        return QVariant::fromValue(static_cast<QObject *>(itemsModel(index.row())));
+    case CountRole:
+        return static_cast<int>(category.items.size());
+    default:
+        return QVariant();
+    }
+}
+
+QHash<int, QByteArray> CategoryListModel::roleNames() const
+{
+    return {
+        {NameRole, "name"},
+        {ItemsRole, "items"},
+        {CountRole, "count"},
+    };
+}
+
+void CategoryListModel::setSnapshot(StreamingService::Snapshot snapshot)
+{
+    beginResetModel();
+    for (auto *rowModel : std::as_const(m_rows))
+    {
+        if (rowModel)
+        {
+            rowModel->deleteLater();
+        }
+    }
+    m_snapshot = std::move(snapshot);
+    m_rows = QVector<MediaItemListModel *>(static_cast<int>(m_snapshot->categories.size()), nullptr);
+    endResetModel();
+}
+
+void CategoryListModel::applyDelta(StreamingService::Snapshot snapshot, const CatalogDelta &delta)
+{
+    // New rows first, in ascending order, so every index is final by the time it is announced.
+    m_snapshot = snapshot;
+    for (const auto row : delta.insertedCategories)
+    {
+        beginInsertRows(QModelIndex(), static_cast<int>(row), static_cast<int>(row));
+        m_rows.insert(static_cast<int>(row), nullptr);
+        endInsertRows();
+    }
+
+    for (int row = 0; row < m_rows.size(); ++row)
+    {
+        const auto category = static_cast<std::uint32_t>(row);
+        const auto insert = std::find_if(delta.insertedItems.begin(), delta.insertedItems.end(),
+                                         [category](const CatalogDelta::RowInsert &candidate) {
+                                             return candidate.category == category;
+                                         });
+        if (insert == delta.insertedItems.end())
+        {
+            if (m_rows[row])
+            {
+                m_rows[row]->rebind(snapshot, category);
+            }
+            continue;
+        }
+
+        if (m_rows[row])
+        {
+            m_rows[row]->insertItems(snapshot, category, static_cast<int>(insert->first),
+                                     static_cast<int>(insert->count));
+        }
+        const QModelIndex changed = index(row);
+        emit dataChanged(changed, changed, {CountRole});
+    }
+}
+
+const CatalogSnapshot &CategoryListModel::snapshot() const
+{
+    return *m_snapshot;
+}
+
+MediaItemListModel *CategoryListModel::itemsModel(int row) const
+{
+    if (row < 0 || row >= m_rows.size())
+    {
+        return nullptr;
+    }
+
+    if (!m_rows[row])
+    {
+        auto *rowModel = new MediaItemListModel(m_snapshot, static_cast<std::uint32_t>(row),
+                                                const_cast<CategoryListModel *>(this));
+        QQmlEngine::setObjectOwnership(rowModel, QQmlEngine::CppOwnership);
+        m_rows[row] = rowModel;
+    }
+    return m_rows[row];
+}
+
+MediaTypeFilterModel::MediaTypeFilterModel(const QString &mediaType, QObject *parent)
+    : QSortFilterProxyModel(parent)
+    , m_mediaType(mediaType)
+{
+    setObjectName(mediaType);
+}
+
+QVariantMap MediaTypeFilterModel::get(int row) const
+{
+    auto *source = qobject_cast<MediaItemListModel *>(sourceModel());
+    if (!source)
+    {
+        return QVariantMap();
+    }
+    return source->get(mapToSource(index(row, 0)).row());
+}
+
+bool MediaTypeFilterModel::matches(const std::string &type, const QString &mediaType)
+{
+    if (mediaType.isEmpty())
+    {
+        return true;
+    }
+
+    // Untyped titles predate the type column and are shown as movies.
+    if (type.empty())
+    {
+        return mediaType == QLatin1String("movie");
+    }
+    return QString::fromStdString(type).compare(mediaType, Qt::CaseInsensitive) == 0;
+}
+
+bool MediaTypeFilterModel::filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const
+{
+    const QModelIndex source = sourceModel()->index(sourceRow, 0, sourceParent);
+    return matches(source.data(MediaItemListModel::TypeRole).toString().toStdString(), m_mediaType);
+}
+
+CategoryFilterModel::CategoryFilterModel(const QString &mediaType, QObject *parent)
+    : QSortFilterProxyModel(parent)
+    , m_mediaType(mediaType)
+{
+}
+
+QVariant CategoryFilterModel::data(const QModelIndex &index, int role) const
+{
+    if (role != CategoryListModel::ItemsRole && role != CategoryListModel::CountRole)
+    {
+        return QSortFilterProxyModel::data(index, role);
+    }
+
+    auto *categories = qobject_cast<CategoryListModel *>(sourceModel());
+    if (!categories || !index.isValid())
+    {
+        return QVariant();
+    }
+
+    // One filter per row model and type, parented to the row model so it goes away with it.
+    MediaItemListModel *rowModel = categories->itemsModel(mapToSource(index).row());
+    if (!rowModel)
+    {
+        return QVariant();
+    }
+
+    auto *filtered = rowModel->findChild<MediaTypeFilterModel *>(m_mediaType, Qt::FindDirectChildrenOnly);
+    if (!filtered)
+    {
+        filtered = new MediaTypeFilterModel(m_mediaType, rowModel);
+        filtered->setSourceModel(rowModel);
+        QQmlEngine::setObjectOwnership(filtered, QQmlEngine::CppOwnership);
+    }
+
+    if (role == CategoryListModel::CountRole)
+    {
+        return filtered->rowCount();
+    }
+    return QVariant::fromValue(static_cast<QObject *>(filtered));
+}
+
+bool CategoryFilterModel::filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const
+{
+    Q_UNUSED(sourceParent);
+
+    auto *categories = qobject_cast<CategoryListModel *>(sourceModel());
+    if (!categories)
+    {
+        return false;
+    }
+
+    const CatalogSnapshot &snapshot = categories->snapshot();
+    if (sourceRow < 0 || static_cast<std::size_t>(sourceRow) >= snapshot.categories.size())
+    {
+        return false;
+    }
+
+    const auto &items = snapshot.categories[static_cast<std::size_t>(sourceRow)].items;
+    return std::any_of(items.begin(), items.end(), [this, &snapshot](std::uint32_t item) {
+        return MediaTypeFilterModel::matches(textOf(snapshot.item(item).type), m_mediaType);
+    });
+}
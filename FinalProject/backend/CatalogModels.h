@@ -0,0 +1,117 @@
+#pragma once
+
+#include "../core/StreamingService.h"
+
+#include <QAbstractListModel>
+#include <QSortFilterProxyModel>
+#include <QVariant>
+#include <QVector>
+
+QVariantMap toVariantMap(const MediaItem &item, const std::string &genre);
+
+// Titles of one category row, read straight from the published snapshot. Strings are
+// converted for QML only when a delegate asks for them.
+class MediaItemListModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    enum Roles
+    {
+        TypeRole = Qt::UserRole + 1,
+        TitleIdRole,
+        TitleRole,
+        GenreRole,
+        DurationRole,
+        RatingRole,
+        DescriptionRole,
+        AccentColorRole,
+        ThumbnailUrlRole,
+        VideoUrlRole
+    };
+
+    explicit MediaItemListModel(StreamingService::Snapshot snapshot, std::uint32_t category, QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    Q_INVOKABLE QVariantMap get(int row) const;
+
+    // Points the model at a newer snapshot whose row holds the same titles.
+    void rebind(StreamingService::Snapshot snapshot, std::uint32_t category);
+    void insertItems(StreamingService::Snapshot snapshot, std::uint32_t category, int first, int count);
+
+private:
+    StreamingService::Snapshot m_snapshot;
+    std::uint32_t m_category;
+
+    const MediaCategory &row() const;
+};
+
+class CategoryListModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    enum Roles
+    {
+        NameRole = Qt::UserRole + 1,
+        ItemsRole,
+        CountRole
+    };
+
+    explicit CategoryListModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    void setSnapshot(StreamingService::Snapshot snapshot);
+    void applyDelta(StreamingService::Snapshot snapshot, const CatalogDelta &delta);
+
+    const CatalogSnapshot &snapshot() const;
+    MediaItemListModel *itemsModel(int row) const;
+
+private:
+    StreamingService::Snapshot m_snapshot;
+    // Created on first access so rows that are never shown cost nothing.
+    mutable QVector<MediaItemListModel *> m_rows;
+};
+
+// Keeps the titles of a single type ("movie", "series"); an empty filter keeps everything.
+class MediaTypeFilterModel : public QSortFilterProxyModel
+{
+    Q_OBJECT
+
+public:
+    explicit MediaTypeFilterModel(const QString &mediaType, QObject *parent = nullptr);
+
+    Q_INVOKABLE QVariantMap get(int row) const;
+
+    static bool matches(const std::string &type, const QString &mediaType);
+
+protected:
+    bool filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const override;
+
+private:
+    QString m_mediaType;
+};
+
+// Category rows that contain at least one title of the given type, each exposing a
+// MediaTypeFilterModel over its titles.
+class CategoryFilterModel : public QSortFilterProxyModel
+{
+    Q_OBJECT
+
+public:
+    explicit CategoryFilterModel(const QString &mediaType, QObject *parent = nullptr);
+
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+protected:
+    bool filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const override;
+
+private:
+    QString m_mediaType;
+};
@@ -0,0 +1,48 @@
+#include "EntitlementCache.h"
+
+EntitlementCache::EntitlementCache(qint64 maxAgeSecs)
+    : m_maxAgeSecs(maxAgeSecs)
+{
+}
+
+std::optional<Entitlement> EntitlementCache::find(int userId, const QDateTime &now) const
+{
+    QMutexLocker lock(&m_mutex);
+    const auto it = m_entries.constFind(userId);
+    if (it == m_entries.constEnd() || it->loadedAt.secsTo(now) > m_maxAgeSecs)
+    {
+        return std::nullopt;
+    }
+    return it->entitlement;
+}
+
+quint64 EntitlementCache::generation(int userId) const
+{
+    QMutexLocker lock(&m_mutex);
+    return qMax(m_generations.value(userId), m_clearedAt);
+}
+
+void EntitlementCache::store(int userId, const Entitlement &entitlement, const QDateTime &now, quint64 generation)
+{
+    QMutexLocker lock(&m_mutex);
+    if (generation != qMax(m_generations.value(userId), m_clearedAt))
+    {
+        return;
+    }
+    m_entries.insert(userId, Entry{entitlement, now});
+}
+
+void EntitlementCache::invalidate(int userId)
+{
+    QMutexLocker lock(&m_mutex);
+    m_entries.remove(userId);
+    m_generations.insert(userId, ++m_lastGeneration);
+}
+
+void EntitlementCache::clear()
+{
+    QMutexLocker lock(&m_mutex);
+    m_entries.clear();
+    m_generations.clear();
+    m_clearedAt = ++m_lastGeneration;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <QDate>
+#include <QDateTime>
+#include <QHash>
+#include <QMutex>
+
+#include <optional>
+
+struct Entitlement
+{
+    bool unrestricted = false;
+    bool subscribed = false;
+    QDate endDate;
+
+    bool allowsPlaybackOn(const QDate &day) const
+    {
+        return unrestricted || (subscribed && endDate.isValid() && day <= endDate);
+    }
+};
+
+// Per-user playback entitlements so starting a title does not reload the whole profile.
+// Entries expire on their own after maxAge, which bounds staleness when another process
+// changes subscriptions; changes made through this process invalidate the user directly.
+// A loader takes generation() before reading the database and hands it to store(), which
+// drops the entry if the user was invalidated in between, so a read that raced a change
+// cannot outlive it.
+class EntitlementCache
+{
+public:
+    explicit EntitlementCache(qint64 maxAgeSecs = 300);
+
+    std::optional<Entitlement> find(int userId, const QDateTime &now) const;
+    quint64 generation(int userId) const;
+    void store(int userId, const Entitlement &entitlement, const QDateTime &now, quint64 generation);
+    void invalidate(int userId);
+    void clear();
+
+private:
+    struct Entry
+    {
+        Entitlement entitlement;
+        QDateTime loadedAt;
+    };
+
+    mutable QMutex m_mutex;
+    QHash<int, Entry> m_entries;
+    // Last invalidation per user; users never invalidated fall back to the last clear().
+    QHash<int, quint64> m_generations;
+    quint64 m_clearedAt = 0;
+    quint64 m_lastGeneration = 0;
+    qint64 m_maxAgeSecs;
+};
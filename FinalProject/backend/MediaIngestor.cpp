@@ -0,0 +1,171 @@
+#include "MediaIngestor.h"
+
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QUrl>
+
+namespace
+{
+const int kIngestThreads = 3;
+const qint64 kProgressIntervalMs = 100;
+
+struct PlannedFile
+{
+    QString source;
+    qint64 size = 0;
+};
+
+PlannedFile plan(const IngestFile &file)
+{
+    PlannedFile planned;
+    const QString trimmed = file.source.trimmed();
+    if (trimmed.isEmpty())
+    {
+        return planned;
+    }
+
+    const QUrl url(trimmed);
+    const QFileInfo info(url.isLocalFile() ? url.toLocalFile() : trimmed);
+    if (!info.exists() || !info.isFile())
+    {
+        return planned;
+    }
+
+    planned.source = info.absoluteFilePath();
+    planned.size = info.size();
+    return planned;
+}
+
+QVariantMap failed(const QString &message)
+{
+    QVariantMap result;
+    result.insert(QStringLiteral("success"), false);
+    result.insert(QStringLiteral("message"), message);
+    return result;
+}
+} // namespace
+
+MediaIngestor::MediaIngestor(QObject *parent)
+    : QObject(parent)
+{
+    m_pool.setMaxThreadCount(kIngestThreads);
+}
+
+MediaIngestor::~MediaIngestor()
+{
+    {
+        QMutexLocker lock(&m_mutex);
+        for (const auto &flag : std::as_const(m_cancelFlags))
+        {
+            *flag = true;
+        }
+    }
+    m_pool.waitForDone();
+}
+
+int MediaIngestor::start(const QString &label, const QVector<IngestFile> &files, Commit commit, Done done)
+{
+    const int jobId = ++m_lastJobId;
+    auto cancelled = std::make_shared<std::atomic<bool>>(false);
+    {
+        QMutexLocker lock(&m_mutex);
+        m_cancelFlags.insert(jobId, cancelled);
+    }
+
+    m_pool.start([this, jobId, label, files, commit = std::move(commit), done = std::move(done), cancelled]() {
+        const QVariantMap result = run(jobId, label, files, commit, *cancelled);
+        {
+            QMutexLocker lock(&m_mutex);
+            m_cancelFlags.remove(jobId);
+        }
+        QMetaObject::invokeMethod(
+            this,
+            [this, jobId, label, result, done]() {
+                if (done)
+                {
+                    done(result);
+                }
+                emit finished(jobId, label, result);
+            },
+            Qt::QueuedConnection);
+    });
+    return jobId;
+}
+
+void MediaIngestor::cancel(int jobId)
+{
+    QMutexLocker lock(&m_mutex);
+    if (const auto flag = m_cancelFlags.value(jobId))
+    {
+        *flag = true;
+    }
+}
+
+QVariantMap MediaIngestor::run(int jobId,
+                               const QString &label,
+                               const QVector<IngestFile> &files,
+                               const Commit &commit,
+                               const std::atomic<bool> &cancelled)
+{
+    QVector<PlannedFile> planned;
+    qint64 totalBytes = 0;
+    for (const auto &file : files)
+    {
+        planned.append(plan(file));
+        totalBytes += planned.back().size;
+    }
+
+    QVector<StoredBlob> stored;
+    const auto releaseStored = [&stored]() {
+        for (const auto &blob : std::as_const(stored))
+        {
+            if (!blob.path.isEmpty())
+            {
+                MediaStore::release(blob.path);
+            }
+        }
+    };
+
+    qint64 copiedBefore = 0;
+    QElapsedTimer sinceReport;
+    sinceReport.start();
+    emit progress(jobId, label, 0, totalBytes);
+
+    // Files that landed for a job that later fails stay in the store unreferenced; another
+    // title may already share them, so they are left to MediaStore::collectGarbage.
+    for (int i = 0; i < planned.size(); ++i)
+    {
+        const PlannedFile &file = planned[i];
+        if (file.source.isEmpty())
+        {
+            stored.append(StoredBlob());
+            continue;
+        }
+
+        QString error;
+        const auto blob = MediaStore::import(file.source, files[i].storeDir,
+                                             [&](std::uint64_t copied, std::uint64_t) {
+                                                 if (sinceReport.elapsed() >= kProgressIntervalMs)
+                                                 {
+                                                     sinceReport.restart();
+                                                     emit progress(jobId, label, copiedBefore + static_cast<qint64>(copied), totalBytes);
+                                                 }
+                                                 return !cancelled.load();
+                                             },
+                                             &error);
+        if (!blob)
+        {
+            releaseStored();
+            return failed(cancelled.load() ? QStringLiteral("Upload cancelled")
+                                           : QStringLiteral("Failed to copy %1: %2").arg(QFileInfo(file.source).fileName(), error));
+        }
+
+        stored.append(*blob);
+        copiedBefore += file.size;
+    }
+    emit progress(jobId, label, totalBytes, totalBytes);
+
+    const QVariantMap result = commit ? commit(stored) : QVariantMap{{QStringLiteral("success"), true}};
+    releaseStored();
+    return result;
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "../shared/MediaStore.h"
+
+#include <QHash>
+#include <QMutex>
+#include <QObject>
+#include <QStringList>
+#include <QThreadPool>
+#include <QVariant>
+#include <QVector>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+
+struct IngestFile
+{
+    QString source;
+    QString storeDir;
+};
+
+// Copies uploaded media into the content-addressed library on background threads. Each job
+// copies its files, then runs its commit step on the same worker so the database only learns
+// about media that has fully landed. Several jobs may run at once.
+class MediaIngestor : public QObject
+{
+    Q_OBJECT
+
+public:
+    // Receives the stored blobs in the order the files were given; a file without a source
+    // yields a blob with an empty path. The blobs stay pinned until commit returns.
+    using Commit = std::function<QVariantMap(const QVector<StoredBlob> &stored)>;
+    using Done = std::function<void(const QVariantMap &result)>;
+
+    explicit MediaIngestor(QObject *parent = nullptr);
+    ~MediaIngestor() override;
+
+    // commit runs on the worker; done runs on this object's thread before finished is emitted.
+    int start(const QString &label, const QVector<IngestFile> &files, Commit commit, Done done = {});
+    void cancel(int jobId);
+
+signals:
+    void progress(int jobId, const QString &label, qint64 copiedBytes, qint64 totalBytes);
+    void finished(int jobId, const QString &label, const QVariantMap &result);
+
+private:
+    QThreadPool m_pool;
+    QMutex m_mutex;
+    QHash<int, std::shared_ptr<std::atomic<bool>>> m_cancelFlags;
+    std::atomic<int> m_lastJobId{0};
+
+    QVariantMap run(int jobId,
+                    const QString &label,
+                    const QVector<IngestFile> &files,
+                    const Commit &commit,
+                    const std::atomic<bool> &cancelled);
+};
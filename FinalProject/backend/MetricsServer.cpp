@@ -0,0 +1,112 @@
+#include "MetricsServer.h"
+
+#include "../core/Metrics.h"
+
+#include <QDebug>
+#include <QTcpSocket>
+#include <QTimer>
+
+#include <memory>
+#include <utility>
+
+namespace
+{
+const int kMaxRequestBytes = 8 * 1024;
+const int kIdleTimeoutMs = 5000;
+
+QByteArray response(const QByteArray &status, const QByteArray &contentType, const QByteArray &body)
+{
+    QByteArray out = "HTTP/1.1 " + status + "\r\n";
+    out += "Content-Type: " + contentType + "\r\n";
+    out += "Content-Length: " + QByteArray::number(body.size()) + "\r\n";
+    out += "Connection: close\r\n\r\n";
+    out += body;
+    return out;
+}
+} // namespace
+
+MetricsServer::MetricsServer(QObject *parent)
+    : QObject(parent)
+{
+    connect(&m_server, &QTcpServer::newConnection, this, &MetricsServer::accept);
+}
+
+bool MetricsServer::listen(quint16 port)
+{
+    // Never reachable from other machines; remote scrapers go through a local agent.
+    if (!m_server.listen(QHostAddress::LocalHost, port))
+    {
+        qWarning() << "Unable to serve metrics on port" << port << ":" << m_server.errorString();
+        return false;
+    }
+    return true;
+}
+
+quint16 MetricsServer::port() const
+{
+    return m_server.serverPort();
+}
+
+void MetricsServer::setBeforeScrape(std::function<void()> hook)
+{
+    m_beforeScrape = std::move(hook);
+}
+
+void MetricsServer::accept()
+{
+    while (QTcpSocket *socket = m_server.nextPendingConnection())
+    {
+        connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+        QTimer::singleShot(kIdleTimeoutMs, socket, [socket]() { socket->abort(); });
+
+        auto request = std::make_shared<QByteArray>();
+        connect(socket, &QTcpSocket::readyRead, this, [this, socket, request]() {
+            request->append(socket->readAll());
+            const bool complete = request->contains("\r\n\r\n");
+            if (!complete && request->size() <= kMaxRequestBytes)
+            {
+                return;
+            }
+
+            // One request per connection; anything sent after it is ignored.
+            disconnect(socket, &QTcpSocket::readyRead, this, nullptr);
+            if (complete)
+            {
+                respond(socket, *request);
+            }
+            else
+            {
+                socket->write(response("431 Request Header Fields Too Large", "text/plain", QByteArray()));
+                socket->disconnectFromHost();
+            }
+        });
+    }
+}
+
+void MetricsServer::respond(QTcpSocket *socket, const QByteArray &request)
+{
+    const QList<QByteArray> requestLine = request.left(request.indexOf("\r\n")).split(' ');
+    const QByteArray method = requestLine.value(0);
+    const QByteArray target = requestLine.value(1);
+    const QByteArray path = target.left(target.indexOf('?') < 0 ? target.size() : target.indexOf('?'));
+
+    if (method != "GET")
+    {
+        socket->write(response("405 Method Not Allowed", "text/plain", "Only GET is supported\n"));
+    }
+    else if (path != "/metrics")
+    {
+        socket->write(response("404 Not Found", "text/plain", "Metrics are served at /metrics\n"));
+    }
+    else
+    {
+        if (m_beforeScrape)
+        {
+            m_beforeScrape();
+        }
+        const std::string body = Metrics::prometheusText();
+        socket->write(response("200 OK", "text/plain; version=0.0.4; charset=utf-8",
+                               QByteArray(body.data(), static_cast<qsizetype>(body.size()))));
+    }
+    socket->disconnectFromHost();
+}
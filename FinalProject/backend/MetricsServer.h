@@ -0,0 +1,30 @@
+#pragma once
+
+#include <QObject>
+#include <QTcpServer>
+
+#include <functional>
+
+class QTcpSocket;
+
+// Serves the metrics registry as GET /metrics on localhost, for Prometheus-style scrapers.
+// Each connection gets one response and is closed.
+class MetricsServer : public QObject
+{
+public:
+    explicit MetricsServer(QObject *parent = nullptr);
+
+    // Port 0 picks a free port; see port().
+    bool listen(quint16 port);
+    quint16 port() const;
+
+    // Runs before every scrape, on this object's thread, to refresh sampled gauges.
+    void setBeforeScrape(std::function<void()> hook);
+
+private:
+    void accept();
+    void respond(QTcpSocket *socket, const QByteArray &request);
+
+    QTcpServer m_server;
+    std::function<void()> m_beforeScrape;
+};
@@ -0,0 +1,205 @@
+#include "PlaybackLogger.h"
+
+#include "../shared/ConnectionPool.h"
+#include "../shared/DatabaseUtils.h"
+
+#include <QDeadlineTimer>
+#include <QDebug>
+#include <QHash>
+#include <QPair>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QThread>
+
+namespace
+{
+using PendingEvents = QHash<QPair<int, int>, PlaybackEvent>;
+
+bool writeBatch(const PendingEvents &pending, quint64 &rowsWritten)
+{
+    auto connection = ConnectionPool::instance().acquire();
+    QSqlDatabase db = connection.database();
+    if (!db.isOpen() || !db.transaction())
+    {
+        return false;
+    }
+
+    quint64 written = 0;
+    for (const PlaybackEvent &event : pending)
+    {
+        // Events for profiles or titles that no longer exist select no row and are dropped.
+        QSqlQuery &upsert = connection.prepare(QStringLiteral(
+            "INSERT INTO watch_history (profile_id, title_id, position_sec, is_finished, updated_at) "
+            "SELECT p.id, t.id, ?, ?, datetime('now') FROM profiles p, titles t WHERE p.id = ? AND t.id = ? "
+            "ON CONFLICT (profile_id, title_id) DO UPDATE SET "
+            "position_sec = excluded.position_sec, is_finished = excluded.is_finished, updated_at = excluded.updated_at"));
+        upsert.addBindValue(event.positionSec);
+        upsert.addBindValue(event.finished ? 1 : 0);
+        upsert.addBindValue(event.profileId);
+        upsert.addBindValue(event.titleId);
+        if (!DatabaseUtils::exec(upsert))
+        {
+            qWarning() << "Failed to record playback:" << upsert.lastError().text();
+            db.rollback();
+            return false;
+        }
+        written += upsert.numRowsAffected() > 0 ? 1 : 0;
+    }
+
+    if (!db.commit())
+    {
+        db.rollback();
+        return false;
+    }
+    rowsWritten += written;
+    return true;
+}
+} // namespace
+
+PlaybackLogger::PlaybackLogger(std::chrono::milliseconds flushInterval)
+    : m_flushIntervalMs(qMax<qint64>(1, flushInterval.count()))
+    , m_writer(QThread::create([this]() { run(); }))
+{
+    m_writer->setObjectName(QStringLiteral("PlaybackLogger"));
+    m_writer->start(QThread::LowPriority);
+}
+
+PlaybackLogger::~PlaybackLogger()
+{
+    {
+        QMutexLocker lock(&m_mutex);
+        m_stopping = true;
+        m_wake.wakeOne();
+    }
+    m_writer->wait();
+
+    for (Node *node = takeAll(); node;)
+    {
+        Node *next = node->next;
+        delete node;
+        node = next;
+    }
+}
+
+void PlaybackLogger::enqueue(PlaybackEvent event)
+{
+    auto *node = new Node{std::move(event), m_head.load(std::memory_order_relaxed)};
+    while (!m_head.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed))
+    {
+    }
+    m_eventsQueued.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool PlaybackLogger::flush()
+{
+    QMutexLocker lock(&m_mutex);
+    const quint64 target = ++m_flushRequested;
+    m_wake.wakeOne();
+    while (m_flushCompleted < target)
+    {
+        m_flushed.wait(&m_mutex);
+    }
+    return m_flushWritten >= target;
+}
+
+void PlaybackLogger::setFlushInterval(std::chrono::milliseconds interval)
+{
+    m_flushIntervalMs = qMax<qint64>(1, interval.count());
+    QMutexLocker lock(&m_mutex);
+    m_wake.wakeOne();
+}
+
+std::chrono::milliseconds PlaybackLogger::flushInterval() const
+{
+    return std::chrono::milliseconds(m_flushIntervalMs.load());
+}
+
+PlaybackLoggerStats PlaybackLogger::stats() const
+{
+    PlaybackLoggerStats stats;
+    stats.eventsQueued = m_eventsQueued.load();
+    stats.rowsWritten = m_rowsWritten.load();
+    stats.batches = m_batches.load();
+    stats.failedBatches = m_failedBatches.load();
+    return stats;
+}
+
+void PlaybackLogger::run()
+{
+    DatabaseUtils::ensureDatabase();
+
+    // Survives a failed batch so the events are retried on the next tick.
+    PendingEvents pending;
+    for (;;)
+    {
+        quint64 flushTarget = 0;
+        bool stopping = false;
+        {
+            QMutexLocker lock(&m_mutex);
+            if (!m_stopping && m_flushRequested == m_flushCompleted)
+            {
+                m_wake.wait(&m_mutex, QDeadlineTimer(m_flushIntervalMs.load()));
+            }
+            flushTarget = m_flushRequested;
+            stopping = m_stopping;
+        }
+
+        for (Node *node = takeAll(); node;)
+        {
+            const QPair<int, int> key(node->event.profileId, node->event.titleId);
+            pending.insert(key, std::move(node->event));
+            Node *next = node->next;
+            delete node;
+            node = next;
+        }
+
+        if (!pending.isEmpty())
+        {
+            quint64 rowsWritten = 0;
+            if (writeBatch(pending, rowsWritten))
+            {
+                ++m_batches;
+                m_rowsWritten += rowsWritten;
+                pending.clear();
+            }
+            else
+            {
+                ++m_failedBatches;
+                if (stopping)
+                {
+                    qWarning() << "Dropping" << pending.size() << "playback events at shutdown";
+                }
+            }
+        }
+
+        {
+            QMutexLocker lock(&m_mutex);
+            m_flushCompleted = flushTarget;
+            if (pending.isEmpty())
+            {
+                m_flushWritten = flushTarget;
+            }
+            m_flushed.wakeAll();
+        }
+
+        if (stopping)
+        {
+            break;
+        }
+    }
+}
+
+PlaybackLogger::Node *PlaybackLogger::takeAll()
+{
+    // The stack holds the newest event first; reverse it so later events overwrite earlier ones.
+    Node *node = m_head.exchange(nullptr, std::memory_order_acquire);
+    Node *ordered = nullptr;
+    while (node)
+    {
+        Node *next = node->next;
+        node->next = ordered;
+        ordered = node;
+        node = next;
+    }
+    return ordered;
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <QMutex>
+#include <QString>
+#include <QWaitCondition>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+
+class QThread;
+
+struct PlaybackEvent
+{
+    int profileId = 0;
+    int titleId = 0;
+    int positionSec = 0;
+    bool finished = false;
+};
+
+struct PlaybackLoggerStats
+{
+    quint64 eventsQueued{};
+    quint64 rowsWritten{};
+    quint64 batches{};
+    quint64 failedBatches{};
+};
+
+// Write-behind queue for playback progress. Players post events without taking a lock; a
+// background writer wakes every flush interval, keeps only the latest event per profile
+// and title, and upserts the batch into watch_history in one transaction. Pending events are
+// written before the logger is destroyed.
+class PlaybackLogger
+{
+public:
+    explicit PlaybackLogger(std::chrono::milliseconds flushInterval = std::chrono::milliseconds(1000));
+    ~PlaybackLogger();
+
+    PlaybackLogger(const PlaybackLogger &) = delete;
+    PlaybackLogger &operator=(const PlaybackLogger &) = delete;
+
+    void enqueue(PlaybackEvent event);
+
+    // Blocks until the writer has tried to write every event enqueued before the call.
+    // Returns false if that batch failed; its events stay queued and are retried on the next
+    // tick.
+    bool flush();
+
+    void setFlushInterval(std::chrono::milliseconds interval);
+    std::chrono::milliseconds flushInterval() const;
+
+    PlaybackLoggerStats stats() const;
+
+private:
+    struct Node
+    {
+        PlaybackEvent event;
+        Node *next = nullptr;
+    };
+
+    std::atomic<Node *> m_head{nullptr};
+    std::atomic<qint64> m_flushIntervalMs;
+
+    mutable QMutex m_mutex;
+    QWaitCondition m_wake;
+    QWaitCondition m_flushed;
+    quint64 m_flushRequested = 0;
+    quint64 m_flushCompleted = 0;
+    // Latest flush request whose events were all written.
+    quint64 m_flushWritten = 0;
+    bool m_stopping = false;
+
+    std::atomic<quint64> m_eventsQueued{0};
+    std::atomic<quint64> m_rowsWritten{0};
+    std::atomic<quint64> m_batches{0};
+    std::atomic<quint64> m_failedBatches{0};
+
+    std::unique_ptr<QThread> m_writer;
+
+    void run();
+    Node *takeAll();
+};
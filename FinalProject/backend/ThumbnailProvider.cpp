@@ -0,0 +1,153 @@
+#include "ThumbnailProvider.h"
+
+#include "Thumbnails.h"
+
+#include <QFileInfo>
+#include <QImageReader>
+#include <QRunnable>
+#include <QUrl>
+
+#include <atomic>
+
+namespace
+{
+const int kDecodeThreads = 2;
+
+// QCache costs are ints, so the budget is tracked in KiB.
+int costOf(const QImage &image)
+{
+    return qMax(1, static_cast<int>(image.sizeInBytes() / 1024));
+}
+
+QImage decode(const QString &path, const QSize &requestedSize)
+{
+    QImageReader reader(path);
+    reader.setAutoTransform(true);
+    const QSize size = reader.size();
+    if (size.isValid() && requestedSize.width() > 0 && requestedSize.height() > 0)
+    {
+        // Cover the requested box, since the views crop rather than letterbox.
+        const QSize covering = size.scaled(requestedSize, Qt::KeepAspectRatioByExpanding);
+        if (covering.width() < size.width())
+        {
+            reader.setScaledSize(covering);
+        }
+    }
+    return reader.read();
+}
+
+class ThumbnailResponse : public QQuickImageResponse, public QRunnable
+{
+public:
+    ThumbnailResponse(ThumbnailProvider *provider, const QString &id, const QSize &requestedSize)
+        : m_provider(provider)
+        , m_id(id)
+        , m_requestedSize(requestedSize)
+    {
+        setAutoDelete(false);
+    }
+
+    QQuickTextureFactory *textureFactory() const override
+    {
+        return QQuickTextureFactory::textureFactoryForImage(m_image);
+    }
+
+    QString errorString() const override { return m_error; }
+
+    void cancel() override { m_cancelled = true; }
+
+    void run() override
+    {
+        if (!m_cancelled)
+        {
+            load();
+        }
+        emit finished();
+    }
+
+private:
+    void load()
+    {
+        const qsizetype slash = m_id.indexOf(QLatin1Char('/'));
+        const auto variant = Thumbnails::variantFromName(m_id.left(slash));
+        const QUrl url(m_id.mid(slash + 1));
+        const QString original = url.isLocalFile() ? url.toLocalFile() : url.toString();
+        if (slash < 0 || !variant || original.isEmpty())
+        {
+            m_error = QStringLiteral("Invalid thumbnail id %1").arg(m_id);
+            return;
+        }
+
+        const QString key = QStringLiteral("%1|%2x%3").arg(m_id).arg(m_requestedSize.width()).arg(m_requestedSize.height());
+        if (const auto image = m_provider->cached(key))
+        {
+            m_image = *image;
+            return;
+        }
+
+        const QString generated = Thumbnails::variantPath(original, *variant);
+        m_image = decode(QFileInfo::exists(generated) ? generated : original, m_requestedSize);
+        if (m_image.isNull())
+        {
+            m_error = QStringLiteral("Unable to decode %1").arg(original);
+            return;
+        }
+        m_provider->insert(key, m_image);
+    }
+
+    ThumbnailProvider *m_provider;
+    QString m_id;
+    QSize m_requestedSize;
+    QImage m_image;
+    QString m_error;
+    std::atomic<bool> m_cancelled{false};
+};
+} // namespace
+
+ThumbnailProvider::ThumbnailProvider(qint64 budgetBytes)
+    : m_cache(static_cast<int>(qMax<qint64>(1, budgetBytes / 1024)))
+{
+    m_pool.setMaxThreadCount(kDecodeThreads);
+}
+
+ThumbnailProvider::~ThumbnailProvider()
+{
+    m_pool.waitForDone();
+}
+
+QQuickImageResponse *ThumbnailProvider::requestImageResponse(const QString &id, const QSize &requestedSize)
+{
+    auto *response = new ThumbnailResponse(this, id, requestedSize);
+    m_pool.start(response);
+    return response;
+}
+
+ThumbnailCacheStats ThumbnailProvider::stats() const
+{
+    QMutexLocker lock(&m_mutex);
+    ThumbnailCacheStats stats;
+    stats.hits = m_hits;
+    stats.misses = m_misses;
+    stats.cachedBytes = static_cast<qint64>(m_cache.totalCost()) * 1024;
+    stats.budgetBytes = static_cast<qint64>(m_cache.maxCost()) * 1024;
+    return stats;
+}
+
+std::optional<QImage> ThumbnailProvider::cached(const QString &key)
+{
+    QMutexLocker lock(&m_mutex);
+    // QCache::object() also marks the entry as most recently used.
+    if (const QImage *image = m_cache.object(key))
+    {
+        ++m_hits;
+        return *image;
+    }
+    ++m_misses;
+    return std::nullopt;
+}
+
+void ThumbnailProvider::insert(const QString &key, const QImage &image)
+{
+    QMutexLocker lock(&m_mutex);
+    m_cache.insert(key, new QImage(image), costOf(image));
+}
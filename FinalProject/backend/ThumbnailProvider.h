@@ -0,0 +1,43 @@
+#pragma once
+
+#include <QCache>
+#include <QImage>
+#include <QMutex>
+#include <QQuickAsyncImageProvider>
+#include <QThreadPool>
+
+#include <optional>
+
+struct ThumbnailCacheStats
+{
+    qint64 hits = 0;
+    qint64 misses = 0;
+    qint64 cachedBytes = 0;
+    qint64 budgetBytes = 0;
+};
+
+// Serves image://thumbnails/<variant>/<file url>. Uses the generated variant when it exists
+// and otherwise decodes the original straight at the requested size, so scrolling a row of
+// cards never decodes full-resolution posters. Decoded images stay in an LRU cache bounded
+// by a byte budget.
+class ThumbnailProvider : public QQuickAsyncImageProvider
+{
+public:
+    explicit ThumbnailProvider(qint64 budgetBytes = 64ll * 1024 * 1024);
+    ~ThumbnailProvider() override;
+
+    QQuickImageResponse *requestImageResponse(const QString &id, const QSize &requestedSize) override;
+
+    ThumbnailCacheStats stats() const;
+
+    // Called from the pool threads.
+    std::optional<QImage> cached(const QString &key);
+    void insert(const QString &key, const QImage &image);
+
+private:
+    mutable QMutex m_mutex;
+    QCache<QString, QImage> m_cache;
+    qint64 m_hits = 0;
+    qint64 m_misses = 0;
+    QThreadPool m_pool;
+};
@@ -0,0 +1,127 @@
+#include "Thumbnails.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QImage>
+#include <QImageReader>
+#include <QImageWriter>
+
+#include <iterator>
+
+namespace
+{
+const int kQuality = 80;
+const Thumbnails::Variant kVariants[] = {Thumbnails::Variant::List, Thumbnails::Variant::Card, Thumbnails::Variant::Hero};
+
+const char *variantName(Thumbnails::Variant variant)
+{
+    switch (variant)
+    {
+    case Thumbnails::Variant::List:
+        return "list";
+    case Thumbnails::Variant::Card:
+        return "card";
+    case Thumbnails::Variant::Hero:
+        return "hero";
+    }
+    return "card";
+}
+
+// WebP when the image formats plugin is deployed, JPEG otherwise.
+const QByteArray &variantFormat()
+{
+    static const QByteArray format = QImageWriter::supportedImageFormats().contains("webp") ? QByteArray("webp")
+                                                                                            : QByteArray("jpg");
+    return format;
+}
+} // namespace
+
+namespace Thumbnails
+{
+std::optional<Variant> variantFromName(const QString &name)
+{
+    for (const Variant variant : kVariants)
+    {
+        if (name == QLatin1String(variantName(variant)))
+        {
+            return variant;
+        }
+    }
+    return std::nullopt;
+}
+
+QSize boundingSize(Variant variant)
+{
+    switch (variant)
+    {
+    case Variant::List:
+        return QSize(160, 160);
+    case Variant::Card:
+        return QSize(540, 540);
+    case Variant::Hero:
+        return QSize(1600, 1600);
+    }
+    return QSize(540, 540);
+}
+
+QString variantPath(const QString &originalPath, Variant variant)
+{
+    const QFileInfo info(originalPath);
+    return info.dir().filePath(QStringLiteral("%1.%2.%3")
+                                   .arg(info.completeBaseName(),
+                                        QLatin1String(variantName(variant)),
+                                        QString::fromLatin1(variantFormat())));
+}
+
+bool generate(const QString &originalPath, QString *error)
+{
+    QImageReader reader(originalPath);
+    reader.setAutoTransform(true);
+    const QSize original = reader.size();
+    QImage source;
+
+    for (auto it = std::rbegin(kVariants); it != std::rend(kVariants); ++it)
+    {
+        const QString target = variantPath(originalPath, *it);
+        if (QFileInfo::exists(target))
+        {
+            continue;
+        }
+
+        // Decode once at the largest size needed and derive the smaller variants from it.
+        if (source.isNull())
+        {
+            if (original.isValid())
+            {
+                reader.setScaledSize(original.boundedTo(original.scaled(boundingSize(*it), Qt::KeepAspectRatio)));
+            }
+            source = reader.read();
+            if (source.isNull())
+            {
+                *error = reader.errorString();
+                return false;
+            }
+        }
+
+        const QSize size = source.size().boundedTo(source.size().scaled(boundingSize(*it), Qt::KeepAspectRatio));
+        const QImage scaled = size == source.size() ? source : source.scaled(size, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+
+        const QString partial = target + QStringLiteral(".part");
+        QImageWriter writer(partial, variantFormat());
+        writer.setQuality(kQuality);
+        if (!writer.write(scaled))
+        {
+            QFile::remove(partial);
+            *error = writer.errorString();
+            return false;
+        }
+        // Another job importing the same blob may have finished this variant first.
+        if (!QFile::rename(partial, target))
+        {
+            QFile::remove(partial);
+        }
+    }
+    return true;
+}
+}
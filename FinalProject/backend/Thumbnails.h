@@ -0,0 +1,26 @@
+#pragma once
+
+#include <QSize>
+#include <QString>
+
+#include <optional>
+
+// Downscaled copies of a thumbnail, written next to the original as <name>.<variant>.<fmt>.
+// Each variant keeps the original aspect ratio and fits inside its bounding box, so any
+// view can crop it the way it would have cropped the original.
+namespace Thumbnails
+{
+enum class Variant
+{
+    List,
+    Card,
+    Hero
+};
+
+std::optional<Variant> variantFromName(const QString &name);
+QSize boundingSize(Variant variant);
+QString variantPath(const QString &originalPath, Variant variant);
+
+// Writes every variant that does not exist yet. Runs on worker threads.
+bool generate(const QString &originalPath, QString *error);
+}
@@ -0,0 +1,547 @@
+// Replays a call trace recorded with FINALPROJECT_CALL_TRACE against a copy of a database,
+// headless, and reports per-method latency percentiles next to the recorded ones.
+//
+// Usage: CallReplay <trace> <streaming.db> [--speed=1] [--concurrency=1] [--password=replay]
+//
+// --speed scales the recorded gaps between calls: 2 replays twice as fast, 0 issues every call
+// as soon as the one before it has been dispatched. --concurrency replays that many copies of
+// the session side by side, each with its own sessions. Traces never contain passwords, so
+// every user's password in the copy is reset to --password and logins use that. Async calls
+// are timed until their result is delivered, as QML sees them; a call that needs a session
+// still being signed in waits for it.
+
+#include "../backend/Backend.h"
+#include "../backend/CallRecorder.h"
+#include "../core/PasswordHash.h"
+#include "../shared/ConnectionPool.h"
+#include "../shared/DatabaseUtils.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QSet>
+#include <QSqlQuery>
+#include <QTemporaryDir>
+#include <QTimer>
+
+#include <algorithm>
+#include <cstdio>
+#include <limits>
+#include <map>
+#include <vector>
+
+namespace
+{
+enum class Method
+{
+    Unknown,
+    Reload,
+    HeroItem,
+    Search,
+    Authenticate,
+    EndSession,
+    ListUsers,
+    ListGenres,
+    AddGenre,
+    AddMovie,
+    CancelIngestion,
+    UserProfile,
+    AddToMyList,
+    ListPlans,
+    SubscribePlan,
+    CanPlay,
+    LogPlayback,
+    DatabaseStats,
+    CollectMediaGarbage,
+    AuthenticateAsync,
+    ListUsersAsync,
+    ListGenresAsync,
+    AddGenreAsync,
+    AddMovieAsync,
+    UserProfileAsync,
+    AddToMyListAsync,
+    ListPlansAsync,
+    SubscribePlanAsync,
+    CanPlayAsync,
+    CollectMediaGarbageAsync,
+    CancelRequest,
+    CancelRequests,
+};
+
+Method methodOf(const QByteArray &name)
+{
+    static const QHash<QByteArray, Method> methods = {
+        {"reload", Method::Reload},
+        {"heroItem", Method::HeroItem},
+        {"search", Method::Search},
+        {"authenticate", Method::Authenticate},
+        {"endSession", Method::EndSession},
+        {"listUsers", Method::ListUsers},
+        {"listGenres", Method::ListGenres},
+        {"addGenre", Method::AddGenre},
+        {"addMovie", Method::AddMovie},
+        {"cancelIngestion", Method::CancelIngestion},
+        {"userProfile", Method::UserProfile},
+        {"addToMyList", Method::AddToMyList},
+        {"listPlans", Method::ListPlans},
+        {"subscribePlan", Method::SubscribePlan},
+        {"canPlay", Method::CanPlay},
+        {"logPlayback", Method::LogPlayback},
+        {"databaseStats", Method::DatabaseStats},
+        {"collectMediaGarbage", Method::CollectMediaGarbage},
+        {"authenticateAsync", Method::AuthenticateAsync},
+        {"listUsersAsync", Method::ListUsersAsync},
+        {"listGenresAsync", Method::ListGenresAsync},
+        {"addGenreAsync", Method::AddGenreAsync},
+        {"addMovieAsync", Method::AddMovieAsync},
+        {"userProfileAsync", Method::UserProfileAsync},
+        {"addToMyListAsync", Method::AddToMyListAsync},
+        {"listPlansAsync", Method::ListPlansAsync},
+        {"subscribePlanAsync", Method::SubscribePlanAsync},
+        {"canPlayAsync", Method::CanPlayAsync},
+        {"collectMediaGarbageAsync", Method::CollectMediaGarbageAsync},
+        {"cancelRequest", Method::CancelRequest},
+        {"cancelRequests", Method::CancelRequests},
+    };
+    return methods.value(name, Method::Unknown);
+}
+
+struct MethodStats
+{
+    std::vector<qint64> recordedNs;
+    std::vector<qint64> replayedNs;
+    int failures = 0;
+    int cancelled = 0;
+};
+
+double percentileMs(std::vector<qint64> &samples, double percentile)
+{
+    if (samples.empty())
+    {
+        return 0.0;
+    }
+    std::sort(samples.begin(), samples.end());
+    const auto rank = static_cast<std::size_t>(percentile / 100.0 * static_cast<double>(samples.size() - 1) + 0.5);
+    return static_cast<double>(samples[std::min(rank, samples.size() - 1)]) / 1e6;
+}
+
+bool failed(const QVariant &result)
+{
+    return result.typeId() == QMetaType::QVariantMap
+           && !result.toMap().value(QStringLiteral("success"), true).toBool();
+}
+
+class Replayer
+{
+public:
+    Replayer(Backend &backend, std::vector<RecordedCall> calls, double speed, int concurrency, QString password)
+        : m_backend(backend)
+        , m_calls(std::move(calls))
+        , m_speed(speed)
+        , m_password(std::move(password))
+        , m_streams(static_cast<std::size_t>(concurrency))
+    {
+        // Records are written as calls finish; replay them in the order they started.
+        std::sort(m_calls.begin(), m_calls.end(), [](const RecordedCall &a, const RecordedCall &b) {
+            return a.startNs < b.startNs;
+        });
+        for (std::size_t call = 0; call < m_calls.size(); ++call)
+        {
+            for (int stream = 0; stream < concurrency; ++stream)
+            {
+                m_schedule.push_back({stream, call});
+            }
+            m_stats[m_calls[call].method].recordedNs.push_back(m_calls[call].durationNs);
+        }
+
+        QObject::connect(&m_backend, &Backend::requestFinished, &m_backend,
+                         [this](int requestId, const QString &, const QVariant &result) { finishRequest(requestId, result); });
+    }
+
+    void start()
+    {
+        m_clock.start();
+        QTimer::singleShot(0, &m_backend, [this]() { step(); });
+    }
+
+    void report()
+    {
+        const double seconds = static_cast<double>(m_clock.nsecsElapsed()) / 1e9;
+        std::printf("%zu calls x %zu streams in %.2f s, speed %.2f, at most %.1f ms behind schedule\n",
+                    m_calls.size(), m_streams.size(), seconds, m_speed, static_cast<double>(m_maxLagNs) / 1e6);
+        std::printf("%-26s %7s %9s %9s %9s %9s %9s %9s %6s %6s\n", "method", "calls", "p50 ms", "p90 ms", "p99 ms",
+                    "max ms", "rec p50", "rec p99", "fail", "cancel");
+        for (auto &[method, stats] : m_stats)
+        {
+            std::printf("%-26s %7zu %9.3f %9.3f %9.3f %9.3f %9.3f %9.3f %6d %6d\n", method.constData(),
+                        stats.replayedNs.size(), percentileMs(stats.replayedNs, 50), percentileMs(stats.replayedNs, 90),
+                        percentileMs(stats.replayedNs, 99), percentileMs(stats.replayedNs, 100),
+                        percentileMs(stats.recordedNs, 50), percentileMs(stats.recordedNs, 99), stats.failures,
+                        stats.cancelled);
+        }
+    }
+
+private:
+    struct Scheduled
+    {
+        int stream;
+        std::size_t call;
+    };
+
+    struct Stream
+    {
+        // Recorded session token to the one this replay was given for the same login.
+        QHash<QString, QString> tokens;
+        // Recorded tokens whose login is still in flight.
+        QSet<QString> awaited;
+        // Recorded request id to the replayed one, for cancelRequest.
+        QHash<int, int> requests;
+    };
+
+    struct InFlight
+    {
+        int stream;
+        const RecordedCall *call;
+        QString tag;
+        qint64 issuedNs;
+    };
+
+    Backend &m_backend;
+    std::vector<RecordedCall> m_calls;
+    double m_speed;
+    QString m_password;
+    std::vector<Stream> m_streams;
+    std::vector<Scheduled> m_schedule;
+    std::size_t m_next = 0;
+    QHash<int, InFlight> m_inFlight;
+    std::map<QByteArray, MethodStats> m_stats;
+    QElapsedTimer m_clock;
+    qint64 m_maxLagNs = 0;
+    bool m_waiting = false;
+
+    // Dispatches one call per event loop turn so results of async calls arrive in between.
+    void step()
+    {
+        m_waiting = false;
+        if (m_next == m_schedule.size())
+        {
+            finishIfDone();
+            return;
+        }
+
+        const Scheduled &next = m_schedule[m_next];
+        const RecordedCall &call = m_calls[next.call];
+        Stream &stream = m_streams[static_cast<std::size_t>(next.stream)];
+        for (const QVariant &arg : call.args)
+        {
+            if (stream.awaited.contains(arg.toString()))
+            {
+                m_waiting = true;
+                return;
+            }
+        }
+
+        const qint64 due = m_speed > 0 ? static_cast<qint64>(static_cast<double>(call.startNs) / m_speed) : 0;
+        const qint64 now = m_clock.nsecsElapsed();
+        if (due > now)
+        {
+            QTimer::singleShot(static_cast<int>((due - now + 999999) / 1000000), Qt::PreciseTimer, &m_backend,
+                               [this]() { step(); });
+            return;
+        }
+        m_maxLagNs = std::max(m_maxLagNs, now - due);
+
+        ++m_next;
+        dispatch(next.stream, call);
+        QTimer::singleShot(0, &m_backend, [this]() { step(); });
+    }
+
+    void dispatch(int streamIndex, const RecordedCall &call)
+    {
+        Stream &stream = m_streams[static_cast<std::size_t>(streamIndex)];
+        QVariantList args = call.args;
+        for (QVariant &arg : args)
+        {
+            const auto mapped = stream.tokens.constFind(arg.toString());
+            if (mapped != stream.tokens.cend())
+            {
+                arg = *mapped;
+            }
+        }
+        const auto text = [&args](int i) { return args.value(i).toString(); };
+        const auto number = [&args](int i) { return args.value(i).toInt(); };
+        // Async calls carry their tag last.
+        const QString tag = args.isEmpty() ? QString() : args.constLast().toString();
+
+        MethodStats &stats = m_stats[call.method];
+        QVariant result;
+        int requestId = 0;
+        QElapsedTimer timer;
+        timer.start();
+        const qint64 issuedNs = m_clock.nsecsElapsed();
+
+        switch (methodOf(call.method))
+        {
+        case Method::Unknown:
+            std::fprintf(stderr, "Skipping unknown method %s\n", call.method.constData());
+            return;
+        case Method::Reload:
+            m_backend.reload();
+            break;
+        case Method::HeroItem:
+            result = m_backend.heroItem();
+            break;
+        case Method::Search:
+            result = m_backend.search(text(0), number(1));
+            break;
+        case Method::Authenticate:
+            result = m_backend.authenticate(text(0), text(1), text(2), m_password, m_password);
+            break;
+        case Method::EndSession:
+            m_backend.endSession(text(0));
+            break;
+        case Method::ListUsers:
+            result = m_backend.listUsers();
+            break;
+        case Method::ListGenres:
+            result = m_backend.listGenres();
+            break;
+        case Method::AddGenre:
+            result = m_backend.addGenre(text(0));
+            break;
+        case Method::AddMovie:
+            result = m_backend.addMovie(text(0), text(1), text(2), number(3), text(4), text(5));
+            break;
+        case Method::CancelIngestion:
+            m_backend.cancelIngestion(number(0));
+            break;
+        case Method::UserProfile:
+            result = m_backend.userProfile(text(0));
+            break;
+        case Method::AddToMyList:
+            result = m_backend.addToMyList(text(0), number(1));
+            break;
+        case Method::ListPlans:
+            result = m_backend.listPlans();
+            break;
+        case Method::SubscribePlan:
+            result = m_backend.subscribePlan(text(0), number(1));
+            break;
+        case Method::CanPlay:
+            result = m_backend.canPlay(text(0));
+            break;
+        case Method::LogPlayback:
+            m_backend.logPlayback(text(0), number(1), number(2), args.value(3).toBool());
+            break;
+        case Method::DatabaseStats:
+            result = m_backend.databaseStats();
+            break;
+        case Method::CollectMediaGarbage:
+            result = m_backend.collectMediaGarbage();
+            break;
+        case Method::AuthenticateAsync:
+            requestId = m_backend.authenticateAsync(text(0), text(1), text(2), m_password, m_password, QJSValue(), tag);
+            break;
+        case Method::ListUsersAsync:
+            requestId = m_backend.listUsersAsync(QJSValue(), tag);
+            break;
+        case Method::ListGenresAsync:
+            requestId = m_backend.listGenresAsync(QJSValue(), tag);
+            break;
+        case Method::AddGenreAsync:
+            requestId = m_backend.addGenreAsync(text(0), QJSValue(), tag);
+            break;
+        case Method::AddMovieAsync:
+            requestId = m_backend.addMovieAsync(text(0), text(1), text(2), number(3), text(4), text(5), QJSValue(), tag);
+            break;
+        case Method::UserProfileAsync:
+            requestId = m_backend.userProfileAsync(text(0), QJSValue(), tag);
+            break;
+        case Method::AddToMyListAsync:
+            requestId = m_backend.addToMyListAsync(text(0), number(1), QJSValue(), tag);
+            break;
+        case Method::ListPlansAsync:
+            requestId = m_backend.listPlansAsync(QJSValue(), tag);
+            break;
+        case Method::SubscribePlanAsync:
+            requestId = m_backend.subscribePlanAsync(text(0), number(1), QJSValue(), tag);
+            break;
+        case Method::CanPlayAsync:
+            requestId = m_backend.canPlayAsync(text(0), QJSValue(), tag);
+            break;
+        case Method::CollectMediaGarbageAsync:
+            requestId = m_backend.collectMediaGarbageAsync(QJSValue(), tag);
+            break;
+        case Method::CancelRequest:
+            cancel(streamIndex, stream.requests.value(number(0)));
+            break;
+        case Method::CancelRequests:
+            for (auto it = m_inFlight.begin(); it != m_inFlight.end();)
+            {
+                if (it->stream == streamIndex && it->tag == text(0))
+                {
+                    ++m_stats[it->call->method].cancelled;
+                    it = m_inFlight.erase(it);
+                }
+                else
+                {
+                    ++it;
+                }
+            }
+            m_backend.cancelRequests(text(0));
+            break;
+        }
+
+        if (requestId != 0)
+        {
+            stream.requests.insert(call.requestId, requestId);
+            m_inFlight.insert(requestId, InFlight{streamIndex, &call, tag, issuedNs});
+            if (!call.issuedToken.isEmpty())
+            {
+                stream.awaited.insert(call.issuedToken);
+            }
+            return;
+        }
+
+        stats.replayedNs.push_back(timer.nsecsElapsed());
+        finishCall(stream, call, result);
+    }
+
+    void cancel(int streamIndex, int requestId)
+    {
+        const auto it = m_inFlight.find(requestId);
+        if (it != m_inFlight.end() && it->stream == streamIndex)
+        {
+            ++m_stats[it->call->method].cancelled;
+            m_streams[static_cast<std::size_t>(streamIndex)].awaited.remove(it->call->issuedToken);
+            m_inFlight.erase(it);
+        }
+        m_backend.cancelRequest(requestId);
+    }
+
+    void finishRequest(int requestId, const QVariant &result)
+    {
+        const auto it = m_inFlight.find(requestId);
+        if (it == m_inFlight.end())
+        {
+            return;
+        }
+        const InFlight request = *it;
+        m_inFlight.erase(it);
+
+        Stream &stream = m_streams[static_cast<std::size_t>(request.stream)];
+        m_stats[request.call->method].replayedNs.push_back(m_clock.nsecsElapsed() - request.issuedNs);
+        stream.awaited.remove(request.call->issuedToken);
+        finishCall(stream, *request.call, result);
+
+        if (m_waiting)
+        {
+            step();
+        }
+        else
+        {
+            finishIfDone();
+        }
+    }
+
+    void finishCall(Stream &stream, const RecordedCall &call, const QVariant &result)
+    {
+        if (failed(result))
+        {
+            ++m_stats[call.method].failures;
+        }
+        const QString token = result.toMap().value(QStringLiteral("token")).toString();
+        if (!call.issuedToken.isEmpty() && !token.isEmpty())
+        {
+            stream.tokens.insert(call.issuedToken, token);
+        }
+    }
+
+    void finishIfDone()
+    {
+        if (m_next == m_schedule.size() && m_inFlight.isEmpty())
+        {
+            QCoreApplication::quit();
+        }
+    }
+};
+
+bool copyDatabase(const QString &source, const QString &target, const QString &password)
+{
+    // A live database may still have committed pages in its WAL.
+    for (const QString suffix : {QString(), QStringLiteral("-wal")})
+    {
+        if (QFile::exists(source + suffix) && !QFile::copy(source + suffix, target + suffix))
+        {
+            return false;
+        }
+    }
+
+    DatabaseUtils::setDatabaseFilePath(target);
+    if (!DatabaseUtils::ensureDatabase())
+    {
+        return false;
+    }
+    auto connection = ConnectionPool::instance().acquire();
+    QSqlQuery query(connection.database());
+    query.prepare(QStringLiteral("UPDATE users SET password = ?"));
+    query.addBindValue(QString::fromStdString(PasswordHash::hash(password.toStdString(), PasswordHash::Cost())));
+    return query.exec();
+}
+
+QString option(const QStringList &args, const QString &name, const QString &fallback)
+{
+    const QString prefix = QStringLiteral("--%1=").arg(name);
+    for (const QString &arg : args)
+    {
+        if (arg.startsWith(prefix))
+        {
+            return arg.mid(prefix.size());
+        }
+    }
+    return fallback;
+}
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    const QStringList args = app.arguments();
+    if (args.size() < 3)
+    {
+        std::fprintf(stderr, "Usage: CallReplay <trace> <streaming.db> [--speed=1] [--concurrency=1] [--password=replay]\n");
+        return 2;
+    }
+    const double speed = option(args, QStringLiteral("speed"), QStringLiteral("1")).toDouble();
+    const int concurrency = std::max(1, option(args, QStringLiteral("concurrency"), QStringLiteral("1")).toInt());
+    const QString password = option(args, QStringLiteral("password"), QStringLiteral("replay"));
+
+    std::vector<RecordedCall> calls;
+    QString error;
+    if (!CallRecorder::read(args.at(1), calls, &error))
+    {
+        std::fprintf(stderr, "Unable to read %s: %s\n", qPrintable(args.at(1)), qPrintable(error));
+        return 1;
+    }
+
+    QTemporaryDir workDir;
+    if (!workDir.isValid()
+        || !copyDatabase(args.at(2), workDir.filePath(QStringLiteral("streaming.db")), password))
+    {
+        std::fprintf(stderr, "Unable to prepare a copy of %s\n", qPrintable(args.at(2)));
+        return 1;
+    }
+
+    int exitCode = 0;
+    {
+        Backend backend(Backend::createSqlProvider());
+        // Every stream replays the same logins, usually faster than recorded; throttling them
+        // would time the rejection path instead.
+        backend.setLoginLimits({std::numeric_limits<std::uint32_t>::max(), std::chrono::seconds(60)});
+        Replayer replayer(backend, std::move(calls), speed, concurrency, password);
+        replayer.start();
+        exitCode = app.exec();
+        replayer.report();
+    }
+    return exitCode;
+}
@@ -0,0 +1,149 @@
+// Catalog reload latency: legacy per-genre N+1 loader versus the single joined pass
+// used by QtSqlDataProvider::fetchCategories.
+//
+// Usage: CatalogLoadBench [titles=10000] [genres=200] [iterations=10]
+
+#include "../backend/Backend.h"
+#include "../core/DataProvider.h"
+#include "../shared/ConnectionPool.h"
+#include "../shared/DatabaseUtils.h"
+#include "SqlCatalogFixture.h"
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QTemporaryDir>
+
+#include <algorithm>
+#include <cstdio>
+#include <functional>
+#include <vector>
+
+namespace
+{
+// The loader as it was before the single-query rewrite: one genre query, then one
+// items query per genre.
+std::vector<CategoryWithItems> legacyFetchCategories(QSqlDatabase &db)
+{
+    std::vector<CategoryWithItems> result;
+    QSqlQuery genresQuery(db);
+    if (!genresQuery.exec(QStringLiteral("SELECT id, name FROM genres ORDER BY name")))
+    {
+        return result;
+    }
+
+    while (genresQuery.next())
+    {
+        CategoryWithItems category;
+        category.category.id = genresQuery.value(0).toInt();
+        category.category.name = genresQuery.value(1).toString().toStdString();
+
+        QSqlQuery query(db);
+        query.prepare(QStringLiteral(
+            "SELECT t.id, t.type, t.name, t.description, t.age_rating, t.runtime_min, t.accent_color, "
+            "IFNULL(m.thumbnail_url, ''), IFNULL(m.video_url, '') "
+            "FROM titles t "
+            "JOIN title_genres tg ON tg.title_id = t.id "
+            "LEFT JOIN media_files m ON m.title_id = t.id "
+            "WHERE tg.genre_id = ? ORDER BY t.created_at DESC"));
+        query.addBindValue(category.category.id);
+        if (query.exec())
+        {
+            while (query.next())
+            {
+                RawMediaItem item;
+                item.type = query.value(1).toString().toStdString();
+                item.title = query.value(2).toString().toStdString();
+                item.genre = category.category.name;
+                item.description = query.value(3).toString().toStdString();
+                item.rating = query.value(4).toString().toStdString();
+                item.durationMinutes = query.value(5).toInt();
+                item.accentColor = query.value(6).toString().toStdString();
+                item.thumbnailUrl = DatabaseUtils::toFileUrl(query.value(7).toString()).toStdString();
+                item.videoUrl = DatabaseUtils::toFileUrl(query.value(8).toString()).toStdString();
+                category.items.push_back(std::move(item));
+            }
+        }
+
+        if (!category.items.empty())
+        {
+            result.push_back(std::move(category));
+        }
+    }
+    return result;
+}
+
+struct Timing
+{
+    double minMs{};
+    double medianMs{};
+    std::size_t rows{};
+};
+
+Timing measure(int iterations, const std::function<std::vector<CategoryWithItems>()> &load)
+{
+    std::vector<double> samples;
+    std::size_t rows = 0;
+    for (int i = 0; i < iterations; ++i)
+    {
+        QElapsedTimer timer;
+        timer.start();
+        const auto categories = load();
+        samples.push_back(timer.nsecsElapsed() / 1e6);
+
+        rows = 0;
+        for (const auto &category : categories)
+        {
+            rows += category.items.size();
+        }
+    }
+
+    std::sort(samples.begin(), samples.end());
+    return {samples.front(), samples[samples.size() / 2], rows};
+}
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    const QStringList args = app.arguments();
+    const int titles = args.size() > 1 ? args.at(1).toInt() : 10000;
+    const int genres = args.size() > 2 ? args.at(2).toInt() : 200;
+    const int iterations = args.size() > 3 ? args.at(3).toInt() : 10;
+
+    QTemporaryDir workDir;
+    if (!workDir.isValid())
+    {
+        std::fprintf(stderr, "Unable to create temporary directory\n");
+        return 1;
+    }
+
+    DatabaseUtils::setDatabaseFilePath(workDir.filePath(QStringLiteral("catalog-bench.db")));
+    // Migrate first, so both loaders read the same schema and indexes.
+    auto provider = Backend::createSqlProvider();
+    auto connection = ConnectionPool::instance().acquire();
+    QSqlDatabase db = connection.database();
+    if (!db.isOpen() || !SqlCatalogFixture::populate(db, titles, genres))
+    {
+        std::fprintf(stderr, "Unable to build benchmark database\n");
+        return 1;
+    }
+
+    std::printf("catalog reload: %d titles, %d genres, %d iterations\n", titles, genres, iterations);
+
+    const Timing legacy = measure(iterations, [&db]() { return legacyFetchCategories(db); });
+    std::printf("  per-genre N+1   min %8.2f ms  median %8.2f ms  rows %zu\n",
+                legacy.minMs, legacy.medianMs, legacy.rows);
+
+    const Timing joined = measure(iterations, [&provider]() { return provider->fetchCategories(); });
+    std::printf("  single pass     min %8.2f ms  median %8.2f ms  rows %zu\n",
+                joined.minMs, joined.medianMs, joined.rows);
+
+    if (joined.medianMs > 0)
+    {
+        std::printf("  speedup         %.2fx\n", legacy.medianMs / joined.medianMs);
+    }
+    return 0;
+}
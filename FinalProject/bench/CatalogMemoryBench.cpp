@@ -0,0 +1,190 @@
+// Retained heap per catalog: the previous layout (nine std::strings per item, one copy
+// per category row) versus the interned CatalogSnapshot built by StreamingService.
+//
+// Usage: CatalogMemoryBench [titles=100000] [genres=200] [maxGenresPerTitle=5]
+
+#include "../core/StreamingService.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <string>
+
+namespace
+{
+std::atomic<long long> g_liveBytes{0};
+
+// Each allocation carries its size in front so frees can be accounted for.
+constexpr std::size_t kHeader = alignof(std::max_align_t);
+
+void *countedAlloc(std::size_t size)
+{
+    auto *block = static_cast<unsigned char *>(std::malloc(size + kHeader));
+    if (!block)
+    {
+        throw std::bad_alloc();
+    }
+    *reinterpret_cast<std::size_t *>(block) = size;
+    g_liveBytes += static_cast<long long>(size);
+    return block + kHeader;
+}
+
+void countedFree(void *ptr) noexcept
+{
+    if (!ptr)
+    {
+        return;
+    }
+    auto *block = static_cast<unsigned char *>(ptr) - kHeader;
+    g_liveBytes -= static_cast<long long>(*reinterpret_cast<std::size_t *>(block));
+    std::free(block);
+}
+} // namespace
+
+void *operator new(std::size_t size) { return countedAlloc(size); }
+void *operator new[](std::size_t size) { return countedAlloc(size); }
+void operator delete(void *ptr) noexcept { countedFree(ptr); }
+void operator delete[](void *ptr) noexcept { countedFree(ptr); }
+void operator delete(void *ptr, std::size_t) noexcept { countedFree(ptr); }
+void operator delete[](void *ptr, std::size_t) noexcept { countedFree(ptr); }
+
+namespace
+{
+struct LegacyMediaItem
+{
+    std::string type;
+    std::string title;
+    std::string genre;
+    std::string duration;
+    std::string rating;
+    std::string description;
+    std::string accentColor;
+    std::string thumbnailUrl;
+    std::string videoUrl;
+};
+
+struct LegacyMediaCategory
+{
+    std::string name;
+    std::vector<LegacyMediaItem> items;
+};
+
+std::string formatDuration(int minutes)
+{
+    const int hours = minutes / 60;
+    const int mins = minutes % 60;
+    return mins > 0 ? std::to_string(hours) + "h " + std::to_string(mins) + "m" : std::to_string(hours) + "h";
+}
+
+class InMemoryProvider : public IDataProvider
+{
+public:
+    explicit InMemoryProvider(std::vector<CategoryWithItems> categories)
+        : m_categories(std::move(categories))
+    {
+    }
+
+    std::optional<RawMediaItem> fetchFeatured() override { return std::nullopt; }
+    std::vector<CategoryWithItems> fetchCategories() override { return m_categories; }
+
+private:
+    std::vector<CategoryWithItems> m_categories;
+};
+
+std::vector<CategoryWithItems> generate(int titleCount, int genreCount, int maxGenresPerTitle)
+{
+    static const char *kRatings[] = {"G", "PG", "13+", "16+", "18+"};
+    static const char *kColors[] = {"#D81B60", "#29B6F6", "#AB47BC", "#4F46E5", "#F59E0B", "#10B981"};
+    const std::string imagePrefix = "file:///home/nebula/FinalProject/images/";
+    const std::string videoPrefix = "file:///home/nebula/FinalProject/videos/";
+
+    std::vector<CategoryWithItems> categories(static_cast<std::size_t>(genreCount));
+    for (int g = 0; g < genreCount; ++g)
+    {
+        categories[g].category.id = g + 1;
+        categories[g].category.name = "Genre " + std::to_string(g + 1);
+    }
+
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> genrePick(0, genreCount - 1);
+    std::uniform_int_distribution<int> genresPerTitle(1, maxGenresPerTitle);
+    for (int i = 1; i <= titleCount; ++i)
+    {
+        RawMediaItem item;
+        item.id = i;
+        item.type = i % 4 == 0 ? "SERIES" : "MOVIE";
+        item.title = "Synthetic Title " + std::to_string(i);
+        item.description = "A generated description long enough to defeat the small string buffer, title "
+                           + std::to_string(i) + ".";
+        item.rating = kRatings[i % 5];
+        item.durationMinutes = 80 + i % 90;
+        item.accentColor = kColors[i % 6];
+        item.thumbnailUrl = imagePrefix + "title-" + std::to_string(i) + ".jpg";
+        item.videoUrl = videoPrefix + "title-" + std::to_string(i) + ".mp4";
+
+        for (int g = genresPerTitle(rng); g > 0; --g)
+        {
+            auto &category = categories[static_cast<std::size_t>(genrePick(rng))];
+            item.genre = category.category.name;
+            category.items.push_back(item);
+        }
+    }
+    return categories;
+}
+
+std::vector<LegacyMediaCategory> buildLegacy(const std::vector<CategoryWithItems> &categories)
+{
+    std::vector<LegacyMediaCategory> result;
+    result.reserve(categories.size());
+    for (const auto &category : categories)
+    {
+        LegacyMediaCategory legacy;
+        legacy.name = category.category.name;
+        legacy.items.reserve(category.items.size());
+        for (const auto &raw : category.items)
+        {
+            legacy.items.push_back({raw.type, raw.title, raw.genre, formatDuration(raw.durationMinutes), raw.rating,
+                                    raw.description, raw.accentColor, raw.thumbnailUrl, raw.videoUrl});
+        }
+        result.push_back(std::move(legacy));
+    }
+    return result;
+}
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    const int titles = argc > 1 ? std::atoi(argv[1]) : 100000;
+    const int genres = argc > 2 ? std::atoi(argv[2]) : 200;
+    const int maxGenres = argc > 3 ? std::atoi(argv[3]) : 5;
+
+    auto raw = generate(titles, genres, maxGenres);
+    std::size_t rows = 0;
+    for (const auto &category : raw)
+    {
+        rows += category.items.size();
+    }
+
+    const long long beforeLegacy = g_liveBytes.load();
+    auto legacy = buildLegacy(raw);
+    const long long legacyBytes = g_liveBytes.load() - beforeLegacy;
+
+    StreamingService service(std::make_unique<InMemoryProvider>(std::move(raw)));
+    const long long beforeSnapshot = g_liveBytes.load();
+    auto snapshot = service.buildSnapshot();
+    const long long snapshotBytes = g_liveBytes.load() - beforeSnapshot;
+
+    std::printf("catalog memory: %d titles, %d genres, %zu category rows\n", titles, genres, rows);
+    std::printf("  per-row std::string copies  %10.2f MiB  %7.1f bytes/title\n",
+                legacyBytes / 1048576.0, static_cast<double>(legacyBytes) / titles);
+    std::printf("  interned snapshot           %10.2f MiB  %7.1f bytes/title  (%zu records)\n",
+                snapshotBytes / 1048576.0, static_cast<double>(snapshotBytes) / titles, snapshot->items.size());
+    if (snapshotBytes > 0)
+    {
+        std::printf("  reduction                   %.2fx\n", static_cast<double>(legacyBytes) / snapshotBytes);
+    }
+    return 0;
+}
@@ -0,0 +1,906 @@
+// Writes a synthetic streaming.db at production scale: catalog, users, profiles,
+// subscriptions, watch history and My List, with the application's schema from SchemaSql.h.
+// Output depends only on the seed and the options, never on the thread count.
+//
+// Usage: GenerateDataset <out.db> [--seed=1] [--users=1000000] [--titles=20000] [--genres=40]
+//                        [--zipf=1.0] [--genres-per-title=50,30,20] [--profiles=40,30,15,10,5]
+//                        [--watch=12] [--list=6] [--subscribed=0.6] [--password=password]
+//                        [--threads=<cores>] [--batch=500000]
+//
+// --zipf is the exponent of title popularity for watch history and My List picks.
+// --genres-per-title and --profiles are relative weights for 1, 2, 3, ... genres per title and
+// profiles per user. --watch and --list are mean rows per profile. --batch is rows per
+// transaction. Every user gets the same password hash, made once from --password.
+//
+// Workers synthesize users in fixed blocks, each from its own seed, and a single writer
+// inserts the blocks in order, so ids and contents do not depend on scheduling.
+
+#include "../core/PasswordHash.h"
+#include "../shared/SchemaSql.h"
+
+#include <sqlite3.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+namespace
+{
+// Users synthesized per work item.
+constexpr std::uint32_t kBlockUsers = 8192;
+// 2025-06-01 00:00:00 UTC; every timestamp is placed before it so output never depends on the clock.
+constexpr std::int64_t kEndTime = 1748736000;
+constexpr std::int64_t kDay = 86400;
+constexpr std::int64_t kYear = 365 * kDay;
+
+struct Options
+{
+    std::string path;
+    std::uint64_t seed = 1;
+    std::uint32_t users = 1000000;
+    std::uint32_t titles = 20000;
+    std::uint32_t genres = 40;
+    double zipf = 1.0;
+    std::vector<double> genresPerTitle{50, 30, 20};
+    std::vector<double> profilesPerUser{40, 30, 15, 10, 5};
+    double watchMean = 12;
+    double listMean = 6;
+    double subscribed = 0.6;
+    std::string password = "password";
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    std::uint64_t batch = 500000;
+};
+
+// SplitMix64: tiny, fast and fully specified, so a seed means the same data on every platform
+// (the std distributions are not).
+class Random
+{
+public:
+    explicit Random(std::uint64_t seed)
+        : m_state(seed)
+    {
+    }
+
+    std::uint64_t next()
+    {
+        std::uint64_t z = (m_state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    // Uniform in [0, bound).
+    std::uint32_t below(std::uint32_t bound)
+    {
+        return static_cast<std::uint32_t>(((next() >> 32) * bound) >> 32);
+    }
+
+    // Uniform in [0, 1).
+    double unit() { return static_cast<double>(next() >> 11) * 0x1.0p-53; }
+
+    // Geometric count with the given mean.
+    std::uint32_t geometric(double mean)
+    {
+        if (mean <= 0)
+        {
+            return 0;
+        }
+        const double p = 1.0 / (mean + 1.0);
+        return static_cast<std::uint32_t>(std::floor(std::log(1.0 - unit()) / std::log(1.0 - p)));
+    }
+
+private:
+    std::uint64_t m_state;
+};
+
+std::uint64_t streamSeed(std::uint64_t seed, std::uint64_t stream)
+{
+    Random mix(seed ^ (stream * 0xD1B54A32D192ED03ull));
+    return mix.next();
+}
+
+// The one salt every generated user shares, from the seed so the file is reproducible.
+std::string passwordSalt(std::uint64_t seed)
+{
+    Random random(streamSeed(seed, 3));
+    std::string salt(16, '\0');
+    for (std::size_t i = 0; i < salt.size(); i += 8)
+    {
+        const std::uint64_t bits = random.next();
+        for (std::size_t b = 0; b < 8; ++b)
+        {
+            salt[i + b] = static_cast<char>(bits >> (8 * b));
+        }
+    }
+    return salt;
+}
+
+// Picks an index with probability proportional to its weight.
+class WeightedPicker
+{
+public:
+    explicit WeightedPicker(const std::vector<double> &weights)
+    {
+        double total = 0.0;
+        for (const double weight : weights)
+        {
+            total += std::max(0.0, weight);
+            m_cumulative.push_back(total);
+        }
+    }
+
+    std::uint32_t operator()(Random &random) const
+    {
+        const double draw = random.unit() * m_cumulative.back();
+        const auto it = std::upper_bound(m_cumulative.begin(), m_cumulative.end(), draw);
+        return static_cast<std::uint32_t>(std::min<std::size_t>(it - m_cumulative.begin(), m_cumulative.size() - 1));
+    }
+
+private:
+    std::vector<double> m_cumulative;
+};
+
+// Title ids by Zipf popularity rank. Ranks are shuffled over ids so the popular titles are
+// spread through the catalog instead of being the oldest ones.
+class TitlePopularity
+{
+public:
+    TitlePopularity(std::uint32_t titles, double exponent, std::uint64_t seed)
+    {
+        std::vector<double> weights;
+        weights.reserve(titles);
+        for (std::uint32_t rank = 1; rank <= titles; ++rank)
+        {
+            weights.push_back(1.0 / std::pow(static_cast<double>(rank), exponent));
+        }
+        m_picker = std::make_unique<WeightedPicker>(weights);
+
+        m_byRank.resize(titles);
+        for (std::uint32_t i = 0; i < titles; ++i)
+        {
+            m_byRank[i] = static_cast<int>(i) + 1;
+        }
+        Random random(seed);
+        for (std::uint32_t i = titles; i > 1; --i)
+        {
+            std::swap(m_byRank[i - 1], m_byRank[random.below(i)]);
+        }
+    }
+
+    int operator()(Random &random) const { return m_byRank[(*m_picker)(random)]; }
+
+private:
+    std::unique_ptr<WeightedPicker> m_picker;
+    std::vector<int> m_byRank;
+};
+
+std::string formatTime(std::int64_t seconds)
+{
+    // Days to civil date, after Howard Hinnant's days_from_civil inverse.
+    std::int64_t days = seconds / kDay;
+    const std::int64_t secondsOfDay = seconds - days * kDay;
+    days += 719468;
+    const std::int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+    const std::int64_t dayOfEra = days - era * 146097;
+    const std::int64_t yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    const std::int64_t dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    const std::int64_t mp = (5 * dayOfYear + 2) / 153;
+    const int day = static_cast<int>(dayOfYear - (153 * mp + 2) / 5 + 1);
+    const int month = static_cast<int>(mp < 10 ? mp + 3 : mp - 9);
+    const int year = static_cast<int>(yearOfEra + era * 400 + (month <= 2 ? 1 : 0));
+
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%04d-%02d-%02d %02d:%02d:%02d", year, month, day,
+                  static_cast<int>(secondsOfDay / 3600), static_cast<int>(secondsOfDay / 60 % 60),
+                  static_cast<int>(secondsOfDay % 60));
+    return buffer;
+}
+
+std::string formatDate(std::int64_t seconds)
+{
+    return formatTime(seconds).substr(0, 10);
+}
+
+std::int64_t timeBetween(Random &random, std::int64_t from, std::int64_t to)
+{
+    return to > from ? from + static_cast<std::int64_t>(random.unit() * static_cast<double>(to - from)) : from;
+}
+
+std::string word(Random &random)
+{
+    static const char *kSyllables[] = {"ka", "lo", "mi", "ne", "ru", "sa", "ti", "vo", "shi", "dra", "xen",
+                                       "or", "el", "an", "qu", "bri", "th", "zo", "ly", "mar", "gon", "ast"};
+    std::string result;
+    for (std::uint32_t i = 2 + random.below(3); i > 0; --i)
+    {
+        result += kSyllables[random.below(static_cast<std::uint32_t>(std::size(kSyllables)))];
+    }
+    result[0] = static_cast<char>(result[0] - 'a' + 'A');
+    return result;
+}
+
+// ---------------------------------------------------------------------------------------------
+// SQLite helpers
+
+class Statement
+{
+public:
+    Statement(sqlite3 *db, const char *sql)
+    {
+        if (sqlite3_prepare_v2(db, sql, -1, &m_statement, nullptr) != SQLITE_OK)
+        {
+            std::fprintf(stderr, "Unable to prepare %s: %s\n", sql, sqlite3_errmsg(db));
+            std::exit(1);
+        }
+    }
+    ~Statement() { sqlite3_finalize(m_statement); }
+
+    Statement(const Statement &) = delete;
+    Statement &operator=(const Statement &) = delete;
+
+    Statement &bind(int index, std::int64_t value)
+    {
+        sqlite3_bind_int64(m_statement, index, value);
+        return *this;
+    }
+    Statement &bind(int index, double value)
+    {
+        sqlite3_bind_double(m_statement, index, value);
+        return *this;
+    }
+    Statement &bind(int index, const std::string &value)
+    {
+        sqlite3_bind_text(m_statement, index, value.data(), static_cast<int>(value.size()), SQLITE_STATIC);
+        return *this;
+    }
+    Statement &bindNull(int index)
+    {
+        sqlite3_bind_null(m_statement, index);
+        return *this;
+    }
+
+    void run()
+    {
+        if (sqlite3_step(m_statement) != SQLITE_DONE)
+        {
+            std::fprintf(stderr, "Insert failed: %s\n", sqlite3_errmsg(sqlite3_db_handle(m_statement)));
+            std::exit(1);
+        }
+        sqlite3_reset(m_statement);
+    }
+
+private:
+    sqlite3_stmt *m_statement = nullptr;
+};
+
+bool execute(sqlite3 *db, const char *sql)
+{
+    char *error = nullptr;
+    if (sqlite3_exec(db, sql, nullptr, nullptr, &error) != SQLITE_OK)
+    {
+        std::fprintf(stderr, "SQL error: %s while executing %s\n", error ? error : "?", sql);
+        sqlite3_free(error);
+        return false;
+    }
+    return true;
+}
+
+bool scalarIsSet(sqlite3 *db, const char *sql)
+{
+    sqlite3_stmt *statement = nullptr;
+    bool set = false;
+    if (sqlite3_prepare_v2(db, sql, -1, &statement, nullptr) == SQLITE_OK && sqlite3_step(statement) == SQLITE_ROW)
+    {
+        set = sqlite3_column_int64(statement, 0) != 0;
+    }
+    sqlite3_finalize(statement);
+    return set;
+}
+
+// Same steps as Migrations::migrate, without Qt.
+bool createSchema(sqlite3 *db)
+{
+    for (const auto &migration : SchemaSql::migrations())
+    {
+        for (const auto &statement : migration.statements)
+        {
+            if (statement.skipWhen && scalarIsSet(db, statement.skipWhen))
+            {
+                continue;
+            }
+            if (!execute(db, statement.sql))
+            {
+                return false;
+            }
+        }
+        const std::string version = "PRAGMA user_version = " + std::to_string(migration.version);
+        if (!execute(db, version.c_str()))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Secondary indexes on the tables filled per user are dropped for the load and recreated from
+// their saved definitions afterwards; building an index from sorted data once is far cheaper
+// than maintaining it row by row. Returns the CREATE INDEX statements.
+std::vector<std::string> dropUserIndexes(sqlite3 *db)
+{
+    std::vector<std::string> names;
+    std::vector<std::string> definitions;
+    sqlite3_stmt *statement = nullptr;
+    sqlite3_prepare_v2(db,
+                       "SELECT name, sql FROM sqlite_master WHERE type = 'index' AND sql IS NOT NULL AND tbl_name IN "
+                       "('users', 'profiles', 'user_subscriptions', 'watch_history', 'my_list')",
+                       -1, &statement, nullptr);
+    while (sqlite3_step(statement) == SQLITE_ROW)
+    {
+        names.emplace_back(reinterpret_cast<const char *>(sqlite3_column_text(statement, 0)));
+        definitions.emplace_back(reinterpret_cast<const char *>(sqlite3_column_text(statement, 1)));
+    }
+    sqlite3_finalize(statement);
+
+    for (const std::string &name : names)
+    {
+        execute(db, ("DROP INDEX \"" + name + "\"").c_str());
+    }
+    return definitions;
+}
+
+// Commits every batch rows so no single transaction grows without bound.
+class BatchedWriter
+{
+public:
+    BatchedWriter(sqlite3 *db, std::uint64_t batch)
+        : m_db(db)
+        , m_batch(std::max<std::uint64_t>(1, batch))
+    {
+        execute(m_db, "BEGIN");
+    }
+    ~BatchedWriter() { execute(m_db, "COMMIT"); }
+
+    void row()
+    {
+        ++m_rows;
+        if (++m_pending >= m_batch)
+        {
+            execute(m_db, "COMMIT");
+            execute(m_db, "BEGIN");
+            m_pending = 0;
+        }
+    }
+
+    std::uint64_t rows() const { return m_rows; }
+
+private:
+    sqlite3 *m_db;
+    std::uint64_t m_batch;
+    std::uint64_t m_pending = 0;
+    std::uint64_t m_rows = 0;
+};
+
+// ---------------------------------------------------------------------------------------------
+// Catalog
+
+void writeCatalog(sqlite3 *db, const Options &options, BatchedWriter &writer)
+{
+    static const char *kGenreNames[] = {"Action", "Adventure", "Animation", "Comedy", "Crime", "Documentary",
+                                        "Drama", "Family", "Fantasy", "History", "Horror", "Music", "Mystery",
+                                        "Romance", "Sci-Fi", "Sport", "Thriller", "War", "Western", "Anime"};
+    static const char *kRatings[] = {"G", "PG", "13+", "16+", "18+"};
+    static const char *kColors[] = {"#D81B60", "#29B6F6", "#AB47BC", "#4F46E5", "#F59E0B", "#10B981"};
+    const auto genreNameCount = static_cast<std::uint32_t>(std::size(kGenreNames));
+
+    Statement genre(db, "INSERT INTO genres (id, name) VALUES (?, ?)");
+    for (std::uint32_t g = 0; g < options.genres; ++g)
+    {
+        std::string name = kGenreNames[g % genreNameCount];
+        if (g >= genreNameCount)
+        {
+            name += " " + std::to_string(g / genreNameCount + 1);
+        }
+        genre.bind(1, static_cast<std::int64_t>(g + 1)).bind(2, name).run();
+        writer.row();
+    }
+
+    Statement title(db,
+                    "INSERT INTO titles (id, type, name, description, release_year, age_rating, runtime_min, "
+                    "accent_color, created_at) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?)");
+    Statement link(db, "INSERT INTO title_genres (title_id, genre_id) VALUES (?, ?)");
+    Statement media(db, "INSERT INTO media_files (title_id, video_url, thumbnail_url, created_at) VALUES (?, ?, ?, ?)");
+    const WeightedPicker genreCount(options.genresPerTitle);
+    Random random(streamSeed(options.seed, 1));
+    for (std::uint32_t i = 1; i <= options.titles; ++i)
+    {
+        const bool series = random.below(4) == 0;
+        const std::string name = word(random) + " " + word(random);
+        const std::string description = "When " + word(random) + " meets " + word(random) + ", the " + word(random)
+                                        + " crew must decide what " + word(random) + " is worth.";
+        const std::string createdAt = formatTime(timeBetween(random, kEndTime - 10 * kYear, kEndTime - kDay));
+        title.bind(1, static_cast<std::int64_t>(i))
+            .bind(2, std::string(series ? "SERIES" : "MOVIE"))
+            .bind(3, name)
+            .bind(4, description)
+            .bind(5, static_cast<std::int64_t>(1960 + random.below(66)))
+            .bind(6, std::string(kRatings[random.below(5)]))
+            .bind(7, static_cast<std::int64_t>(series ? 20 + random.below(45) : 75 + random.below(90)))
+            .bind(8, std::string(kColors[random.below(6)]))
+            .bind(9, createdAt)
+            .run();
+        writer.row();
+
+        // Distinct genres, so the draw is retried on repeats; the weights' length bounds the count.
+        std::uint32_t wanted = std::min(genreCount(random) + 1, options.genres);
+        std::vector<std::uint32_t> picked;
+        while (picked.size() < wanted)
+        {
+            const std::uint32_t g = random.below(options.genres) + 1;
+            if (std::find(picked.begin(), picked.end(), g) == picked.end())
+            {
+                picked.push_back(g);
+                link.bind(1, static_cast<std::int64_t>(i)).bind(2, static_cast<std::int64_t>(g)).run();
+                writer.row();
+            }
+        }
+
+        const std::string slug = "title-" + std::to_string(i);
+        media.bind(1, static_cast<std::int64_t>(i))
+            .bind(2, "videos/" + slug + ".mp4")
+            .bind(3, "images/" + slug + ".jpg")
+            .bind(4, createdAt)
+            .run();
+        writer.row();
+    }
+
+    execute(db, "INSERT OR IGNORE INTO subscription_plans (id, name, price_month, duration_days, max_profiles, "
+                "max_quality) VALUES (1, 'Basic', 8.99, 30, 1, 'HD'), (2, 'Standard', 12.99, 30, 2, 'FullHD'), "
+                "(3, 'Premium', 15.99, 30, 4, '4K')");
+}
+
+// ---------------------------------------------------------------------------------------------
+// Users and everything hanging off them, synthesized in blocks
+
+struct UserRow
+{
+    std::string email;
+    std::string createdAt;
+};
+
+struct ProfileRow
+{
+    std::uint32_t user{};
+    std::string name;
+    bool kid{};
+    std::string createdAt;
+};
+
+struct SubscriptionRow
+{
+    std::uint32_t user{};
+    std::uint32_t plan{};
+    std::string startDate;
+    std::string endDate;
+    bool active{};
+    std::string createdAt;
+};
+
+struct WatchRow
+{
+    std::uint32_t profile{};
+    int title{};
+    std::uint32_t positionSec{};
+    bool finished{};
+    std::string updatedAt;
+};
+
+struct ListRow
+{
+    std::uint32_t profile{};
+    int title{};
+    std::string addedAt;
+};
+
+// User, profile and subscription numbers are relative to the block.
+struct Block
+{
+    std::uint32_t firstUser{};
+    std::vector<UserRow> users;
+    std::vector<ProfileRow> profiles;
+    std::vector<SubscriptionRow> subscriptions;
+    std::vector<WatchRow> watches;
+    std::vector<ListRow> lists;
+};
+
+class BlockSynthesizer
+{
+public:
+    BlockSynthesizer(const Options &options)
+        : m_options(options)
+        , m_profileCount(options.profilesPerUser)
+        , m_popularity(options.titles, options.zipf, streamSeed(options.seed, 2))
+    {
+    }
+
+    Block make(std::uint32_t blockIndex) const
+    {
+        Block block;
+        block.firstUser = blockIndex * kBlockUsers;
+        const std::uint32_t userCount = std::min(kBlockUsers, m_options.users - block.firstUser);
+        Random random(streamSeed(m_options.seed, 1000 + blockIndex));
+        std::unordered_set<int> seen;
+
+        block.users.reserve(userCount);
+        for (std::uint32_t u = 0; u < userCount; ++u)
+        {
+            const std::int64_t joined = timeBetween(random, kEndTime - 5 * kYear, kEndTime - kDay);
+            block.users.push_back({"user" + std::to_string(block.firstUser + u + 1) + "@example.com", formatTime(joined)});
+
+            if (random.unit() < m_options.subscribed)
+            {
+                const std::int64_t start = timeBetween(random, std::max(joined, kEndTime - kYear), kEndTime);
+                const std::int64_t end = start + 30 * kDay;
+                block.subscriptions.push_back(
+                    {u, random.below(3) + 1, formatDate(start), formatDate(end), end >= kEndTime, formatTime(start)});
+            }
+
+            const std::uint32_t profiles = m_profileCount(random) + 1;
+            for (std::uint32_t p = 0; p < profiles; ++p)
+            {
+                const auto profile = static_cast<std::uint32_t>(block.profiles.size());
+                const std::int64_t created = timeBetween(random, joined, kEndTime);
+                block.profiles.push_back({u, "Profile " + std::to_string(p + 1), p > 0 && random.below(6) == 0,
+                                          formatTime(created)});
+
+                // One row per profile and title, as the unique index requires.
+                const std::uint32_t watches = std::min(random.geometric(m_options.watchMean), m_options.titles / 2);
+                seen.clear();
+                while (seen.size() < watches)
+                {
+                    const int title = m_popularity(random);
+                    if (!seen.insert(title).second)
+                    {
+                        continue;
+                    }
+                    const bool finished = random.below(3) == 0;
+                    block.watches.push_back({profile, title, finished ? 0 : random.below(7200), finished,
+                                             formatTime(timeBetween(random, created, kEndTime))});
+                }
+
+                const std::uint32_t listed = std::min(random.geometric(m_options.listMean), m_options.titles / 2);
+                seen.clear();
+                while (seen.size() < listed)
+                {
+                    const int title = m_popularity(random);
+                    if (seen.insert(title).second)
+                    {
+                        block.lists.push_back({profile, title, formatTime(timeBetween(random, created, kEndTime))});
+                    }
+                }
+            }
+        }
+        return block;
+    }
+
+private:
+    const Options &m_options;
+    WeightedPicker m_profileCount;
+    TitlePopularity m_popularity;
+};
+
+struct Totals
+{
+    std::uint64_t users{};
+    std::uint64_t profiles{};
+    std::uint64_t subscriptions{};
+    std::uint64_t watches{};
+    std::uint64_t lists{};
+};
+
+class BlockWriter
+{
+public:
+    BlockWriter(sqlite3 *db, const std::string &passwordHash, BatchedWriter &writer)
+        : m_passwordHash(passwordHash)
+        , m_writer(writer)
+        , m_user(db, "INSERT INTO users (id, email, password, created_at, role) VALUES (?, ?, ?, ?, 'user')")
+        , m_profile(db, "INSERT INTO profiles (id, user_id, name, avatar_url, is_kid, created_at) VALUES (?, ?, ?, ?, ?, ?)")
+        , m_subscription(db,
+                         "INSERT INTO user_subscriptions (user_id, plan_id, start_date, end_date, is_active, created_at) "
+                         "VALUES (?, ?, ?, ?, ?, ?)")
+        , m_watch(db, "INSERT INTO watch_history (profile_id, title_id, position_sec, is_finished, updated_at) "
+                      "VALUES (?, ?, ?, ?, ?)")
+        , m_list(db, "INSERT INTO my_list (profile_id, title_id, added_at) VALUES (?, ?, ?)")
+    {
+    }
+
+    void write(const Block &block)
+    {
+        const auto userId = [&block](std::uint32_t user) { return static_cast<std::int64_t>(block.firstUser + user + 1); };
+        const std::int64_t firstProfile = static_cast<std::int64_t>(m_totals.profiles) + 1;
+
+        for (std::uint32_t u = 0; u < block.users.size(); ++u)
+        {
+            m_user.bind(1, userId(u)).bind(2, block.users[u].email).bind(3, m_passwordHash).bind(4, block.users[u].createdAt).run();
+            m_writer.row();
+        }
+        for (std::uint32_t p = 0; p < block.profiles.size(); ++p)
+        {
+            const ProfileRow &row = block.profiles[p];
+            m_profile.bind(1, firstProfile + p)
+                .bind(2, userId(row.user))
+                .bind(3, row.name)
+                .bindNull(4)
+                .bind(5, static_cast<std::int64_t>(row.kid))
+                .bind(6, row.createdAt)
+                .run();
+            m_writer.row();
+        }
+        for (const SubscriptionRow &row : block.subscriptions)
+        {
+            m_subscription.bind(1, userId(row.user))
+                .bind(2, static_cast<std::int64_t>(row.plan))
+                .bind(3, row.startDate)
+                .bind(4, row.endDate)
+                .bind(5, static_cast<std::int64_t>(row.active))
+                .bind(6, row.createdAt)
+                .run();
+            m_writer.row();
+        }
+        for (const WatchRow &row : block.watches)
+        {
+            m_watch.bind(1, firstProfile + row.profile)
+                .bind(2, static_cast<std::int64_t>(row.title))
+                .bind(3, static_cast<std::int64_t>(row.positionSec))
+                .bind(4, static_cast<std::int64_t>(row.finished))
+                .bind(5, row.updatedAt)
+                .run();
+            m_writer.row();
+        }
+        for (const ListRow &row : block.lists)
+        {
+            m_list.bind(1, firstProfile + row.profile)
+                .bind(2, static_cast<std::int64_t>(row.title))
+                .bind(3, row.addedAt)
+                .run();
+            m_writer.row();
+        }
+
+        m_totals.users += block.users.size();
+        m_totals.profiles += block.profiles.size();
+        m_totals.subscriptions += block.subscriptions.size();
+        m_totals.watches += block.watches.size();
+        m_totals.lists += block.lists.size();
+    }
+
+    const Totals &totals() const { return m_totals; }
+
+private:
+    const std::string &m_passwordHash;
+    BatchedWriter &m_writer;
+    Statement m_user;
+    Statement m_profile;
+    Statement m_subscription;
+    Statement m_watch;
+    Statement m_list;
+    Totals m_totals;
+};
+
+// Workers take block numbers in turn and hand finished blocks to the writer, which consumes
+// them strictly in order. At most two blocks per worker wait in memory.
+void writeUsers(sqlite3 *db, const Options &options, const std::string &passwordHash, BatchedWriter &writer)
+{
+    const BlockSynthesizer synthesizer(options);
+    const std::uint32_t blockCount = (options.users + kBlockUsers - 1) / kBlockUsers;
+    const std::uint32_t window = 2 * options.threads;
+
+    std::mutex mutex;
+    std::condition_variable ready;
+    std::condition_variable room;
+    std::map<std::uint32_t, Block> done;
+    std::uint32_t nextBlock = 0;
+    std::uint32_t written = 0;
+
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < options.threads; ++t)
+    {
+        workers.emplace_back([&]() {
+            for (;;)
+            {
+                std::uint32_t index = 0;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    room.wait(lock, [&]() { return nextBlock >= blockCount || nextBlock < written + window; });
+                    if (nextBlock >= blockCount)
+                    {
+                        return;
+                    }
+                    index = nextBlock++;
+                }
+                Block block = synthesizer.make(index);
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    done.emplace(index, std::move(block));
+                }
+                ready.notify_one();
+            }
+        });
+    }
+
+    BlockWriter blocks(db, passwordHash, writer);
+    const auto start = std::chrono::steady_clock::now();
+    for (std::uint32_t index = 0; index < blockCount; ++index)
+    {
+        Block block;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            ready.wait(lock, [&]() { return done.count(index) != 0; });
+            block = std::move(done.at(index));
+            done.erase(index);
+        }
+        blocks.write(block);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            written = index + 1;
+        }
+        room.notify_all();
+
+        if (written % 16 == 0 || written == blockCount)
+        {
+            const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            std::fprintf(stderr, "\r  %u/%u blocks, %llu rows, %.0f rows/s", written, blockCount,
+                         static_cast<unsigned long long>(writer.rows()), static_cast<double>(writer.rows()) / seconds);
+        }
+    }
+    std::fprintf(stderr, "\n");
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+
+    const Totals &totals = blocks.totals();
+    std::printf("users %llu, profiles %llu, subscriptions %llu, watch_history %llu, my_list %llu\n",
+                static_cast<unsigned long long>(totals.users), static_cast<unsigned long long>(totals.profiles),
+                static_cast<unsigned long long>(totals.subscriptions), static_cast<unsigned long long>(totals.watches),
+                static_cast<unsigned long long>(totals.lists));
+}
+
+// ---------------------------------------------------------------------------------------------
+// Command line
+
+std::vector<double> parseWeights(const std::string &text)
+{
+    std::vector<double> weights;
+    std::size_t begin = 0;
+    while (begin <= text.size())
+    {
+        const std::size_t end = std::min(text.find(',', begin), text.size());
+        weights.push_back(std::atof(text.substr(begin, end - begin).c_str()));
+        begin = end + 1;
+    }
+    return weights;
+}
+
+bool parse(int argc, char *argv[], Options &options)
+{
+    if (argc < 2 || argv[1][0] == '-')
+    {
+        return false;
+    }
+    options.path = argv[1];
+
+    const auto count = [](const std::string &value) {
+        return static_cast<std::uint32_t>(std::strtoul(value.c_str(), nullptr, 10));
+    };
+    const std::map<std::string, std::function<void(const std::string &)>> setters = {
+        {"seed", [&](const std::string &value) { options.seed = std::strtoull(value.c_str(), nullptr, 10); }},
+        {"users", [&](const std::string &value) { options.users = count(value); }},
+        {"titles", [&](const std::string &value) { options.titles = count(value); }},
+        {"genres", [&](const std::string &value) { options.genres = count(value); }},
+        {"zipf", [&](const std::string &value) { options.zipf = std::atof(value.c_str()); }},
+        {"genres-per-title", [&](const std::string &value) { options.genresPerTitle = parseWeights(value); }},
+        {"profiles", [&](const std::string &value) { options.profilesPerUser = parseWeights(value); }},
+        {"watch", [&](const std::string &value) { options.watchMean = std::atof(value.c_str()); }},
+        {"list", [&](const std::string &value) { options.listMean = std::atof(value.c_str()); }},
+        {"subscribed", [&](const std::string &value) { options.subscribed = std::atof(value.c_str()); }},
+        {"password", [&](const std::string &value) { options.password = value; }},
+        {"threads", [&](const std::string &value) { options.threads = std::max(1u, count(value)); }},
+        {"batch", [&](const std::string &value) { options.batch = std::strtoull(value.c_str(), nullptr, 10); }},
+    };
+    for (int i = 2; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        const std::size_t equals = arg.find('=');
+        if (arg.rfind("--", 0) != 0 || equals == std::string::npos)
+        {
+            return false;
+        }
+        const auto setter = setters.find(arg.substr(2, equals - 2));
+        if (setter == setters.end())
+        {
+            return false;
+        }
+        setter->second(arg.substr(equals + 1));
+    }
+    return options.titles > 0 && options.genres > 0 && !options.genresPerTitle.empty()
+           && !options.profilesPerUser.empty();
+}
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    Options options;
+    if (!parse(argc, argv, options))
+    {
+        std::fprintf(stderr, "Usage: GenerateDataset <out.db> [--seed=N] [--users=N] [--titles=N] [--genres=N] "
+                             "[--zipf=S] [--genres-per-title=w1,w2,...] [--profiles=w1,w2,...] [--watch=MEAN] "
+                             "[--list=MEAN] [--subscribed=FRACTION] [--password=TEXT] [--threads=N] [--batch=ROWS]\n");
+        return 2;
+    }
+    if (std::FILE *existing = std::fopen(options.path.c_str(), "rb"))
+    {
+        std::fclose(existing);
+        std::fprintf(stderr, "%s already exists\n", options.path.c_str());
+        return 1;
+    }
+
+    sqlite3 *db = nullptr;
+    if (sqlite3_open(options.path.c_str(), &db) != SQLITE_OK)
+    {
+        std::fprintf(stderr, "Unable to create %s: %s\n", options.path.c_str(), sqlite3_errmsg(db));
+        return 1;
+    }
+
+    // A half-written file is useless anyway, so durability is traded for load speed.
+    const char *loadPragmas[] = {"PRAGMA journal_mode = OFF", "PRAGMA synchronous = OFF",
+                                 "PRAGMA locking_mode = EXCLUSIVE", "PRAGMA temp_store = MEMORY",
+                                 "PRAGMA cache_size = -262144"};
+    for (const char *pragma : loadPragmas)
+    {
+        execute(db, pragma);
+    }
+    if (!createSchema(db))
+    {
+        sqlite3_close(db);
+        return 1;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    const auto indexes = dropUserIndexes(db);
+    const std::string passwordHash = PasswordHash::hash(options.password, PasswordHash::Cost(), passwordSalt(options.seed));
+    {
+        BatchedWriter writer(db, options.batch);
+        writeCatalog(db, options, writer);
+        std::printf("titles %u, genres %u\n", options.titles, options.genres);
+        writeUsers(db, options, passwordHash, writer);
+    }
+
+    std::fprintf(stderr, "  rebuilding %zu indexes\n", indexes.size());
+    for (const std::string &index : indexes)
+    {
+        execute(db, index.c_str());
+    }
+
+    // Bounded sampling keeps ANALYZE quick even on a very large file.
+    execute(db, "PRAGMA analysis_limit = 1000");
+    execute(db, "ANALYZE");
+    execute(db, "PRAGMA journal_mode = DELETE");
+    sqlite3_close(db);
+
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::printf("wrote %s in %.1f s\n", options.path.c_str(), seconds);
+    return 0;
+}
@@ -0,0 +1,386 @@
+// Google Benchmark suite for the catalog and login hot paths: StreamingService::reload over an
+// in-memory provider, AuthService::authenticate and, when built with Qt, the QtSqlDataProvider
+// queries against generated SQLite catalogs plus the QVariantMap conversion behind
+// Backend::toVariant. Catalog benchmarks run at 1k, 10k and 100k titles.
+//
+// Usage: HotPathBench [--benchmark_filter=<regex>] [--benchmark_out=<file>]
+//                     [--benchmark_out_format=json|console|csv]
+//
+// Keep --benchmark_out JSON files from known-good builds and compare new runs against them
+// with the compare.py script that ships with Google Benchmark.
+
+#include "../core/AuthRepository.h"
+#include "../core/AuthService.h"
+#include "../core/StreamingService.h"
+
+#ifdef HOTPATH_BENCH_WITH_QT
+#include "../backend/Backend.h"
+#include "../backend/CatalogModels.h"
+#include "../shared/ConnectionPool.h"
+#include "../shared/DatabaseUtils.h"
+#include "SqlCatalogFixture.h"
+
+#include <QCoreApplication>
+#include <QTemporaryDir>
+#endif
+
+#include <benchmark/benchmark.h>
+
+#include <cstdio>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <random>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+constexpr int kGenres = 200;
+
+class InMemoryProvider : public IDataProvider
+{
+public:
+    explicit InMemoryProvider(const std::vector<CategoryWithItems> &categories)
+        : m_categories(categories)
+    {
+    }
+
+    std::optional<RawMediaItem> fetchFeatured() override
+    {
+        return m_categories.empty() || m_categories.front().items.empty()
+                   ? std::nullopt
+                   : std::optional<RawMediaItem>(m_categories.front().items.front());
+    }
+    std::vector<CategoryWithItems> fetchCategories() override { return m_categories; }
+
+private:
+    const std::vector<CategoryWithItems> &m_categories;
+};
+
+// Same shape as the SQLite fixture: one to three genres per title, media under shared prefixes.
+std::vector<CategoryWithItems> generate(int titleCount, int genreCount)
+{
+    static const char *kRatings[] = {"G", "PG", "13+", "16+", "18+"};
+    static const char *kColors[] = {"#D81B60", "#29B6F6", "#AB47BC", "#4F46E5", "#F59E0B", "#10B981"};
+    const std::string imagePrefix = "file:///home/nebula/FinalProject/images/";
+    const std::string videoPrefix = "file:///home/nebula/FinalProject/videos/";
+
+    std::vector<CategoryWithItems> categories(static_cast<std::size_t>(genreCount));
+    for (int g = 0; g < genreCount; ++g)
+    {
+        categories[g].category.id = g + 1;
+        categories[g].category.name = "Genre " + std::to_string(g + 1);
+    }
+
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> genrePick(0, genreCount - 1);
+    std::uniform_int_distribution<int> genresPerTitle(1, 3);
+    for (int i = 1; i <= titleCount; ++i)
+    {
+        RawMediaItem item;
+        item.id = i;
+        item.type = i % 4 == 0 ? "SERIES" : "MOVIE";
+        item.title = "Synthetic Title " + std::to_string(i);
+        item.description = "A generated description long enough to defeat the small string buffer, title "
+                           + std::to_string(i) + ".";
+        item.rating = kRatings[i % 5];
+        item.durationMinutes = 80 + i % 90;
+        item.accentColor = kColors[i % 6];
+        item.thumbnailUrl = imagePrefix + "title-" + std::to_string(i) + ".jpg";
+        item.videoUrl = videoPrefix + "title-" + std::to_string(i) + ".mp4";
+
+        for (int g = genresPerTitle(rng); g > 0; --g)
+        {
+            auto &category = categories[static_cast<std::size_t>(genrePick(rng))];
+            item.genre = category.category.name;
+            category.items.push_back(item);
+        }
+    }
+    return categories;
+}
+
+// Generated once per size and kept for the whole run so setup never shows up in a timing.
+const std::vector<CategoryWithItems> &catalog(int titleCount)
+{
+    static std::map<int, std::vector<CategoryWithItems>> catalogs;
+    auto it = catalogs.find(titleCount);
+    if (it == catalogs.end())
+    {
+        it = catalogs.emplace(titleCount, generate(titleCount, kGenres)).first;
+    }
+    return it->second;
+}
+
+std::size_t rowCount(const CatalogSnapshot &snapshot)
+{
+    std::size_t rows = 0;
+    for (const auto &category : snapshot.categories)
+    {
+        rows += category.items.size();
+    }
+    return rows;
+}
+
+void BM_ReloadInMemory(benchmark::State &state)
+{
+    const int titles = static_cast<int>(state.range(0));
+    StreamingService service(std::make_unique<InMemoryProvider>(catalog(titles)));
+    for (auto _ : state)
+    {
+        service.reload();
+        benchmark::DoNotOptimize(service.snapshot().get());
+    }
+    state.SetItemsProcessed(state.iterations() * titles);
+    state.counters["rows"] = static_cast<double>(rowCount(*service.snapshot()));
+}
+BENCHMARK(BM_ReloadInMemory)->Arg(1000)->Arg(10000)->Arg(100000)->Unit(benchmark::kMillisecond);
+
+class InMemoryAuthRepository : public IAuthRepository
+{
+public:
+    bool ensureAdminUser(const std::string &identifier, const std::function<std::string()> &hashPassword) override
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_users.count(identifier) == 0)
+        {
+            insert(identifier, hashPassword(), "admin");
+        }
+        return true;
+    }
+
+    std::optional<StoredUser> findUser(const std::string &identifier) override
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const auto it = m_users.find(identifier);
+        if (it == m_users.end())
+        {
+            return std::nullopt;
+        }
+        return it->second;
+    }
+
+    std::optional<AuthUser> createUser(const std::string &identifier, const std::string &passwordHash) override
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_users.count(identifier) != 0)
+        {
+            return std::nullopt;
+        }
+        return insert(identifier, passwordHash, "user").user;
+    }
+
+    bool updatePasswordHash(int userId, const std::string &passwordHash) override
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (auto &entry : m_users)
+        {
+            if (entry.second.user.userId == userId)
+            {
+                entry.second.passwordHash = passwordHash;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::optional<int> defaultProfile(int userId) override
+    {
+        return userId;
+    }
+
+private:
+    std::mutex m_mutex;
+    std::unordered_map<std::string, StoredUser> m_users;
+
+    const StoredUser &insert(const std::string &identifier, const std::string &passwordHash, const std::string &role)
+    {
+        StoredUser stored;
+        stored.user.identifier = identifier;
+        stored.user.role = role;
+        stored.user.userId = static_cast<int>(m_users.size()) + 1;
+        stored.user.profileId = stored.user.userId;
+        stored.passwordHash = passwordHash;
+        return m_users.emplace(identifier, std::move(stored)).first->second;
+    }
+};
+
+// Successful login at scrypt ln=range(0); the default cost is the one that ships.
+void BM_AuthenticateLogin(benchmark::State &state)
+{
+    PasswordHash::Cost cost;
+    cost.logN = static_cast<std::uint32_t>(state.range(0));
+
+    InMemoryAuthRepository repository;
+    AuthService auth(&repository);
+    auth.setPasswordCost(cost);
+    auth.setLoginLimits({std::numeric_limits<std::uint32_t>::max(), std::chrono::seconds(60)});
+    auth.authenticate("signup", "user", "bench@example.com", "correct horse", "correct horse");
+
+    for (auto _ : state)
+    {
+        const auto result = auth.authenticate("login", "user", "bench@example.com", "correct horse", "");
+        if (!result.session)
+        {
+            state.SkipWithError(result.message.c_str());
+            break;
+        }
+        auth.endSession(result.session->token);
+    }
+}
+BENCHMARK(BM_AuthenticateLogin)->Arg(10)->Arg(PasswordHash::Cost().logN)->Unit(benchmark::kMillisecond);
+
+// Attempts past the limit never reach the repository; this is the cost of turning one away.
+void BM_AuthenticateThrottled(benchmark::State &state)
+{
+    InMemoryAuthRepository repository;
+    AuthService auth(&repository);
+    auth.setLoginLimits({1, std::chrono::seconds(3600)});
+    auth.authenticate("login", "user", "flood@example.com", "guess", "");
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(auth.authenticate("login", "user", "flood@example.com", "guess", ""));
+    }
+}
+BENCHMARK(BM_AuthenticateThrottled);
+
+#ifdef HOTPATH_BENCH_WITH_QT
+// One generated database file per size, switched in by pointing DatabaseUtils at it and
+// dropping the calling thread's pooled connection.
+class SqlCatalogs
+{
+public:
+    bool use(int titleCount)
+    {
+        if (!m_dir.isValid())
+        {
+            return false;
+        }
+        const QString path = m_dir.filePath(QStringLiteral("catalog-%1.db").arg(titleCount));
+        DatabaseUtils::setDatabaseFilePath(path);
+        ConnectionPool::instance().closeThreadConnection();
+        if (m_ready.count(titleCount) != 0)
+        {
+            return true;
+        }
+
+        auto connection = ConnectionPool::instance().acquire();
+        QSqlDatabase db = connection.database();
+        if (!db.isOpen() || !SqlCatalogFixture::populate(db, titleCount, kGenres))
+        {
+            return false;
+        }
+        m_ready.insert(titleCount);
+        return true;
+    }
+
+private:
+    QTemporaryDir m_dir;
+    std::set<int> m_ready;
+};
+
+SqlCatalogs &sqlCatalogs()
+{
+    static SqlCatalogs catalogs;
+    return catalogs;
+}
+
+void BM_SqlFetchCategories(benchmark::State &state)
+{
+    if (!sqlCatalogs().use(static_cast<int>(state.range(0))))
+    {
+        state.SkipWithError("Unable to build benchmark database");
+        return;
+    }
+    auto provider = Backend::createSqlProvider();
+    std::size_t rows = 0;
+    for (auto _ : state)
+    {
+        const auto categories = provider->fetchCategories();
+        rows = 0;
+        for (const auto &category : categories)
+        {
+            rows += category.items.size();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(rows));
+    state.counters["rows"] = static_cast<double>(rows);
+}
+BENCHMARK(BM_SqlFetchCategories)->Arg(1000)->Arg(10000)->Arg(100000)->Unit(benchmark::kMillisecond);
+
+void BM_SqlFetchFeatured(benchmark::State &state)
+{
+    if (!sqlCatalogs().use(static_cast<int>(state.range(0))))
+    {
+        state.SkipWithError("Unable to build benchmark database");
+        return;
+    }
+    auto provider = Backend::createSqlProvider();
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(provider->fetchFeatured());
+    }
+}
+BENCHMARK(BM_SqlFetchFeatured)->Arg(1000)->Arg(10000)->Arg(100000)->Unit(benchmark::kMicrosecond);
+
+// What Backend::reload does on its worker: both queries plus building the snapshot.
+void BM_SqlReload(benchmark::State &state)
+{
+    const int titles = static_cast<int>(state.range(0));
+    if (!sqlCatalogs().use(titles))
+    {
+        state.SkipWithError("Unable to build benchmark database");
+        return;
+    }
+    StreamingService service(Backend::createSqlProvider());
+    for (auto _ : state)
+    {
+        service.reload();
+        benchmark::DoNotOptimize(service.snapshot().get());
+    }
+    state.SetItemsProcessed(state.iterations() * titles);
+    state.counters["rows"] = static_cast<double>(rowCount(*service.snapshot()));
+}
+BENCHMARK(BM_SqlReload)->Arg(1000)->Arg(10000)->Arg(100000)->Unit(benchmark::kMillisecond);
+
+// Converting every category row of the published snapshot, as QML does when it scrolls
+// through the whole catalog.
+void BM_ToVariantMap(benchmark::State &state)
+{
+    StreamingService service(std::make_unique<InMemoryProvider>(catalog(static_cast<int>(state.range(0)))));
+    service.reload();
+    const auto snapshot = service.snapshot();
+    for (auto _ : state)
+    {
+        for (const auto &category : snapshot->categories)
+        {
+            for (const auto index : category.items)
+            {
+                benchmark::DoNotOptimize(toVariantMap(snapshot->item(index), textOf(category.name)));
+            }
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(rowCount(*snapshot)));
+}
+BENCHMARK(BM_ToVariantMap)->Arg(1000)->Arg(10000)->Arg(100000)->Unit(benchmark::kMillisecond);
+#endif
+} // namespace
+
+int main(int argc, char *argv[])
+{
+#ifdef HOTPATH_BENCH_WITH_QT
+    // The SQL driver plugins are only found once an application object exists.
+    QCoreApplication app(argc, argv);
+#endif
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+    {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
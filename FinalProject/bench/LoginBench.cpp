@@ -0,0 +1,158 @@
+// Login throughput through AuthService with scrypt password hashes, against an in-memory
+// repository so only hashing is measured. Reports logins/sec for 1, 2, 4, ... threads up to
+// the hardware concurrency, and per core, to size the auth pool for a given cost.
+//
+// Usage: LoginBench [logN=14] [r=8] [p=1] [seconds=2]
+
+#include "../core/AuthRepository.h"
+#include "../core/AuthService.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+class InMemoryAuthRepository : public IAuthRepository
+{
+public:
+    bool ensureAdminUser(const std::string &identifier, const std::function<std::string()> &hashPassword) override
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_users.count(identifier) == 0)
+        {
+            insert(identifier, hashPassword(), "admin");
+        }
+        return true;
+    }
+
+    std::optional<StoredUser> findUser(const std::string &identifier) override
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const auto it = m_users.find(identifier);
+        if (it == m_users.end())
+        {
+            return std::nullopt;
+        }
+        return it->second;
+    }
+
+    std::optional<AuthUser> createUser(const std::string &identifier, const std::string &passwordHash) override
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_users.count(identifier) != 0)
+        {
+            return std::nullopt;
+        }
+        return insert(identifier, passwordHash, "user").user;
+    }
+
+    bool updatePasswordHash(int userId, const std::string &passwordHash) override
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (auto &entry : m_users)
+        {
+            if (entry.second.user.userId == userId)
+            {
+                entry.second.passwordHash = passwordHash;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::optional<int> defaultProfile(int userId) override
+    {
+        return userId;
+    }
+
+private:
+    std::mutex m_mutex;
+    std::unordered_map<std::string, StoredUser> m_users;
+
+    const StoredUser &insert(const std::string &identifier, const std::string &passwordHash, const std::string &role)
+    {
+        StoredUser stored;
+        stored.user.identifier = identifier;
+        stored.user.role = role;
+        stored.user.userId = static_cast<int>(m_users.size()) + 1;
+        stored.user.profileId = stored.user.userId;
+        stored.passwordHash = passwordHash;
+        return m_users.emplace(identifier, std::move(stored)).first->second;
+    }
+};
+
+std::string userName(unsigned thread)
+{
+    return "user" + std::to_string(thread) + "@example.com";
+}
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    PasswordHash::Cost cost;
+    cost.logN = argc > 1 ? static_cast<std::uint32_t>(std::atoi(argv[1])) : cost.logN;
+    cost.r = argc > 2 ? static_cast<std::uint32_t>(std::atoi(argv[2])) : cost.r;
+    cost.p = argc > 3 ? static_cast<std::uint32_t>(std::atoi(argv[3])) : cost.p;
+    const double seconds = argc > 4 ? std::atof(argv[4]) : 2.0;
+    const unsigned maxThreads = std::max(1u, std::thread::hardware_concurrency());
+
+    InMemoryAuthRepository repository;
+    AuthService auth(&repository);
+    auth.setPasswordCost(cost);
+    // Every thread logs in as the same user over and over; only hashing is being measured.
+    auth.setLoginLimits({std::numeric_limits<std::uint32_t>::max(), std::chrono::seconds(60)});
+    for (unsigned t = 0; t < maxThreads; ++t)
+    {
+        auth.authenticate("signup", "user", userName(t), "correct horse", "correct horse");
+    }
+
+    std::printf("scrypt ln=%u r=%u p=%u: %.1f MiB per hash, %u hardware threads\n", cost.logN, cost.r, cost.p,
+                128.0 * cost.r * static_cast<double>(1ull << cost.logN) / (1024.0 * 1024.0), maxThreads);
+    for (unsigned threads = 1;; threads = std::min(threads * 2, maxThreads))
+    {
+        std::atomic<bool> stop{false};
+        std::atomic<long long> logins{0};
+        std::atomic<long long> failures{0};
+        std::vector<std::thread> workers;
+        const auto start = std::chrono::steady_clock::now();
+        for (unsigned t = 0; t < threads; ++t)
+        {
+            workers.emplace_back([&, t]() {
+                while (!stop.load(std::memory_order_relaxed))
+                {
+                    const auto result = auth.authenticate("login", "user", userName(t), "correct horse", "");
+                    (result.success ? logins : failures).fetch_add(1, std::memory_order_relaxed);
+                    if (result.session)
+                    {
+                        auth.endSession(result.session->token);
+                    }
+                }
+            });
+        }
+        std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+        stop = true;
+        for (auto &worker : workers)
+        {
+            worker.join();
+        }
+        const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        const double perSecond = static_cast<double>(logins.load()) / elapsed;
+        std::printf("  %2u threads: %8.1f logins/s, %7.1f per core, %6.1f ms each%s\n", threads, perSecond,
+                    perSecond / threads, perSecond > 0 ? 1000.0 * threads / perSecond : 0.0,
+                    failures.load() > 0 ? " (failures!)" : "");
+        if (threads == maxThreads)
+        {
+            break;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,220 @@
+// Search latency over a synthetic catalog: as-you-type prefixes, multi-word queries and
+// misspellings, reported as percentiles of single-query wall time.
+//
+// Usage: SearchBench [titles=100000] [queries=20000] [genres=200]
+
+#include "../core/SearchIndex.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+class InMemoryProvider : public IDataProvider
+{
+public:
+    explicit InMemoryProvider(std::vector<CategoryWithItems> categories)
+        : m_categories(std::move(categories))
+    {
+    }
+
+    std::optional<RawMediaItem> fetchFeatured() override { return std::nullopt; }
+    std::vector<CategoryWithItems> fetchCategories() override { return m_categories; }
+
+private:
+    std::vector<CategoryWithItems> m_categories;
+};
+
+std::vector<std::string> makeVocabulary(std::size_t size, std::mt19937 &rng)
+{
+    static const char *kSyllables[] = {"ka", "lo", "mi", "ne", "ru", "sa", "ti", "vo", "shi", "dra", "xen",
+                                       "or",  "el", "an", "qu", "bri", "th", "zo", "ly", "mar", "gon", "ast"};
+    std::uniform_int_distribution<int> syllableCount(2, 4);
+    std::uniform_int_distribution<std::size_t> syllable(0, std::size(kSyllables) - 1);
+    std::vector<std::string> words;
+    words.reserve(size);
+    while (words.size() < size)
+    {
+        std::string word;
+        for (int i = syllableCount(rng); i > 0; --i)
+        {
+            word += kSyllables[syllable(rng)];
+        }
+        words.push_back(std::move(word));
+    }
+    return words;
+}
+
+// Word frequencies in titles follow a rough Zipf curve, as they do in real catalogs.
+class ZipfPicker
+{
+public:
+    ZipfPicker(std::size_t size, double exponent)
+    {
+        m_cumulative.reserve(size);
+        double total = 0.0;
+        for (std::size_t rank = 1; rank <= size; ++rank)
+        {
+            total += 1.0 / std::pow(static_cast<double>(rank), exponent);
+            m_cumulative.push_back(total);
+        }
+    }
+
+    std::size_t operator()(std::mt19937 &rng) const
+    {
+        std::uniform_real_distribution<double> draw(0.0, m_cumulative.back());
+        return static_cast<std::size_t>(std::lower_bound(m_cumulative.begin(), m_cumulative.end(), draw(rng))
+                                        - m_cumulative.begin());
+    }
+
+private:
+    std::vector<double> m_cumulative;
+};
+
+std::string phrase(const std::vector<std::string> &vocabulary, const ZipfPicker &pick, int words, std::mt19937 &rng)
+{
+    std::string text;
+    for (int i = 0; i < words; ++i)
+    {
+        if (i > 0)
+        {
+            text += ' ';
+        }
+        text += vocabulary[pick(rng)];
+    }
+    return text;
+}
+
+std::vector<CategoryWithItems> generate(int titleCount, int genreCount, const std::vector<std::string> &vocabulary,
+                                        std::mt19937 &rng)
+{
+    const ZipfPicker pick(vocabulary.size(), 1.0);
+    std::vector<CategoryWithItems> categories(static_cast<std::size_t>(genreCount));
+    for (int g = 0; g < genreCount; ++g)
+    {
+        categories[g].category.id = g + 1;
+        categories[g].category.name = vocabulary[static_cast<std::size_t>(g)] + " " + vocabulary[static_cast<std::size_t>(g) + 1];
+    }
+
+    std::uniform_int_distribution<int> titleWords(1, 4);
+    std::uniform_int_distribution<int> genrePick(0, genreCount - 1);
+    std::uniform_int_distribution<int> genresPerTitle(1, 3);
+    for (int i = 1; i <= titleCount; ++i)
+    {
+        RawMediaItem item;
+        item.id = i;
+        item.type = i % 4 == 0 ? "series" : "movie";
+        item.title = phrase(vocabulary, pick, titleWords(rng), rng);
+        item.description = phrase(vocabulary, pick, 14, rng);
+        item.durationMinutes = 80 + i % 90;
+        for (int g = genresPerTitle(rng); g > 0; --g)
+        {
+            auto &category = categories[static_cast<std::size_t>(genrePick(rng))];
+            item.genre = category.category.name;
+            category.items.push_back(item);
+        }
+    }
+    return categories;
+}
+
+std::vector<std::string> makeQueries(const CatalogSnapshot &snapshot, int count, std::mt19937 &rng)
+{
+    std::uniform_int_distribution<std::size_t> itemPick(0, snapshot.items.size() - 1);
+    std::uniform_int_distribution<int> kind(0, 3);
+    std::vector<std::string> queries;
+    queries.reserve(static_cast<std::size_t>(count));
+    while (queries.size() < static_cast<std::size_t>(count))
+    {
+        const auto words = SearchIndex::tokenize(snapshot.item(static_cast<std::uint32_t>(itemPick(rng))).title);
+        if (words.empty())
+        {
+            continue;
+        }
+        const std::string &word = words.front();
+        switch (kind(rng))
+        {
+        case 0:
+        {
+            // As-you-type: every prefix length is equally likely, including one character.
+            std::uniform_int_distribution<std::size_t> length(1, word.size());
+            queries.push_back(word.substr(0, length(rng)));
+            break;
+        }
+        case 1:
+            queries.push_back(word);
+            break;
+        case 2:
+        {
+            std::string typo = word;
+            std::uniform_int_distribution<std::size_t> position(0, typo.size() - 1);
+            typo[position(rng)] = 'z';
+            queries.push_back(typo);
+            break;
+        }
+        default:
+        {
+            std::string multi;
+            for (const auto &part : words)
+            {
+                multi += part + ' ';
+            }
+            multi.pop_back();
+            queries.push_back(multi.substr(0, multi.size() - multi.size() / 4));
+            break;
+        }
+        }
+    }
+    return queries;
+}
+
+double percentile(std::vector<double> sorted, double p)
+{
+    const auto index = static_cast<std::size_t>(p * static_cast<double>(sorted.size() - 1));
+    return sorted[index];
+}
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    const int titles = argc > 1 ? std::atoi(argv[1]) : 100000;
+    const int queryCount = argc > 2 ? std::atoi(argv[2]) : 20000;
+    const int genres = argc > 3 ? std::atoi(argv[3]) : 200;
+
+    std::mt19937 rng(42);
+    const auto vocabulary = makeVocabulary(20000, rng);
+    StreamingService service(std::make_unique<InMemoryProvider>(generate(titles, genres, vocabulary, rng)));
+    const auto snapshot = service.buildSnapshot();
+
+    const auto buildStart = std::chrono::steady_clock::now();
+    const SearchIndex index(snapshot);
+    const double buildMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - buildStart).count();
+
+    const auto queries = makeQueries(*snapshot, queryCount, rng);
+    // One untimed pass first, so page faults on the freshly built index are not counted.
+    for (const auto &query : queries)
+    {
+        index.search(query, 20);
+    }
+    std::vector<double> micros;
+    micros.reserve(queries.size());
+    std::size_t totalHits = 0;
+    for (const auto &query : queries)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        totalHits += index.search(query, 20).size();
+        micros.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+    }
+    std::sort(micros.begin(), micros.end());
+
+    std::printf("search: %zu titles, %zu terms, index built in %.1f ms\n", snapshot->items.size(), index.termCount(), buildMs);
+    std::printf("  %zu queries, %.1f hits/query\n", queries.size(), static_cast<double>(totalHits) / queries.size());
+    std::printf("  p50 %8.1f us\n  p90 %8.1f us\n  p99 %8.1f us\n  max %8.1f us\n", percentile(micros, 0.50),
+                percentile(micros, 0.90), percentile(micros, 0.99), micros.back());
+    return 0;
+}
@@ -0,0 +1,93 @@
+#include "SqlCatalogFixture.h"
+
+#include <QSqlError>
+#include <QSqlQuery>
+
+#include <cstdio>
+#include <random>
+
+namespace
+{
+bool exec(QSqlDatabase &db, const QString &sql)
+{
+    QSqlQuery query(db);
+    if (!query.exec(sql))
+    {
+        std::fprintf(stderr, "SQL error: %s\n", qPrintable(query.lastError().text()));
+        return false;
+    }
+    return true;
+}
+} // namespace
+
+namespace SqlCatalogFixture
+{
+bool populate(QSqlDatabase &db, int titleCount, int genreCount)
+{
+    const char *schema[] = {
+        "CREATE TABLE IF NOT EXISTS titles (id INTEGER PRIMARY KEY AUTOINCREMENT, type TEXT NOT NULL, name TEXT NOT NULL, "
+        "description TEXT, release_year INTEGER, age_rating TEXT, runtime_min INTEGER, accent_color TEXT, "
+        "created_at TEXT NOT NULL DEFAULT (datetime('now')))",
+        "CREATE TABLE IF NOT EXISTS genres (id INTEGER PRIMARY KEY AUTOINCREMENT, name TEXT NOT NULL UNIQUE)",
+        "CREATE TABLE IF NOT EXISTS title_genres (title_id INTEGER NOT NULL, genre_id INTEGER NOT NULL, "
+        "PRIMARY KEY (title_id, genre_id))",
+        "CREATE TABLE IF NOT EXISTS media_files (id INTEGER PRIMARY KEY AUTOINCREMENT, title_id INTEGER NOT NULL, "
+        "video_url TEXT NOT NULL, thumbnail_url TEXT NOT NULL, created_at TEXT NOT NULL DEFAULT (datetime('now')))",
+    };
+    for (const char *statement : schema)
+    {
+        if (!exec(db, QString::fromLatin1(statement)))
+        {
+            return false;
+        }
+    }
+
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> genrePick(1, genreCount);
+    std::uniform_int_distribution<int> genresPerTitle(1, 3);
+
+    db.transaction();
+
+    QSqlQuery genre(db);
+    genre.prepare(QStringLiteral("INSERT INTO genres (name) VALUES (?)"));
+    for (int i = 1; i <= genreCount; ++i)
+    {
+        genre.addBindValue(QStringLiteral("Genre %1").arg(i, 4, 10, QLatin1Char('0')));
+        genre.exec();
+    }
+
+    QSqlQuery title(db);
+    title.prepare(QStringLiteral(
+        "INSERT INTO titles (type, name, description, age_rating, runtime_min, accent_color, created_at) "
+        "VALUES (?, ?, ?, '13+', ?, '#4F46E5', datetime('2024-01-01', ?))"));
+    QSqlQuery link(db);
+    link.prepare(QStringLiteral("INSERT OR IGNORE INTO title_genres (title_id, genre_id) VALUES (?, ?)"));
+    QSqlQuery media(db);
+    media.prepare(QStringLiteral("INSERT INTO media_files (title_id, video_url, thumbnail_url) VALUES (?, ?, ?)"));
+
+    for (int i = 1; i <= titleCount; ++i)
+    {
+        title.addBindValue(i % 4 == 0 ? QStringLiteral("SERIES") : QStringLiteral("MOVIE"));
+        title.addBindValue(QStringLiteral("Title %1").arg(i));
+        title.addBindValue(QStringLiteral("Synthetic description for title %1.").arg(i));
+        title.addBindValue(80 + i % 90);
+        title.addBindValue(QStringLiteral("+%1 minutes").arg(i));
+        title.exec();
+
+        const int titleId = title.lastInsertId().toInt();
+        for (int g = genresPerTitle(rng); g > 0; --g)
+        {
+            link.addBindValue(titleId);
+            link.addBindValue(genrePick(rng));
+            link.exec();
+        }
+
+        media.addBindValue(titleId);
+        media.addBindValue(QStringLiteral("videos/title-%1.mp4").arg(i));
+        media.addBindValue(QStringLiteral("images/title-%1.jpg").arg(i));
+        media.exec();
+    }
+
+    return db.commit();
+}
+}
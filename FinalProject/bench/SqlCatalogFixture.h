@@ -0,0 +1,12 @@
+#pragma once
+
+#include <QSqlDatabase>
+
+// Synthetic catalog shared by the SQLite benchmarks.
+namespace SqlCatalogFixture
+{
+// Creates the catalog tables unless they exist, as in a migrated database, and fills them
+// with titleCount titles spread over genreCount genres, one to three genres and one media
+// file per title. The tables are expected to be empty.
+bool populate(QSqlDatabase &db, int titleCount, int genreCount);
+}
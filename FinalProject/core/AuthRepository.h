@@ -1,5 +1,6 @@
 #pragma once
 
+#include <functional>
 #include <optional>
 #include <string>
 
@@ -7,6 +8,16 @@ struct AuthUser
 {
     std::string identifier;
     std::string role;
+    int userId{};
+    // The profile actions are recorded against until profiles can be switched.
+    int profileId{};
+};
+
+struct StoredUser
+{
+    AuthUser user;
+    // An encoded PasswordHash, or the plaintext password of a row created before hashing.
+    std::string passwordHash;
 };
 
 class IAuthRepository
@@ -14,7 +25,12 @@ class IAuthRepository
 public:
     virtual ~IAuthRepository() = default;
 
-    virtual bool ensureAdminUser(const std::string &identifier, const std::string &password) = 0;
-    virtual std::optional<AuthUser> findUser(const std::string &identifier, const std::string &password) = 0;
-    virtual std::optional<AuthUser> createUser(const std::string &identifier, const std::string &password) = 0;
+    // Creates the admin account if it is missing. hashPassword is only called when it is.
+    virtual bool ensureAdminUser(const std::string &identifier, const std::function<std::string()> &hashPassword) = 0;
+    // Reads the user row only; user.profileId is left unset until the password checks out.
+    virtual std::optional<StoredUser> findUser(const std::string &identifier) = 0;
+    virtual std::optional<AuthUser> createUser(const std::string &identifier, const std::string &passwordHash) = 0;
+    virtual bool updatePasswordHash(int userId, const std::string &passwordHash) = 0;
+    // The user's first profile, created if they have none yet.
+    virtual std::optional<int> defaultProfile(int userId) = 0;
 };
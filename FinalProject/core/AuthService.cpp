@@ -6,6 +6,9 @@
 
 namespace
 {
+// Length of a stored derived key; see PasswordHash::hash.
+constexpr std::size_t kDerivedKeySize = 32;
+
 bool isEmpty(const std::string &value)
 {
     return std::all_of(value.begin(), value.end(), [](unsigned char ch) { return std::isspace(ch) != 0; }) || value.empty();
@@ -22,11 +25,36 @@ void AuthService::setRepository(IAuthRepository *repository)
     m_repository = repository;
 }
 
+void AuthService::setPasswordCost(const PasswordHash::Cost &cost)
+{
+    m_passwordCost = cost;
+}
+
+const PasswordHash::Cost &AuthService::passwordCost() const
+{
+    return m_passwordCost;
+}
+
+void AuthService::setLoginLimits(const LoginRateLimits &limits)
+{
+    m_loginLimiter.setLimits(limits);
+}
+
+LoginRateLimiterStats AuthService::loginStats() const
+{
+    return m_loginLimiter.stats();
+}
+
+void AuthService::setSessionLimits(const SessionLimits &limits)
+{
+    m_sessions.setLimits(limits);
+}
+
 AuthResult AuthService::authenticate(const std::string &mode,
                                      const std::string &role,
                                      const std::string &identifier,
                                      const std::string &password,
-                                     const std::string &confirmPassword) const
+                                     const std::string &confirmPassword)
 {
     AuthResult result;
 
@@ -51,9 +79,16 @@ AuthResult AuthService::authenticate(const std::string &mode,
         return result;
     }
 
+    if (!m_loginLimiter.tryAcquire(identifier))
+    {
+        result.success = false;
+        result.message = "Too many attempts. Please try again later.";
+        return result;
+    }
+
     if (mode == "signup")
     {
-        auto created = m_repository->createUser(identifier, password);
+        auto created = m_repository->createUser(identifier, PasswordHash::hash(password, m_passwordCost));
         if (!created.has_value())
         {
             result.success = false;
@@ -63,19 +98,60 @@ AuthResult AuthService::authenticate(const std::string &mode,
         result.success = true;
         result.role = created->role;
         result.message = "Account created.";
+        result.session = m_sessions.open({{}, created->identifier, created->role, created->userId, created->profileId});
         return result;
     }
 
-    auto user = m_repository->findUser(identifier, password);
-    if (!user.has_value())
+    auto stored = m_repository->findUser(identifier);
+    if (!stored.has_value())
     {
+        // Derive anyway, at the cost a stored hash has, so a miss takes as long as a wrong
+        // password and response times do not reveal which accounts exist.
+        PasswordHash::scrypt(password, "unknown account", m_passwordCost, kDerivedKeySize);
         result.success = false;
         result.message = "Invalid credentials.";
         return result;
     }
+    if (!PasswordHash::verify(password, stored->passwordHash))
+    {
+        result.success = false;
+        result.message = "Invalid credentials.";
+        return result;
+    }
+    if (PasswordHash::needsRehash(stored->passwordHash, m_passwordCost))
+    {
+        // Legacy plaintext rows and outdated costs are upgraded while the password is at
+        // hand; a failed update only means trying again next time.
+        m_repository->updatePasswordHash(stored->user.userId, PasswordHash::hash(password, m_passwordCost));
+    }
+
+    AuthUser &user = stored->user;
+    const auto profileId = m_repository->defaultProfile(user.userId);
+    if (!profileId.has_value())
+    {
+        result.success = false;
+        result.message = "Unable to load profile.";
+        return result;
+    }
+    user.profileId = *profileId;
 
     result.success = true;
-    result.role = user->role;
+    result.role = user.role;
     result.message = "Authenticated as " + result.role;
+    result.session = m_sessions.open({{}, user.identifier, user.role, user.userId, user.profileId});
     return result;
 }
+
+std::optional<Session> AuthService::session(const std::string &token) const
+{
+    if (token.empty())
+    {
+        return std::nullopt;
+    }
+    return m_sessions.find(token);
+}
+
+void AuthService::endSession(const std::string &token)
+{
+    m_sessions.close(token);
+}
@@ -1,5 +1,10 @@
 #pragma once
 
+#include "LoginRateLimiter.h"
+#include "PasswordHash.h"
+#include "SessionStore.h"
+
+#include <optional>
 #include <string>
 
 struct AuthResult
@@ -7,6 +12,8 @@ struct AuthResult
     bool success{};
     std::string message;
     std::string role;
+    // Set when the user is signed in.
+    std::optional<Session> session;
 };
 
 class IAuthRepository;
@@ -18,12 +25,30 @@ public:
 
     void setRepository(IAuthRepository *repository);
 
+    // Cost for new hashes; stored hashes with another cost are redone at their next
+    // successful login. Set before authenticating from several threads.
+    void setPasswordCost(const PasswordHash::Cost &cost);
+    const PasswordHash::Cost &passwordCost() const;
+
+    // Attempts per identifier, checked before the repository or any hashing is touched.
+    void setLoginLimits(const LoginRateLimits &limits);
+    LoginRateLimiterStats loginStats() const;
+
     AuthResult authenticate(const std::string &mode,
                             const std::string &role,
                             const std::string &identifier,
                             const std::string &password,
-                            const std::string &confirmPassword) const;
+                            const std::string &confirmPassword);
+
+    // Idle expiry and the cap on live sessions.
+    void setSessionLimits(const SessionLimits &limits);
+
+    std::optional<Session> session(const std::string &token) const;
+    void endSession(const std::string &token);
 
 private:
     IAuthRepository *m_repository;
+    PasswordHash::Cost m_passwordCost;
+    LoginRateLimiter m_loginLimiter;
+    SessionStore m_sessions;
 };
@@ -0,0 +1,347 @@
+#include "CatalogSnapshotFile.h"
+
+#include <cstring>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+constexpr char kMagic[8] = {'F', 'P', 'C', 'A', 'T', 'S', 'N', 'P'};
+constexpr std::uint32_t kByteOrder = 0x01020304;
+constexpr std::uint32_t kNone = 0xFFFFFFFF;
+
+struct Header
+{
+    char magic[8];
+    std::uint32_t byteOrder;
+    std::uint32_t formatVersion;
+    std::uint64_t catalogVersion;
+    std::uint32_t fileSize;
+    // FNV-1a over everything after the header.
+    std::uint32_t checksum;
+    std::uint32_t origin;
+    std::uint32_t featured;
+    std::uint32_t stringCount;
+    std::uint32_t strings;
+    std::uint32_t itemCount;
+    std::uint32_t items;
+    std::uint32_t categoryCount;
+    std::uint32_t categories;
+    std::uint32_t rowEntryCount;
+    std::uint32_t rowEntries;
+    std::uint32_t textSize;
+    std::uint32_t text;
+};
+
+struct StringRecord
+{
+    std::uint32_t offset;
+    std::uint32_t length;
+};
+
+struct ItemRecord
+{
+    std::int32_t id;
+    std::uint32_t type;
+    std::uint32_t title;
+    std::uint32_t genre;
+    std::uint32_t duration;
+    std::uint32_t rating;
+    std::uint32_t description;
+    std::uint32_t accentColor;
+    std::uint32_t thumbnailPrefix;
+    std::uint32_t thumbnailPath;
+    std::uint32_t videoPrefix;
+    std::uint32_t videoPath;
+};
+
+struct CategoryRecord
+{
+    std::int32_t id;
+    std::uint32_t name;
+    std::uint32_t first;
+    std::uint32_t count;
+};
+
+static_assert(std::is_trivially_copyable_v<Header> && sizeof(Header) % 8 == 0);
+static_assert(sizeof(ItemRecord) % 4 == 0 && sizeof(CategoryRecord) % 4 == 0);
+
+std::uint32_t fnv1a(const char *data, std::size_t size)
+{
+    std::uint32_t hash = 2166136261u;
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+class StringTable
+{
+public:
+    std::uint32_t add(std::string_view value)
+    {
+        const auto [it, inserted] = m_ids.try_emplace(value, static_cast<std::uint32_t>(m_records.size()));
+        if (inserted)
+        {
+            m_records.push_back({static_cast<std::uint32_t>(m_text.size()), static_cast<std::uint32_t>(value.size())});
+            m_text.append(value);
+        }
+        return it->second;
+    }
+
+    std::uint32_t add(const SharedString &value) { return value ? add(std::string_view(*value)) : kNone; }
+
+    const std::vector<StringRecord> &records() const { return m_records; }
+    const std::string &text() const { return m_text; }
+
+private:
+    // Keys view into the snapshot being written, which outlives the table.
+    std::unordered_map<std::string_view, std::uint32_t> m_ids;
+    std::vector<StringRecord> m_records;
+    std::string m_text;
+};
+
+template <typename T>
+std::uint32_t append(std::string &out, const std::vector<T> &records)
+{
+    const auto offset = static_cast<std::uint32_t>(out.size());
+    out.append(reinterpret_cast<const char *>(records.data()), records.size() * sizeof(T));
+    return offset;
+}
+
+void alignTo4(std::string &out)
+{
+    out.resize((out.size() + 3) & ~std::size_t(3), '\0');
+}
+
+// Bounds-checked view over the mapped bytes; records are copied out rather than cast in
+// place so a misaligned or truncated file cannot cause undefined behaviour.
+class Reader
+{
+public:
+    Reader(const char *data, std::size_t size)
+        : m_data(data)
+        , m_size(size)
+    {
+    }
+
+    bool contains(std::uint64_t offset, std::uint64_t count, std::uint64_t recordSize) const
+    {
+        return offset <= m_size && count <= (m_size - offset) / recordSize;
+    }
+
+    template <typename T>
+    T at(std::uint32_t offset, std::uint32_t index) const
+    {
+        T value;
+        std::memcpy(&value, m_data + offset + std::size_t(index) * sizeof(T), sizeof(T));
+        return value;
+    }
+
+private:
+    const char *m_data;
+    std::size_t m_size;
+};
+} // namespace
+
+namespace CatalogSnapshotFile
+{
+std::string serialize(const CatalogSnapshot &snapshot, std::uint64_t catalogVersion, std::string_view origin)
+{
+    StringTable strings;
+    Header header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.byteOrder = kByteOrder;
+    header.formatVersion = kFormatVersion;
+    header.catalogVersion = catalogVersion;
+    header.origin = strings.add(origin);
+    header.featured = snapshot.featured ? *snapshot.featured : kNone;
+
+    std::vector<ItemRecord> items;
+    items.reserve(snapshot.items.size());
+    for (const auto &item : snapshot.items)
+    {
+        ItemRecord record{};
+        record.id = item->id;
+        record.type = strings.add(item->type);
+        record.title = strings.add(item->title);
+        record.genre = strings.add(item->genre);
+        record.duration = strings.add(item->duration);
+        record.rating = strings.add(item->rating);
+        record.description = strings.add(item->description);
+        record.accentColor = strings.add(item->accentColor);
+        record.thumbnailPrefix = strings.add(item->thumbnailUrl.prefix);
+        record.thumbnailPath = strings.add(item->thumbnailUrl.path);
+        record.videoPrefix = strings.add(item->videoUrl.prefix);
+        record.videoPath = strings.add(item->videoUrl.path);
+        items.push_back(record);
+    }
+
+    std::vector<CategoryRecord> categories;
+    std::vector<std::uint32_t> rowEntries;
+    categories.reserve(snapshot.categories.size());
+    for (const auto &category : snapshot.categories)
+    {
+        categories.push_back({category.id, strings.add(category.name), static_cast<std::uint32_t>(rowEntries.size()),
+                              static_cast<std::uint32_t>(category.items.size())});
+        rowEntries.insert(rowEntries.end(), category.items.begin(), category.items.end());
+    }
+
+    std::string out(sizeof(Header), '\0');
+    header.stringCount = static_cast<std::uint32_t>(strings.records().size());
+    header.strings = append(out, strings.records());
+    header.itemCount = static_cast<std::uint32_t>(items.size());
+    header.items = append(out, items);
+    header.categoryCount = static_cast<std::uint32_t>(categories.size());
+    header.categories = append(out, categories);
+    header.rowEntryCount = static_cast<std::uint32_t>(rowEntries.size());
+    header.rowEntries = append(out, rowEntries);
+    header.textSize = static_cast<std::uint32_t>(strings.text().size());
+    header.text = static_cast<std::uint32_t>(out.size());
+    out.append(strings.text());
+    alignTo4(out);
+
+    header.fileSize = static_cast<std::uint32_t>(out.size());
+    header.checksum = fnv1a(out.data() + sizeof(Header), out.size() - sizeof(Header));
+    std::memcpy(out.data(), &header, sizeof(Header));
+    return out;
+}
+
+std::optional<Decoded> deserialize(const char *data, std::size_t size, std::string_view origin)
+{
+    if (!data || size < sizeof(Header))
+    {
+        return std::nullopt;
+    }
+
+    Header header;
+    std::memcpy(&header, data, sizeof(Header));
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.byteOrder != kByteOrder
+        || header.formatVersion != kFormatVersion || header.fileSize != size
+        || header.checksum != fnv1a(data + sizeof(Header), size - sizeof(Header)))
+    {
+        return std::nullopt;
+    }
+
+    const Reader reader(data, size);
+    if (!reader.contains(header.strings, header.stringCount, sizeof(StringRecord))
+        || !reader.contains(header.items, header.itemCount, sizeof(ItemRecord))
+        || !reader.contains(header.categories, header.categoryCount, sizeof(CategoryRecord))
+        || !reader.contains(header.rowEntries, header.rowEntryCount, sizeof(std::uint32_t))
+        || !reader.contains(header.text, header.textSize, 1))
+    {
+        return std::nullopt;
+    }
+
+    std::vector<std::string_view> text(header.stringCount);
+    for (std::uint32_t i = 0; i < header.stringCount; ++i)
+    {
+        const auto record = reader.at<StringRecord>(header.strings, i);
+        if (std::uint64_t(record.offset) + record.length > header.textSize)
+        {
+            return std::nullopt;
+        }
+        text[i] = std::string_view(data + header.text + record.offset, record.length);
+    }
+
+    if (header.origin >= header.stringCount || text[header.origin] != origin)
+    {
+        return std::nullopt;
+    }
+
+    auto snapshot = std::make_shared<CatalogSnapshot>();
+    snapshot->strings = std::make_shared<StringPool>();
+    StringPool &pool = *snapshot->strings;
+    // Shared fields are interned once per string id, so records keep sharing them.
+    std::vector<SharedString> shared(header.stringCount);
+    bool valid = true;
+    const auto plain = [&](std::uint32_t id) {
+        if (id == kNone)
+        {
+            return std::string();
+        }
+        if (id >= header.stringCount)
+        {
+            valid = false;
+            return std::string();
+        }
+        return std::string(text[id]);
+    };
+    const auto sharedAt = [&](std::uint32_t id) -> SharedString {
+        if (id == kNone)
+        {
+            return nullptr;
+        }
+        if (id >= header.stringCount)
+        {
+            valid = false;
+            return nullptr;
+        }
+        if (!shared[id])
+        {
+            shared[id] = pool.intern(text[id]);
+        }
+        return shared[id];
+    };
+
+    snapshot->items.reserve(header.itemCount);
+    for (std::uint32_t i = 0; i < header.itemCount && valid; ++i)
+    {
+        const auto record = reader.at<ItemRecord>(header.items, i);
+        MediaItem item;
+        item.id = record.id;
+        item.type = sharedAt(record.type);
+        item.title = plain(record.title);
+        item.genre = sharedAt(record.genre);
+        item.duration = sharedAt(record.duration);
+        item.rating = sharedAt(record.rating);
+        item.description = plain(record.description);
+        item.accentColor = sharedAt(record.accentColor);
+        item.thumbnailUrl.prefix = sharedAt(record.thumbnailPrefix);
+        item.thumbnailUrl.path = plain(record.thumbnailPath);
+        item.videoUrl.prefix = sharedAt(record.videoPrefix);
+        item.videoUrl.path = plain(record.videoPath);
+        snapshot->items.push_back(std::make_shared<const MediaItem>(std::move(item)));
+    }
+
+    snapshot->categories.reserve(header.categoryCount);
+    for (std::uint32_t i = 0; i < header.categoryCount && valid; ++i)
+    {
+        const auto record = reader.at<CategoryRecord>(header.categories, i);
+        if (std::uint64_t(record.first) + record.count > header.rowEntryCount)
+        {
+            return std::nullopt;
+        }
+
+        MediaCategory category;
+        category.id = record.id;
+        category.name = sharedAt(record.name);
+        category.items.reserve(record.count);
+        for (std::uint32_t entry = 0; entry < record.count; ++entry)
+        {
+            const auto index = reader.at<std::uint32_t>(header.rowEntries, record.first + entry);
+            valid = valid && index < header.itemCount;
+            category.items.push_back(index);
+        }
+        snapshot->categories.push_back(std::move(category));
+    }
+
+    if (header.featured != kNone)
+    {
+        valid = valid && header.featured < header.itemCount;
+        snapshot->featured = header.featured;
+    }
+    if (!valid)
+    {
+        return std::nullopt;
+    }
+
+    Decoded decoded;
+    decoded.snapshot = std::move(snapshot);
+    decoded.catalogVersion = header.catalogVersion;
+    return decoded;
+}
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "StreamingService.h"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+// Flat on-disk form of a CatalogSnapshot, meant to be memory-mapped at startup so the UI can
+// show the last catalog before the database has been read. Everything is addressed by
+// offsets from the start of the file: a header, a string table (every distinct string once),
+// fixed-size item and category records holding string ids, and one array of row entries.
+// The header carries the provider's catalog version the snapshot was built from.
+namespace CatalogSnapshotFile
+{
+constexpr std::uint32_t kFormatVersion = 1;
+
+struct Decoded
+{
+    StreamingService::Snapshot snapshot;
+    std::uint64_t catalogVersion = 0;
+};
+
+// origin identifies what the snapshot's URLs were resolved against; a file written for a
+// different origin is rejected.
+std::string serialize(const CatalogSnapshot &snapshot, std::uint64_t catalogVersion, std::string_view origin);
+
+// Returns nothing unless data is a complete, intact snapshot of this format and origin.
+std::optional<Decoded> deserialize(const char *data, std::size_t size, std::string_view origin);
+}
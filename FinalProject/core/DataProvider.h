@@ -7,6 +7,7 @@
 
 struct RawMediaItem
 {
+    int id{};
     std::string type;
     std::string title;
     std::string genre;
@@ -30,6 +31,12 @@ struct CategoryWithItems
     std::vector<RawMediaItem> items;
 };
 
+struct TitleWithGenres
+{
+    RawMediaItem item;
+    std::vector<RawCategory> genres;
+};
+
 class IDataProvider
 {
 public:
@@ -37,4 +44,8 @@ public:
 
     virtual std::optional<RawMediaItem> fetchFeatured() = 0;
     virtual std::vector<CategoryWithItems> fetchCategories() = 0;
+
+    // A counter that changes whenever anything the catalog is built from changes. Providers
+    // without one return nothing, and their catalogs are never cached across runs.
+    virtual std::optional<std::uint64_t> catalogVersion() { return std::nullopt; }
 };
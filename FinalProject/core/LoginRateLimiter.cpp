@@ -0,0 +1,104 @@
+#include "LoginRateLimiter.h"
+
+#include <algorithm>
+#include <cctype>
+#include <limits>
+
+namespace
+{
+// One independent 64-bit hash per row, from FNV-1a over the case-folded key with a row seed.
+std::uint64_t rowHash(std::string_view key, std::uint64_t row)
+{
+    std::uint64_t hash = 1469598103934665603ull ^ (row * 0x9E3779B97F4A7C15ull);
+    for (const char c : key)
+    {
+        hash ^= static_cast<unsigned char>(std::tolower(static_cast<unsigned char>(c)));
+        hash *= 1099511628211ull;
+    }
+    // FNV's low bits mix poorly; fold the high half in before taking a bucket.
+    return hash ^ (hash >> 29);
+}
+} // namespace
+
+LoginRateLimiter::LoginRateLimiter(LoginRateLimits limits)
+    : m_limits(limits)
+{
+}
+
+bool LoginRateLimiter::tryAcquire(std::string_view key, Clock::time_point now)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    advance(now);
+
+    std::array<std::size_t, kDepth> buckets;
+    std::uint32_t current = std::numeric_limits<std::uint32_t>::max();
+    std::uint32_t previous = std::numeric_limits<std::uint32_t>::max();
+    for (std::size_t row = 0; row < kDepth; ++row)
+    {
+        buckets[row] = static_cast<std::size_t>(rowHash(key, row) % kWidth);
+        current = std::min<std::uint32_t>(current, m_current[row][buckets[row]]);
+        previous = std::min<std::uint32_t>(previous, m_previous[row][buckets[row]]);
+    }
+
+    const double elapsed = std::chrono::duration<double>(now - m_windowStart).count();
+    const double window = std::chrono::duration<double>(m_limits.window).count();
+    const double overlap = window > 0.0 ? std::max(0.0, 1.0 - elapsed / window) : 0.0;
+    if (current + previous * overlap >= m_limits.maxAttempts)
+    {
+        m_rejected.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    // Conservative update: only the rows holding the minimum grow, which keeps the
+    // overestimate from collisions as small as the sketch allows.
+    for (std::size_t row = 0; row < kDepth; ++row)
+    {
+        auto &counter = m_current[row][buckets[row]];
+        if (counter == current && counter < std::numeric_limits<std::uint16_t>::max())
+        {
+            ++counter;
+        }
+    }
+    m_accepted.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void LoginRateLimiter::setLimits(const LoginRateLimits &limits)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_limits = limits;
+}
+
+LoginRateLimits LoginRateLimiter::limits() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_limits;
+}
+
+LoginRateLimiterStats LoginRateLimiter::stats() const
+{
+    LoginRateLimiterStats stats;
+    stats.accepted = m_accepted.load();
+    stats.rejected = m_rejected.load();
+    return stats;
+}
+
+void LoginRateLimiter::advance(Clock::time_point now)
+{
+    if (now - m_windowStart < m_limits.window)
+    {
+        return;
+    }
+    // After a quiet spell longer than a whole window the previous counts no longer matter.
+    if (now - m_windowStart < 2 * m_limits.window)
+    {
+        m_previous = m_current;
+        m_windowStart += m_limits.window;
+    }
+    else
+    {
+        m_previous = Sketch{};
+        m_windowStart = now;
+    }
+    m_current = Sketch{};
+}
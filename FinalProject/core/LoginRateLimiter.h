@@ -0,0 +1,58 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string_view>
+
+struct LoginRateLimits
+{
+    std::uint32_t maxAttempts = 10;
+    std::chrono::seconds window{60};
+};
+
+struct LoginRateLimiterStats
+{
+    std::uint64_t accepted{};
+    std::uint64_t rejected{};
+};
+
+// Sliding-window attempt limiter keyed by identifier, in fixed memory whatever the number of
+// identifiers. Attempts are counted in count-min sketches for the current and the previous
+// window; the rate is the current count plus the share of the previous window that still
+// overlaps the sliding window. Hash collisions can only overcount, so a key is never let
+// through early, and a flood against one key barely affects the others. The sketches take
+// 256 KiB and hold well over 100k distinct identifiers per window at the default limit
+// before collisions start throttling keys that are within it.
+class LoginRateLimiter
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit LoginRateLimiter(LoginRateLimits limits = LoginRateLimits());
+
+    // Counts an attempt for key and returns true, or returns false without counting when key
+    // has used up its attempts for the window.
+    bool tryAcquire(std::string_view key, Clock::time_point now = Clock::now());
+
+    void setLimits(const LoginRateLimits &limits);
+    LoginRateLimits limits() const;
+    LoginRateLimiterStats stats() const;
+
+private:
+    static constexpr std::size_t kDepth = 4;
+    static constexpr std::size_t kWidth = 16384;
+    using Sketch = std::array<std::array<std::uint16_t, kWidth>, kDepth>;
+
+    mutable std::mutex m_mutex;
+    LoginRateLimits m_limits;
+    Sketch m_current{};
+    Sketch m_previous{};
+    Clock::time_point m_windowStart{};
+    std::atomic<std::uint64_t> m_accepted{0};
+    std::atomic<std::uint64_t> m_rejected{0};
+
+    void advance(Clock::time_point now);
+};
@@ -0,0 +1,49 @@
+#include "MediaModels.h"
+
+SharedString StringPool::intern(std::string_view value)
+{
+    if (value.empty())
+    {
+        return nullptr;
+    }
+
+    const auto it = m_strings.find(value);
+    if (it != m_strings.end())
+    {
+        return it->second;
+    }
+
+    auto shared = std::make_shared<const std::string>(value);
+    m_strings.emplace(std::string_view(*shared), shared);
+    return shared;
+}
+
+std::size_t StringPool::size() const
+{
+    return m_strings.size();
+}
+
+MediaUrl MediaUrl::split(const std::string &url, StringPool &pool)
+{
+    MediaUrl result;
+    const auto slash = url.find_last_of('/');
+    if (slash == std::string::npos)
+    {
+        result.path = url;
+        return result;
+    }
+
+    result.prefix = pool.intern(std::string_view(url).substr(0, slash + 1));
+    result.path = url.substr(slash + 1);
+    return result;
+}
+
+std::string MediaUrl::str() const
+{
+    return textOf(prefix) + path;
+}
+
+bool MediaUrl::empty() const
+{
+    return !prefix && path.empty();
+}
@@ -1,23 +1,59 @@
 #pragma once
 
+#include <cstdint>
+#include <memory>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
+// Immutable string shared between every catalog record that carries the same value.
+using SharedString = std::shared_ptr<const std::string>;
+
+inline const std::string &textOf(const SharedString &value)
+{
+    static const std::string empty;
+    return value ? *value : empty;
+}
+
+class StringPool
+{
+public:
+    SharedString intern(std::string_view value);
+    std::size_t size() const;
+
+private:
+    std::unordered_map<std::string_view, SharedString> m_strings;
+};
+
+// Media URLs share long directory prefixes, so only the file part is stored per title.
+struct MediaUrl
+{
+    SharedString prefix;
+    std::string path;
+
+    static MediaUrl split(const std::string &url, StringPool &pool);
+    std::string str() const;
+    bool empty() const;
+};
+
 struct MediaItem
 {
-    std::string type;
+    int id{};
+    SharedString type;
     std::string title;
-    std::string genre;
-    std::string duration;
-    std::string rating;
+    SharedString genre;
+    SharedString duration;
+    SharedString rating;
     std::string description;
-    std::string accentColor;
-    std::string thumbnailUrl;
-    std::string videoUrl;
+    SharedString accentColor;
+    MediaUrl thumbnailUrl;
+    MediaUrl videoUrl;
 };
 
 struct MediaCategory
 {
-    std::string name;
-    std::vector<MediaItem> items;
+    int id{};
+    SharedString name;
+    std::vector<std::uint32_t> items;
 };
@@ -0,0 +1,226 @@
+#include "Metrics.h"
+
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+// Exported le edges in nanoseconds. Recording keeps the full resolution; the ladder only
+// bounds how many series a scrape carries.
+constexpr std::uint64_t kExportedNs[] = {
+    10'000,      25'000,      50'000,      100'000,       250'000,       500'000,       750'000,
+    1'000'000,   2'500'000,   5'000'000,   10'000'000,    25'000'000,    50'000'000,    100'000'000,
+    250'000'000, 500'000'000, 1'000'000'000, 2'500'000'000, 5'000'000'000, 10'000'000'000};
+
+template <typename T>
+struct Family
+{
+    std::string help;
+    // Keyed by the rendered label set, so the output is sorted and stable.
+    std::map<std::string, std::unique_ptr<T>> series;
+};
+
+struct Registry
+{
+    std::mutex mutex;
+    std::map<std::string, Family<Metrics::Counter>> counters;
+    std::map<std::string, Family<Metrics::Gauge>> gauges;
+    std::map<std::string, Family<Metrics::Histogram>> histograms;
+};
+
+Registry &registry()
+{
+    static Registry instance;
+    return instance;
+}
+
+std::string renderLabels(const Metrics::Labels &labels)
+{
+    std::string out;
+    for (const auto &[key, value] : labels)
+    {
+        out += out.empty() ? "" : ",";
+        out += key + "=\"";
+        for (const char c : value)
+        {
+            if (c == '\\' || c == '"')
+            {
+                out += '\\';
+                out += c;
+            }
+            else if (c == '\n')
+            {
+                out += "\\n";
+            }
+            else
+            {
+                out += c;
+            }
+        }
+        out += '"';
+    }
+    return out;
+}
+
+template <typename T>
+T &lookup(std::map<std::string, Family<T>> &families, const std::string &name, const std::string &help,
+          const Metrics::Labels &labels)
+{
+    Registry &all = registry();
+    std::lock_guard<std::mutex> lock(all.mutex);
+    Family<T> &family = families[name];
+    if (family.help.empty())
+    {
+        family.help = help;
+    }
+    auto &metric = family.series[renderLabels(labels)];
+    if (!metric)
+    {
+        metric = std::make_unique<T>();
+    }
+    return *metric;
+}
+
+void appendHeader(std::string &out, const std::string &name, const std::string &help, const char *type)
+{
+    out += "# HELP " + name + " " + help + "\n";
+    out += "# TYPE " + name + " " + type + "\n";
+}
+
+std::string series(const std::string &name, const std::string &labels, const std::string &extra = {})
+{
+    std::string all = labels;
+    if (!extra.empty())
+    {
+        all += all.empty() ? extra : "," + extra;
+    }
+    return all.empty() ? name : name + "{" + all + "}";
+}
+
+// Index of the bucket whose lower edge is nearest each exported edge, ascending.
+const std::vector<std::size_t> &exportedBuckets()
+{
+    static const std::vector<std::size_t> buckets = []() {
+        std::vector<std::size_t> indexes;
+        for (const std::uint64_t ns : kExportedNs)
+        {
+            std::size_t index = Metrics::Histogram::bucketIndex(ns);
+            if (ns - Metrics::Histogram::bucketLowerBound(index) > Metrics::Histogram::bucketLowerBound(index + 1) - ns)
+            {
+                ++index;
+            }
+            if (indexes.empty() || indexes.back() != index)
+            {
+                indexes.push_back(index);
+            }
+        }
+        return indexes;
+    }();
+    return buckets;
+}
+
+std::string formatSeconds(std::uint64_t ns)
+{
+    char number[32];
+    std::snprintf(number, sizeof(number), "%.12g", static_cast<double>(ns) / 1e9);
+    return number;
+}
+} // namespace
+
+namespace Metrics
+{
+std::size_t Histogram::bucketIndex(std::uint64_t ns)
+{
+    if (ns < kSubBuckets)
+    {
+        return static_cast<std::size_t>(ns);
+    }
+    int exponent = 63;
+    while (!(ns >> exponent))
+    {
+        --exponent;
+    }
+    const int shift = exponent - kSubBucketBits;
+    return static_cast<std::size_t>(shift + 1) * kSubBuckets + static_cast<std::size_t>(ns >> shift) - kSubBuckets;
+}
+
+std::uint64_t Histogram::bucketLowerBound(std::size_t index)
+{
+    if (index < 2 * kSubBuckets)
+    {
+        return index;
+    }
+    const std::size_t shift = index / kSubBuckets - 1;
+    return (kSubBuckets + index % kSubBuckets) << shift;
+}
+
+Counter &counter(const std::string &name, const std::string &help, const Labels &labels)
+{
+    return lookup(registry().counters, name, help, labels);
+}
+
+Gauge &gauge(const std::string &name, const std::string &help, const Labels &labels)
+{
+    return lookup(registry().gauges, name, help, labels);
+}
+
+Histogram &histogram(const std::string &name, const std::string &help, const Labels &labels)
+{
+    return lookup(registry().histograms, name, help, labels);
+}
+
+std::string prometheusText()
+{
+    Registry &all = registry();
+    std::lock_guard<std::mutex> lock(all.mutex);
+    std::string out;
+
+    for (const auto &[name, family] : all.counters)
+    {
+        appendHeader(out, name, family.help, "counter");
+        for (const auto &[labels, metric] : family.series)
+        {
+            out += series(name, labels) + " " + std::to_string(metric->value()) + "\n";
+        }
+    }
+
+    for (const auto &[name, family] : all.gauges)
+    {
+        appendHeader(out, name, family.help, "gauge");
+        for (const auto &[labels, metric] : family.series)
+        {
+            out += series(name, labels) + " " + std::to_string(metric->value()) + "\n";
+        }
+    }
+
+    const std::vector<std::size_t> &edges = exportedBuckets();
+    for (const auto &[name, family] : all.histograms)
+    {
+        appendHeader(out, name, family.help, "histogram");
+        for (const auto &[labels, metric] : family.series)
+        {
+            // Each edge counts the samples below the bucket that starts there; with integer
+            // nanoseconds that differs from "less or equal" only for an exact hit on the edge.
+            std::uint64_t cumulative = 0;
+            auto edge = edges.begin();
+            for (std::size_t index = 0; index < Histogram::kBucketCount; ++index)
+            {
+                if (edge != edges.end() && *edge == index)
+                {
+                    const std::string le = "le=\"" + formatSeconds(Histogram::bucketLowerBound(index)) + "\"";
+                    out += series(name + "_bucket", labels, le) + " " + std::to_string(cumulative) + "\n";
+                    ++edge;
+                }
+                cumulative += metric->bucket(index);
+            }
+            out += series(name + "_bucket", labels, "le=\"+Inf\"") + " " + std::to_string(cumulative) + "\n";
+            out += series(name + "_sum", labels) + " " + formatSeconds(metric->sumNs()) + "\n";
+            out += series(name + "_count", labels) + " " + std::to_string(cumulative) + "\n";
+        }
+    }
+    return out;
+}
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+// In-process counters, gauges and latency histograms, rendered in the Prometheus text format.
+// Looking a metric up takes the registry lock, so hot paths keep the returned reference (it
+// stays valid for the life of the process); updating one is a relaxed atomic add.
+// A metric name must always be used with the same kind.
+namespace Metrics
+{
+using Labels = std::vector<std::pair<std::string, std::string>>;
+
+class Counter
+{
+public:
+    void add(std::uint64_t amount = 1) { m_value.fetch_add(amount, std::memory_order_relaxed); }
+    std::uint64_t value() const { return m_value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<std::uint64_t> m_value{0};
+};
+
+class Gauge
+{
+public:
+    void set(std::int64_t value) { m_value.store(value, std::memory_order_relaxed); }
+    void add(std::int64_t amount) { m_value.fetch_add(amount, std::memory_order_relaxed); }
+    std::int64_t value() const { return m_value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<std::int64_t> m_value{0};
+};
+
+// Durations in nanoseconds, counted in log-linear buckets as in an HDR histogram: every
+// power of two is split into kSubBuckets equal parts, so a bucket is at most 12.5% wide
+// anywhere in the range, with a fixed 4 KiB of counters. Exports use a coarser subset of
+// the edges; see prometheusText().
+class Histogram
+{
+public:
+    static constexpr int kSubBucketBits = 3;
+    static constexpr std::size_t kSubBuckets = std::size_t{1} << kSubBucketBits;
+    static constexpr std::size_t kBucketCount = (65 - kSubBucketBits) * kSubBuckets;
+
+    void record(std::uint64_t ns)
+    {
+        m_buckets[bucketIndex(ns)].fetch_add(1, std::memory_order_relaxed);
+        m_sumNs.fetch_add(ns, std::memory_order_relaxed);
+    }
+
+    std::uint64_t bucket(std::size_t index) const { return m_buckets[index].load(std::memory_order_relaxed); }
+    std::uint64_t sumNs() const { return m_sumNs.load(std::memory_order_relaxed); }
+
+    static std::size_t bucketIndex(std::uint64_t ns);
+    // Smallest value that lands in the bucket.
+    static std::uint64_t bucketLowerBound(std::size_t index);
+
+private:
+    std::array<std::atomic<std::uint64_t>, kBucketCount> m_buckets{};
+    std::atomic<std::uint64_t> m_sumNs{0};
+};
+
+// Records the lifetime of the scope into a histogram.
+class ScopedTimer
+{
+public:
+    explicit ScopedTimer(Histogram &histogram)
+        : m_histogram(histogram)
+        , m_start(std::chrono::steady_clock::now())
+    {
+    }
+    ~ScopedTimer()
+    {
+        const auto elapsed = std::chrono::steady_clock::now() - m_start;
+        m_histogram.record(static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+    }
+
+    ScopedTimer(const ScopedTimer &) = delete;
+    ScopedTimer &operator=(const ScopedTimer &) = delete;
+
+private:
+    Histogram &m_histogram;
+    std::chrono::steady_clock::time_point m_start;
+};
+
+// Returns the metric for name and labels, creating it on first use. Histogram names should
+// end in _seconds; they are exported in seconds.
+Counter &counter(const std::string &name, const std::string &help, const Labels &labels = {});
+Gauge &gauge(const std::string &name, const std::string &help, const Labels &labels = {});
+Histogram &histogram(const std::string &name, const std::string &help, const Labels &labels = {});
+
+// Every registered metric in the Prometheus text exposition format, version 0.0.4. Histograms
+// export a fixed latency ladder (10 us, 25 us, 50 us, 100 us ... 10 s), each step snapped to
+// the nearest recorded bucket edge so the counts stay exact; the le labels carry the snapped
+// values.
+std::string prometheusText();
+}
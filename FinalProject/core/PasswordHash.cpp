@@ -0,0 +1,535 @@
+#include "PasswordHash.h"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstring>
+#include <optional>
+#include <random>
+#include <vector>
+
+namespace
+{
+constexpr std::string_view kPrefix = "$scrypt$";
+constexpr std::size_t kSaltSize = 16;
+constexpr std::size_t kHashSize = 32;
+// Stored costs beyond these are refused rather than allowed to exhaust memory.
+constexpr std::uint32_t kMaxLogN = 22;
+constexpr std::uint64_t kMaxMemory = 1ull << 30;
+
+class Sha256
+{
+public:
+    static constexpr std::size_t kBlockSize = 64;
+    static constexpr std::size_t kDigestSize = 32;
+
+    Sha256() { reset(); }
+
+    void reset()
+    {
+        m_state = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+        m_length = 0;
+        m_used = 0;
+    }
+
+    void update(const std::uint8_t *data, std::size_t size)
+    {
+        m_length += size;
+        while (size > 0)
+        {
+            const std::size_t take = std::min(size, kBlockSize - m_used);
+            std::memcpy(m_buffer.data() + m_used, data, take);
+            m_used += take;
+            data += take;
+            size -= take;
+            if (m_used == kBlockSize)
+            {
+                compress(m_buffer.data());
+                m_used = 0;
+            }
+        }
+    }
+
+    void update(std::string_view data) { update(reinterpret_cast<const std::uint8_t *>(data.data()), data.size()); }
+
+    std::array<std::uint8_t, kDigestSize> finish()
+    {
+        const std::uint64_t bits = m_length * 8;
+        const std::uint8_t pad = 0x80;
+        update(&pad, 1);
+        const std::uint8_t zero = 0;
+        while (m_used != kBlockSize - 8)
+        {
+            update(&zero, 1);
+        }
+        std::uint8_t length[8];
+        for (int i = 0; i < 8; ++i)
+        {
+            length[i] = static_cast<std::uint8_t>(bits >> (56 - 8 * i));
+        }
+        update(length, 8);
+
+        std::array<std::uint8_t, kDigestSize> digest;
+        for (std::size_t i = 0; i < 8; ++i)
+        {
+            for (std::size_t b = 0; b < 4; ++b)
+            {
+                digest[i * 4 + b] = static_cast<std::uint8_t>(m_state[i] >> (24 - 8 * b));
+            }
+        }
+        return digest;
+    }
+
+private:
+    std::array<std::uint32_t, 8> m_state;
+    std::array<std::uint8_t, kBlockSize> m_buffer;
+    std::uint64_t m_length;
+    std::size_t m_used;
+
+    static std::uint32_t rotr(std::uint32_t x, int n) { return (x >> n) | (x << (32 - n)); }
+
+    void compress(const std::uint8_t *block)
+    {
+        static constexpr std::uint32_t k[64] = {
+            0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+            0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+            0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+            0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+            0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+            0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+            0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+            0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+
+        std::uint32_t w[64];
+        for (int i = 0; i < 16; ++i)
+        {
+            w[i] = (std::uint32_t(block[i * 4]) << 24) | (std::uint32_t(block[i * 4 + 1]) << 16)
+                   | (std::uint32_t(block[i * 4 + 2]) << 8) | std::uint32_t(block[i * 4 + 3]);
+        }
+        for (int i = 16; i < 64; ++i)
+        {
+            const std::uint32_t s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+            const std::uint32_t s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+            w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+        }
+
+        std::uint32_t a = m_state[0], b = m_state[1], c = m_state[2], d = m_state[3];
+        std::uint32_t e = m_state[4], f = m_state[5], g = m_state[6], h = m_state[7];
+        for (int i = 0; i < 64; ++i)
+        {
+            const std::uint32_t t1 = h + (rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25)) + ((e & f) ^ (~e & g)) + k[i] + w[i];
+            const std::uint32_t t2 = (rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+            h = g;
+            g = f;
+            f = e;
+            e = d + t1;
+            d = c;
+            c = b;
+            b = a;
+            a = t1 + t2;
+        }
+        m_state[0] += a;
+        m_state[1] += b;
+        m_state[2] += c;
+        m_state[3] += d;
+        m_state[4] += e;
+        m_state[5] += f;
+        m_state[6] += g;
+        m_state[7] += h;
+    }
+};
+
+// HMAC-SHA256 with the keyed inner and outer states computed once, since PBKDF2 reuses the
+// same key for every block.
+class HmacSha256
+{
+public:
+    explicit HmacSha256(std::string_view key)
+    {
+        std::array<std::uint8_t, Sha256::kBlockSize> block{};
+        if (key.size() > Sha256::kBlockSize)
+        {
+            Sha256 digest;
+            digest.update(key);
+            const auto hashed = digest.finish();
+            std::memcpy(block.data(), hashed.data(), hashed.size());
+        }
+        else
+        {
+            std::memcpy(block.data(), key.data(), key.size());
+        }
+
+        std::array<std::uint8_t, Sha256::kBlockSize> pad;
+        for (std::size_t i = 0; i < pad.size(); ++i)
+        {
+            pad[i] = block[i] ^ 0x36;
+        }
+        m_inner.update(pad.data(), pad.size());
+        for (std::size_t i = 0; i < pad.size(); ++i)
+        {
+            pad[i] = block[i] ^ 0x5c;
+        }
+        m_outer.update(pad.data(), pad.size());
+    }
+
+    Sha256 begin() const { return m_inner; }
+
+    std::array<std::uint8_t, Sha256::kDigestSize> finish(Sha256 inner) const
+    {
+        const auto innerDigest = inner.finish();
+        Sha256 outer = m_outer;
+        outer.update(innerDigest.data(), innerDigest.size());
+        return outer.finish();
+    }
+
+private:
+    Sha256 m_inner;
+    Sha256 m_outer;
+};
+
+std::uint32_t load32(const std::uint8_t *bytes)
+{
+    return std::uint32_t(bytes[0]) | (std::uint32_t(bytes[1]) << 8) | (std::uint32_t(bytes[2]) << 16)
+           | (std::uint32_t(bytes[3]) << 24);
+}
+
+void store32(std::uint8_t *bytes, std::uint32_t value)
+{
+    bytes[0] = static_cast<std::uint8_t>(value);
+    bytes[1] = static_cast<std::uint8_t>(value >> 8);
+    bytes[2] = static_cast<std::uint8_t>(value >> 16);
+    bytes[3] = static_cast<std::uint8_t>(value >> 24);
+}
+
+std::uint32_t rotl(std::uint32_t x, int n)
+{
+    return (x << n) | (x >> (32 - n));
+}
+
+// B = Salsa20/8(B ^ X), on 16-word blocks.
+void salsa208Xor(std::uint32_t *b, const std::uint32_t *x)
+{
+    std::uint32_t in[16];
+    for (int i = 0; i < 16; ++i)
+    {
+        in[i] = b[i] ^ x[i];
+    }
+    std::uint32_t w[16];
+    std::memcpy(w, in, sizeof(w));
+    for (int round = 0; round < 8; round += 2)
+    {
+        w[4] ^= rotl(w[0] + w[12], 7);
+        w[8] ^= rotl(w[4] + w[0], 9);
+        w[12] ^= rotl(w[8] + w[4], 13);
+        w[0] ^= rotl(w[12] + w[8], 18);
+        w[9] ^= rotl(w[5] + w[1], 7);
+        w[13] ^= rotl(w[9] + w[5], 9);
+        w[1] ^= rotl(w[13] + w[9], 13);
+        w[5] ^= rotl(w[1] + w[13], 18);
+        w[14] ^= rotl(w[10] + w[6], 7);
+        w[2] ^= rotl(w[14] + w[10], 9);
+        w[6] ^= rotl(w[2] + w[14], 13);
+        w[10] ^= rotl(w[6] + w[2], 18);
+        w[3] ^= rotl(w[15] + w[11], 7);
+        w[7] ^= rotl(w[3] + w[15], 9);
+        w[11] ^= rotl(w[7] + w[3], 13);
+        w[15] ^= rotl(w[11] + w[7], 18);
+
+        w[1] ^= rotl(w[0] + w[3], 7);
+        w[2] ^= rotl(w[1] + w[0], 9);
+        w[3] ^= rotl(w[2] + w[1], 13);
+        w[0] ^= rotl(w[3] + w[2], 18);
+        w[6] ^= rotl(w[5] + w[4], 7);
+        w[7] ^= rotl(w[6] + w[5], 9);
+        w[4] ^= rotl(w[7] + w[6], 13);
+        w[5] ^= rotl(w[4] + w[7], 18);
+        w[11] ^= rotl(w[10] + w[9], 7);
+        w[8] ^= rotl(w[11] + w[10], 9);
+        w[9] ^= rotl(w[8] + w[11], 13);
+        w[10] ^= rotl(w[9] + w[8], 18);
+        w[12] ^= rotl(w[15] + w[14], 7);
+        w[13] ^= rotl(w[12] + w[15], 9);
+        w[14] ^= rotl(w[13] + w[12], 13);
+        w[15] ^= rotl(w[14] + w[13], 18);
+    }
+    for (int i = 0; i < 16; ++i)
+    {
+        b[i] = in[i] + w[i];
+    }
+}
+
+// scryptBlockMix over 2r 16-word blocks: in to out, out must not alias in.
+void blockMix(const std::uint32_t *in, std::uint32_t *out, std::uint32_t r)
+{
+    std::uint32_t x[16];
+    std::memcpy(x, in + (2 * r - 1) * 16, sizeof(x));
+    for (std::uint32_t i = 0; i < 2 * r; ++i)
+    {
+        salsa208Xor(x, in + i * 16);
+        // Even blocks go to the first half of the output, odd blocks to the second.
+        std::memcpy(out + ((i / 2) + (i % 2) * r) * 16, x, sizeof(x));
+    }
+}
+
+void roMix(std::uint8_t *block, std::uint32_t r, std::uint64_t n, std::vector<std::uint32_t> &v)
+{
+    const std::size_t words = 32 * std::size_t(r);
+    std::vector<std::uint32_t> x(words);
+    std::vector<std::uint32_t> y(words);
+    for (std::size_t i = 0; i < words; ++i)
+    {
+        x[i] = load32(block + i * 4);
+    }
+
+    for (std::uint64_t i = 0; i < n; ++i)
+    {
+        std::memcpy(v.data() + i * words, x.data(), words * 4);
+        blockMix(x.data(), y.data(), r);
+        x.swap(y);
+    }
+    for (std::uint64_t i = 0; i < n; ++i)
+    {
+        const std::uint64_t j = x[(2 * r - 1) * 16] & (n - 1);
+        const std::uint32_t *vj = v.data() + j * words;
+        for (std::size_t k = 0; k < words; ++k)
+        {
+            x[k] ^= vj[k];
+        }
+        blockMix(x.data(), y.data(), r);
+        x.swap(y);
+    }
+
+    for (std::size_t i = 0; i < words; ++i)
+    {
+        store32(block + i * 4, x[i]);
+    }
+}
+
+bool costSupported(const PasswordHash::Cost &cost)
+{
+    if (cost.logN == 0 || cost.logN > kMaxLogN || cost.r == 0 || cost.p == 0)
+    {
+        return false;
+    }
+    const std::uint64_t blockBytes = 128ull * cost.r;
+    return blockBytes * ((1ull << cost.logN) + cost.p) <= kMaxMemory;
+}
+
+const char kBase64[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+std::string toBase64(std::string_view bytes)
+{
+    std::string out;
+    out.reserve((bytes.size() + 2) / 3 * 4);
+    std::uint32_t bits = 0;
+    int count = 0;
+    for (const char c : bytes)
+    {
+        bits = (bits << 8) | static_cast<unsigned char>(c);
+        count += 8;
+        while (count >= 6)
+        {
+            count -= 6;
+            out.push_back(kBase64[(bits >> count) & 0x3F]);
+        }
+    }
+    if (count > 0)
+    {
+        out.push_back(kBase64[(bits << (6 - count)) & 0x3F]);
+    }
+    return out;
+}
+
+std::optional<std::string> fromBase64(std::string_view text)
+{
+    std::string out;
+    std::uint32_t bits = 0;
+    int count = 0;
+    for (const char c : text)
+    {
+        const char *found = std::strchr(kBase64, c);
+        if (c == '\0' || !found)
+        {
+            return std::nullopt;
+        }
+        bits = (bits << 6) | static_cast<std::uint32_t>(found - kBase64);
+        count += 6;
+        if (count >= 8)
+        {
+            count -= 8;
+            out.push_back(static_cast<char>((bits >> count) & 0xFF));
+        }
+    }
+    return out;
+}
+
+struct Decoded
+{
+    PasswordHash::Cost cost;
+    std::string salt;
+    std::string hash;
+};
+
+bool parseParameter(std::string_view &text, std::string_view name, std::uint32_t &value)
+{
+    if (text.substr(0, name.size()) != name)
+    {
+        return false;
+    }
+    text.remove_prefix(name.size());
+    const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (error != std::errc())
+    {
+        return false;
+    }
+    text.remove_prefix(static_cast<std::size_t>(end - text.data()));
+    return true;
+}
+
+std::optional<Decoded> decode(std::string_view encoded)
+{
+    if (encoded.substr(0, kPrefix.size()) != kPrefix)
+    {
+        return std::nullopt;
+    }
+    encoded.remove_prefix(kPrefix.size());
+
+    Decoded decoded;
+    if (!parseParameter(encoded, "ln=", decoded.cost.logN) || !parseParameter(encoded, ",r=", decoded.cost.r)
+        || !parseParameter(encoded, ",p=", decoded.cost.p) || encoded.substr(0, 1) != "$")
+    {
+        return std::nullopt;
+    }
+    encoded.remove_prefix(1);
+
+    const auto separator = encoded.find('$');
+    if (separator == std::string_view::npos)
+    {
+        return std::nullopt;
+    }
+    auto salt = fromBase64(encoded.substr(0, separator));
+    auto hash = fromBase64(encoded.substr(separator + 1));
+    if (!salt || !hash || hash->empty())
+    {
+        return std::nullopt;
+    }
+    decoded.salt = std::move(*salt);
+    decoded.hash = std::move(*hash);
+    return decoded;
+}
+
+bool constantTimeEquals(std::string_view a, std::string_view b)
+{
+    if (a.size() != b.size())
+    {
+        return false;
+    }
+    unsigned char difference = 0;
+    for (std::size_t i = 0; i < a.size(); ++i)
+    {
+        difference |= static_cast<unsigned char>(a[i] ^ b[i]);
+    }
+    return difference == 0;
+}
+
+std::string randomSalt()
+{
+    static thread_local std::random_device device;
+    std::string salt(kSaltSize, '\0');
+    for (std::size_t i = 0; i < salt.size(); i += 4)
+    {
+        const std::uint32_t bits = device();
+        for (std::size_t b = 0; b < 4 && i + b < salt.size(); ++b)
+        {
+            salt[i + b] = static_cast<char>(bits >> (8 * b));
+        }
+    }
+    return salt;
+}
+} // namespace
+
+namespace PasswordHash
+{
+std::string pbkdf2Sha256(std::string_view password, std::string_view salt, std::uint32_t iterations, std::size_t length)
+{
+    const HmacSha256 mac(password);
+    std::string out;
+    out.reserve(length);
+    for (std::uint32_t block = 1; out.size() < length; ++block)
+    {
+        const std::uint8_t index[4] = {static_cast<std::uint8_t>(block >> 24), static_cast<std::uint8_t>(block >> 16),
+                                       static_cast<std::uint8_t>(block >> 8), static_cast<std::uint8_t>(block)};
+        Sha256 first = mac.begin();
+        first.update(salt);
+        first.update(index, sizeof(index));
+        auto u = mac.finish(first);
+        auto t = u;
+        for (std::uint32_t i = 1; i < iterations; ++i)
+        {
+            Sha256 next = mac.begin();
+            next.update(u.data(), u.size());
+            u = mac.finish(next);
+            for (std::size_t b = 0; b < t.size(); ++b)
+            {
+                t[b] ^= u[b];
+            }
+        }
+        out.append(reinterpret_cast<const char *>(t.data()), std::min(t.size(), length - out.size()));
+    }
+    return out;
+}
+
+std::string scrypt(std::string_view password, std::string_view salt, const Cost &cost, std::size_t length)
+{
+    if (!costSupported(cost))
+    {
+        return {};
+    }
+
+    const std::size_t blockBytes = 128 * std::size_t(cost.r);
+    std::string blocks = pbkdf2Sha256(password, salt, 1, blockBytes * cost.p);
+    const std::uint64_t n = 1ull << cost.logN;
+    std::vector<std::uint32_t> v(n * 32 * cost.r);
+    for (std::uint32_t i = 0; i < cost.p; ++i)
+    {
+        roMix(reinterpret_cast<std::uint8_t *>(blocks.data()) + i * blockBytes, cost.r, n, v);
+    }
+    return pbkdf2Sha256(password, blocks, 1, length);
+}
+
+std::string hash(std::string_view password, const Cost &cost)
+{
+    return hash(password, cost, randomSalt());
+}
+
+std::string hash(std::string_view password, const Cost &cost, std::string_view salt)
+{
+    const std::string derived = scrypt(password, salt, cost, kHashSize);
+    if (derived.empty())
+    {
+        return {};
+    }
+    return std::string(kPrefix) + "ln=" + std::to_string(cost.logN) + ",r=" + std::to_string(cost.r)
+           + ",p=" + std::to_string(cost.p) + "$" + toBase64(salt) + "$" + toBase64(derived);
+}
+
+bool verify(std::string_view password, std::string_view encoded)
+{
+    if (encoded.substr(0, kPrefix.size()) != kPrefix)
+    {
+        return !encoded.empty() && constantTimeEquals(password, encoded);
+    }
+    const auto decoded = decode(encoded);
+    if (!decoded || !costSupported(decoded->cost))
+    {
+        return false;
+    }
+    return constantTimeEquals(scrypt(password, decoded->salt, decoded->cost, decoded->hash.size()), decoded->hash);
+}
+
+bool needsRehash(std::string_view encoded, const Cost &cost)
+{
+    const auto decoded = decode(encoded);
+    return !decoded || decoded->cost != cost;
+}
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// Password storage with scrypt (RFC 7914). Encoded hashes look like
+//   $scrypt$ln=14,r=8,p=1$<salt>$<hash>
+// with base64 salt and hash, so the cost travels with every row and can be raised later.
+// Hashing takes 128 * r * 2^ln bytes of memory and most of a core for tens of milliseconds
+// at the default cost: keep it off the GUI thread and bound how many run at once.
+namespace PasswordHash
+{
+struct Cost
+{
+    // log2 of the scrypt CPU/memory cost N.
+    std::uint32_t logN = 14;
+    std::uint32_t r = 8;
+    std::uint32_t p = 1;
+
+    bool operator==(const Cost &other) const { return logN == other.logN && r == other.r && p == other.p; }
+    bool operator!=(const Cost &other) const { return !(*this == other); }
+};
+
+// Encoded hash of password under a fresh random salt.
+std::string hash(std::string_view password, const Cost &cost);
+// Same under a caller-chosen salt, for reproducible fixtures; real accounts need a fresh one.
+std::string hash(std::string_view password, const Cost &cost, std::string_view salt);
+
+// True when password matches encoded. Anything that is not an encoded hash is taken as a
+// legacy plaintext password and compared as such.
+bool verify(std::string_view password, std::string_view encoded);
+
+// True for legacy plaintext and for hashes made with a different cost.
+bool needsRehash(std::string_view encoded, const Cost &cost);
+
+// Raw derivations, exposed for the benchmark and for checking against published vectors.
+std::string pbkdf2Sha256(std::string_view password, std::string_view salt, std::uint32_t iterations, std::size_t length);
+std::string scrypt(std::string_view password, std::string_view salt, const Cost &cost, std::size_t length);
+}
@@ -0,0 +1,478 @@
+#include "SearchIndex.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+namespace
+{
+constexpr std::uint32_t kNoTerm = 0xFFFFFFFF;
+constexpr std::size_t kMinFuzzyLength = 4;
+constexpr std::size_t kMaxFuzzyLength = 32;
+constexpr std::size_t kMaxQueryWords = 8;
+constexpr std::uint32_t kTiers = 3;
+// Candidates scored per query before the search settles for the page it has, and before it
+// gives up looking for more. Postings are ordered best first, title tier first, so these only
+// trim matches of very common words and short prefixes.
+constexpr std::size_t kCandidateBudget = 2048;
+constexpr std::size_t kCandidateLimit = 8192;
+
+std::uint64_t hashOf(std::string_view text)
+{
+    std::uint64_t hash = 1469598103934665603ull;
+    for (const char c : text)
+    {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+// Hash of text with the character at position skip left out.
+std::uint64_t deletionHash(std::string_view text, std::size_t skip)
+{
+    std::uint64_t hash = 1469598103934665603ull;
+    for (std::size_t i = 0; i < text.size(); ++i)
+    {
+        if (i != skip)
+        {
+            hash ^= static_cast<unsigned char>(text[i]);
+            hash *= 1099511628211ull;
+        }
+    }
+    return hash;
+}
+
+// True when a and b are at most one insertion, deletion, substitution or adjacent swap apart.
+bool withinOneEdit(std::string_view a, std::string_view b)
+{
+    if (a.size() > b.size())
+    {
+        std::swap(a, b);
+    }
+    if (b.size() - a.size() > 1)
+    {
+        return false;
+    }
+
+    std::size_t i = 0;
+    while (i < a.size() && a[i] == b[i])
+    {
+        ++i;
+    }
+    if (a.size() != b.size())
+    {
+        return a.substr(i) == b.substr(i + 1);
+    }
+    if (i == a.size())
+    {
+        return true;
+    }
+    if (a.substr(i + 1) == b.substr(i + 1))
+    {
+        return true;
+    }
+    return i + 1 < a.size() && a[i] == b[i + 1] && a[i + 1] == b[i] && a.substr(i + 2) == b.substr(i + 2);
+}
+
+std::string normalize(std::string_view text)
+{
+    std::string joined;
+    for (const auto &word : SearchIndex::tokenize(text))
+    {
+        if (!joined.empty())
+        {
+            joined += ' ';
+        }
+        joined += word;
+    }
+    return joined;
+}
+} // namespace
+
+SearchIndex::SearchIndex(StreamingService::Snapshot snapshot)
+    : m_snapshot(std::move(snapshot))
+{
+    if (!m_snapshot)
+    {
+        m_snapshot = std::make_shared<const CatalogSnapshot>();
+    }
+    const auto itemCount = static_cast<std::uint32_t>(m_snapshot->items.size());
+
+    // Terms get provisional ids in order of appearance and are renumbered once sorted.
+    std::unordered_map<std::string, std::uint32_t> provisional;
+    std::vector<std::vector<Posting>> perItem(itemCount);
+    const auto add = [&](std::uint32_t item, std::string_view text, std::uint8_t field) {
+        for (auto &word : tokenize(text))
+        {
+            const auto [it, inserted] = provisional.try_emplace(std::move(word), static_cast<std::uint32_t>(provisional.size()));
+            perItem[item].push_back({it->second, field});
+        }
+    };
+
+    m_normalizedTitles.reserve(itemCount);
+    for (std::uint32_t item = 0; item < itemCount; ++item)
+    {
+        const MediaItem &media = m_snapshot->item(item);
+        add(item, media.title, Title);
+        add(item, textOf(media.genre), Genre);
+        add(item, media.description, Description);
+        m_normalizedTitles.push_back(normalize(media.title));
+    }
+    for (const auto &category : m_snapshot->categories)
+    {
+        for (const auto item : category.items)
+        {
+            add(item, textOf(category.name), Genre);
+        }
+    }
+
+    std::vector<std::pair<std::string_view, std::uint32_t>> sorted;
+    sorted.reserve(provisional.size());
+    for (const auto &[term, id] : provisional)
+    {
+        sorted.emplace_back(term, id);
+    }
+    std::sort(sorted.begin(), sorted.end());
+
+    std::vector<std::uint32_t> renumbered(sorted.size());
+    m_terms.reserve(sorted.size());
+    for (std::uint32_t id = 0; id < sorted.size(); ++id)
+    {
+        renumbered[sorted[id].second] = id;
+        m_terms.emplace_back(sorted[id].first);
+    }
+
+    // Items: one entry per distinct term, with the fields it occurred in merged.
+    std::vector<std::uint32_t> slotSize(m_terms.size() * kTiers, 0);
+    m_itemStart.reserve(itemCount + 1);
+    m_itemStart.push_back(0);
+    for (auto &postings : perItem)
+    {
+        for (auto &posting : postings)
+        {
+            posting.id = renumbered[posting.id];
+        }
+        std::sort(postings.begin(), postings.end(), [](const Posting &lhs, const Posting &rhs) { return lhs.id < rhs.id; });
+        for (std::size_t i = 0; i < postings.size(); ++i)
+        {
+            if (!m_itemTerms.empty() && m_itemTerms.size() > m_itemStart.back() && m_itemTerms.back().id == postings[i].id)
+            {
+                m_itemTerms.back().fields |= postings[i].fields;
+                continue;
+            }
+            m_itemTerms.push_back(postings[i]);
+        }
+        for (auto i = m_itemStart.back(); i < m_itemTerms.size(); ++i)
+        {
+            ++slotSize[slotOf(m_itemTerms[i])];
+        }
+        m_itemStart.push_back(static_cast<std::uint32_t>(m_itemTerms.size()));
+        std::vector<Posting>().swap(postings);
+    }
+
+    // Terms: the transpose of the item lists, split into title, genre and description tiers.
+    // Within a tier, shorter (more specific) titles come first and newer titles break ties,
+    // which is the order a query wants to see candidates in.
+    m_termStart.assign(slotSize.size() + 1, 0);
+    for (std::size_t slot = 0; slot < slotSize.size(); ++slot)
+    {
+        m_termStart[slot + 1] = m_termStart[slot] + slotSize[slot];
+    }
+    std::vector<std::uint32_t> staticOrder(itemCount);
+    for (std::uint32_t item = 0; item < itemCount; ++item)
+    {
+        staticOrder[item] = item;
+    }
+    std::stable_sort(staticOrder.begin(), staticOrder.end(), [this](std::uint32_t lhs, std::uint32_t rhs) {
+        const auto lhsLength = m_normalizedTitles[lhs].size();
+        const auto rhsLength = m_normalizedTitles[rhs].size();
+        return lhsLength != rhsLength ? lhsLength < rhsLength : lhs > rhs;
+    });
+    m_termItems.resize(m_itemTerms.size());
+    std::vector<std::uint32_t> fill(m_termStart.begin(), m_termStart.end() - 1);
+    for (const auto item : staticOrder)
+    {
+        for (auto i = m_itemStart[item]; i < m_itemStart[item + 1]; ++i)
+        {
+            m_termItems[fill[slotOf(m_itemTerms[i])]++] = {item, m_itemTerms[i].fields};
+        }
+    }
+
+    for (std::uint32_t term = 0; term < m_terms.size(); ++term)
+    {
+        const std::string &text = m_terms[term];
+        if (text.size() < kMinFuzzyLength || text.size() > kMaxFuzzyLength)
+        {
+            continue;
+        }
+        for (std::size_t skip = 0; skip < text.size(); ++skip)
+        {
+            m_deletions.emplace_back(deletionHash(text, skip), term);
+        }
+    }
+    std::sort(m_deletions.begin(), m_deletions.end());
+}
+
+std::vector<std::string> SearchIndex::tokenize(std::string_view text)
+{
+    std::vector<std::string> words;
+    std::string word;
+    for (const char c : text)
+    {
+        const auto byte = static_cast<unsigned char>(c);
+        if (byte >= 0x80 || (byte >= '0' && byte <= '9') || (byte >= 'a' && byte <= 'z'))
+        {
+            word += c;
+        }
+        else if (byte >= 'A' && byte <= 'Z')
+        {
+            word += static_cast<char>(byte - 'A' + 'a');
+        }
+        else if (!word.empty())
+        {
+            words.push_back(std::move(word));
+            word.clear();
+        }
+    }
+    if (!word.empty())
+    {
+        words.push_back(std::move(word));
+    }
+    return words;
+}
+
+std::vector<SearchIndex::Hit> SearchIndex::search(std::string_view query, std::size_t limit) const
+{
+    std::vector<Hit> hits;
+    auto words = tokenize(query);
+    if (words.empty() || limit == 0)
+    {
+        return hits;
+    }
+    if (words.size() > kMaxQueryWords)
+    {
+        words.resize(kMaxQueryWords);
+    }
+
+    std::vector<WordMatch> matches;
+    matches.reserve(words.size());
+    for (const auto &word : words)
+    {
+        matches.push_back(match(word));
+        if (matches.back().postings == 0)
+        {
+            return hits;
+        }
+    }
+
+    // Candidates come from the most selective word; the others only filter and score them.
+    const auto driver = static_cast<std::size_t>(
+        std::min_element(matches.begin(), matches.end(),
+                         [](const WordMatch &lhs, const WordMatch &rhs) { return lhs.postings < rhs.postings; })
+        - matches.begin());
+
+    // Exact match first, then prefix completions from the shortest, then fuzzy matches, so
+    // every candidate is first seen through its best-weighted term.
+    const WordMatch &lead = matches[driver];
+    std::vector<std::uint32_t> leadTerms;
+    leadTerms.reserve(lead.last - lead.first + lead.fuzzy.size());
+    for (auto term = lead.first; term < lead.last; ++term)
+    {
+        leadTerms.push_back(term);
+    }
+    std::stable_sort(leadTerms.begin(), leadTerms.end(), [this, &lead](std::uint32_t lhs, std::uint32_t rhs) {
+        return lead.weight(lhs, m_terms[lhs].size()) > lead.weight(rhs, m_terms[rhs].size());
+    });
+    leadTerms.insert(leadTerms.end(), lead.fuzzy.begin(), lead.fuzzy.end());
+
+    const std::string phrase = normalize(query);
+    const auto score = [&](std::uint32_t item, float leadScore) {
+        float total = leadScore;
+        for (std::size_t w = 0; w < matches.size() && total > 0.0f; ++w)
+        {
+            if (w == driver)
+            {
+                continue;
+            }
+            const float wordBest = bestWeight(item, matches[w]);
+            total = wordBest > 0.0f ? total + wordBest : 0.0f;
+        }
+        if (total > 0.0f)
+        {
+            const std::string &title = m_normalizedTitles[item];
+            if (title == phrase)
+            {
+                total += 4.0f;
+            }
+            else if (title.compare(0, phrase.size(), phrase) == 0)
+            {
+                total += 2.0f;
+            }
+        }
+        return total;
+    };
+
+    // Title matches are gathered first. Once they alone fill the page the genre and
+    // description tiers, which hold most postings of common words, are never visited.
+    std::vector<bool> seen(m_snapshot->items.size(), false);
+    std::size_t scored = 0;
+    for (std::uint32_t tier = 0; tier < kTiers && hits.size() < limit; ++tier)
+    {
+        for (const auto term : leadTerms)
+        {
+            const float weight = lead.weight(term, m_terms[term].size());
+            const std::uint32_t slot = term * kTiers + tier;
+            for (auto i = m_termStart[slot]; i < m_termStart[slot + 1]; ++i)
+            {
+                const Posting &posting = m_termItems[i];
+                if (seen[posting.id])
+                {
+                    continue;
+                }
+                seen[posting.id] = true;
+                const float total = score(posting.id, weight * fieldWeight(posting.fields));
+                if (total > 0.0f)
+                {
+                    hits.push_back({posting.id, total});
+                }
+                ++scored;
+                if ((scored >= kCandidateBudget && hits.size() >= limit) || scored >= kCandidateLimit)
+                {
+                    tier = kTiers;
+                    break;
+                }
+            }
+            if (tier == kTiers)
+            {
+                break;
+            }
+        }
+    }
+
+    const auto ranking = [this](const Hit &lhs, const Hit &rhs) {
+        if (lhs.score != rhs.score)
+        {
+            return lhs.score > rhs.score;
+        }
+        const auto lhsLength = m_normalizedTitles[lhs.item].size();
+        const auto rhsLength = m_normalizedTitles[rhs.item].size();
+        return lhsLength != rhsLength ? lhsLength < rhsLength : lhs.item > rhs.item;
+    };
+    if (hits.size() > limit)
+    {
+        std::partial_sort(hits.begin(), hits.begin() + static_cast<std::ptrdiff_t>(limit), hits.end(), ranking);
+        hits.resize(limit);
+    }
+    else
+    {
+        std::sort(hits.begin(), hits.end(), ranking);
+    }
+    return hits;
+}
+
+float SearchIndex::bestWeight(std::uint32_t item, const WordMatch &word) const
+{
+    // The item's terms are sorted by id, so the prefix range and each fuzzy term are found by
+    // binary search instead of walking every term of the item.
+    const auto begin = m_itemTerms.begin() + m_itemStart[item];
+    const auto end = m_itemTerms.begin() + m_itemStart[item + 1];
+    const auto byId = [](const Posting &posting, std::uint32_t id) { return posting.id < id; };
+
+    float best = 0.0f;
+    for (auto it = std::lower_bound(begin, end, word.first, byId); it != end && it->id < word.last; ++it)
+    {
+        best = std::max(best, word.weight(it->id, m_terms[it->id].size()) * fieldWeight(it->fields));
+    }
+    for (const auto term : word.fuzzy)
+    {
+        const auto it = std::lower_bound(begin, end, term, byId);
+        if (it != end && it->id == term)
+        {
+            best = std::max(best, word.weight(term, m_terms[term].size()) * fieldWeight(it->fields));
+        }
+    }
+    return best;
+}
+
+SearchIndex::WordMatch SearchIndex::match(const std::string &word) const
+{
+    WordMatch result;
+    result.length = word.size();
+    const auto lower = std::lower_bound(m_terms.begin(), m_terms.end(), word);
+    const auto upper = std::partition_point(lower, m_terms.end(), [&word](const std::string &term) {
+        return term.compare(0, word.size(), word) == 0;
+    });
+    result.first = static_cast<std::uint32_t>(lower - m_terms.begin());
+    result.last = static_cast<std::uint32_t>(upper - m_terms.begin());
+    result.exact = (lower != m_terms.end() && *lower == word) ? result.first : kNoTerm;
+    result.postings = m_termStart[result.last * kTiers] - m_termStart[result.first * kTiers];
+
+    if (word.size() >= kMinFuzzyLength && word.size() <= kMaxFuzzyLength)
+    {
+        const auto consider = [&](std::uint64_t hash) {
+            auto it = std::lower_bound(m_deletions.begin(), m_deletions.end(), std::make_pair(hash, std::uint32_t(0)));
+            for (; it != m_deletions.end() && it->first == hash; ++it)
+            {
+                if ((it->second < result.first || it->second >= result.last) && withinOneEdit(word, m_terms[it->second]))
+                {
+                    result.fuzzy.push_back(it->second);
+                }
+            }
+        };
+        // A term one character longer, or one substitution or swap away, shares a deletion.
+        consider(hashOf(word));
+        for (std::size_t skip = 0; skip < word.size(); ++skip)
+        {
+            const std::uint64_t hash = deletionHash(word, skip);
+            consider(hash);
+            // A term one character shorter is itself a deletion of the word.
+            std::string shorter = word;
+            shorter.erase(skip, 1);
+            const auto exact = std::lower_bound(m_terms.begin(), m_terms.end(), shorter);
+            if (exact != m_terms.end() && *exact == shorter)
+            {
+                const auto term = static_cast<std::uint32_t>(exact - m_terms.begin());
+                if (term < result.first || term >= result.last)
+                {
+                    result.fuzzy.push_back(term);
+                }
+            }
+        }
+        std::sort(result.fuzzy.begin(), result.fuzzy.end());
+        result.fuzzy.erase(std::unique(result.fuzzy.begin(), result.fuzzy.end()), result.fuzzy.end());
+        for (const auto term : result.fuzzy)
+        {
+            result.postings += m_termStart[(term + 1) * kTiers] - m_termStart[term * kTiers];
+        }
+    }
+    return result;
+}
+
+float SearchIndex::WordMatch::weight(std::uint32_t term, std::size_t termLength) const
+{
+    if (term == exact)
+    {
+        return 1.0f;
+    }
+    if (term >= first && term < last)
+    {
+        // A longer share of the term typed ranks higher.
+        return 0.5f + 0.4f * static_cast<float>(length) / static_cast<float>(termLength);
+    }
+    return std::binary_search(fuzzy.begin(), fuzzy.end(), term) ? 0.4f : 0.0f;
+}
+
+std::uint32_t SearchIndex::slotOf(const Posting &termOfItem)
+{
+    const std::uint32_t tier = (termOfItem.fields & Title) ? 0 : (termOfItem.fields & Genre) ? 1 : 2;
+    return termOfItem.id * kTiers + tier;
+}
+
+float SearchIndex::fieldWeight(std::uint8_t fields)
+{
+    if (fields & Title)
+    {
+        return 3.0f;
+    }
+    return (fields & Genre) ? 2.0f : 1.0f;
+}
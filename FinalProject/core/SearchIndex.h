@@ -0,0 +1,85 @@
+#pragma once
+
+#include "StreamingService.h"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Inverted index over one catalog snapshot: title, description and every genre row a title
+// appears in. Built off the GUI thread whenever a snapshot is published and immutable
+// afterwards, so queries need no locking.
+//
+// Every query word must match. A word matches a term exactly, as a prefix (so results
+// follow as-you-type input) or, for words of four or more characters, within one edit.
+// Matches in the title outweigh genre matches, which outweigh description matches.
+// Postings are stored best first, so a query on a very common word or a one-letter prefix
+// scores a bounded number of candidates instead of every title containing it.
+class SearchIndex
+{
+public:
+    struct Hit
+    {
+        std::uint32_t item{};
+        float score{};
+    };
+
+    explicit SearchIndex(StreamingService::Snapshot snapshot);
+
+    std::vector<Hit> search(std::string_view query, std::size_t limit) const;
+
+    // The snapshot hit indices refer to.
+    const StreamingService::Snapshot &snapshot() const { return m_snapshot; }
+    std::size_t termCount() const { return m_terms.size(); }
+
+    static std::vector<std::string> tokenize(std::string_view text);
+
+private:
+    // Which fields of a title a term occurs in.
+    enum Field : std::uint8_t
+    {
+        Title = 1,
+        Genre = 2,
+        Description = 4
+    };
+
+    struct Posting
+    {
+        std::uint32_t id{};
+        std::uint8_t fields{};
+    };
+
+    // Terms one query word matches: a contiguous range of the sorted dictionary for the
+    // exact and prefix matches, plus scattered fuzzy matches.
+    struct WordMatch
+    {
+        std::uint32_t first{};
+        std::uint32_t last{};
+        std::uint32_t exact{};
+        std::vector<std::uint32_t> fuzzy;
+        std::size_t length{};
+        std::size_t postings{};
+
+        float weight(std::uint32_t term, std::size_t termLength) const;
+    };
+
+    StreamingService::Snapshot m_snapshot;
+    std::vector<std::string> m_terms;
+    // Postings per term and terms per item, both flattened with start offsets. Each term's
+    // postings are split into title, genre and description tiers: slot term * 3 + tier.
+    std::vector<std::uint32_t> m_termStart;
+    std::vector<Posting> m_termItems;
+    std::vector<std::uint32_t> m_itemStart;
+    std::vector<Posting> m_itemTerms;
+    // Hashes of every single-character deletion of each term, for one-edit lookups.
+    std::vector<std::pair<std::uint64_t, std::uint32_t>> m_deletions;
+    std::vector<std::string> m_normalizedTitles;
+
+    WordMatch match(const std::string &word) const;
+    // Best weighted field match of word among the item's terms; 0 when it does not match.
+    float bestWeight(std::uint32_t item, const WordMatch &word) const;
+    static std::uint32_t slotOf(const Posting &termOfItem);
+    static float fieldWeight(std::uint8_t fields);
+};
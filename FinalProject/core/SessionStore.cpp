@@ -0,0 +1,109 @@
+#include "SessionStore.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <random>
+
+namespace
+{
+// 128 random bits as hex.
+std::string newToken()
+{
+    static thread_local std::random_device device;
+    static const char kDigits[] = "0123456789abcdef";
+    std::string token;
+    token.reserve(32);
+    for (int word = 0; word < 4; ++word)
+    {
+        std::uint32_t bits = device();
+        for (int i = 0; i < 8; ++i, bits >>= 4)
+        {
+            token.push_back(kDigits[bits & 0xF]);
+        }
+    }
+    return token;
+}
+} // namespace
+
+SessionStore::SessionStore(SessionLimits limits)
+    : m_limits(limits)
+{
+}
+
+Session SessionStore::open(Session session, Clock::time_point now)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (now >= m_nextSweep || m_sessions.size() >= m_limits.maxSessions)
+    {
+        sweep(now);
+    }
+    // Only reached with every session in use; the scan is no worse than the sweep above.
+    while (!m_sessions.empty() && m_sessions.size() >= m_limits.maxSessions)
+    {
+        const auto oldest = std::min_element(m_sessions.begin(), m_sessions.end(), [](const auto &a, const auto &b) {
+            return a.second.lastUsed < b.second.lastUsed;
+        });
+        m_sessions.erase(oldest);
+    }
+
+    do
+    {
+        session.token = newToken();
+    } while (m_sessions.count(session.token) != 0);
+    m_sessions.emplace(session.token, Entry{session, now});
+    return session;
+}
+
+std::optional<Session> SessionStore::find(const std::string &token, Clock::time_point now) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const auto it = m_sessions.find(token);
+    if (it == m_sessions.end())
+    {
+        return std::nullopt;
+    }
+    if (now - it->second.lastUsed >= m_limits.idleTimeout)
+    {
+        m_sessions.erase(it);
+        return std::nullopt;
+    }
+    it->second.lastUsed = std::max(it->second.lastUsed, now);
+    return it->second.session;
+}
+
+void SessionStore::close(const std::string &token)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_sessions.erase(token);
+}
+
+std::size_t SessionStore::size() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_sessions.size();
+}
+
+void SessionStore::setLimits(const SessionLimits &limits)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_limits = limits;
+    m_nextSweep = {};
+}
+
+SessionLimits SessionStore::limits() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_limits;
+}
+
+// Called with the lock held. Runs at most once per idle timeout unless the store is full,
+// which keeps its cost proportional to the sessions opened in between.
+void SessionStore::sweep(Clock::time_point now)
+{
+    for (auto it = m_sessions.begin(); it != m_sessions.end();)
+    {
+        it = now - it->second.lastUsed >= m_limits.idleTimeout ? m_sessions.erase(it) : std::next(it);
+    }
+    m_nextSweep = now + m_limits.idleTimeout;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+// What a signed-in client is, resolved once at sign-in so later calls need no user or
+// profile lookups. Per-session state belongs here as well.
+struct Session
+{
+    std::string token;
+    std::string identifier;
+    std::string role;
+    int userId{};
+    int profileId{};
+};
+
+struct SessionLimits
+{
+    // A session unused for this long is gone; every find() restarts the clock.
+    std::chrono::seconds idleTimeout = std::chrono::hours(12);
+    // Opening one more evicts the least recently used session.
+    std::size_t maxSessions = 10000;
+};
+
+// Live sessions by token. Safe to use from any thread. Sessions that clients never close
+// expire once idle, and expired ones are swept while opening new sessions, so the store
+// stays bounded by the limits rather than by how many sign-ins there have been.
+class SessionStore
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit SessionStore(SessionLimits limits = SessionLimits());
+
+    // Issues a fresh random token for session and stores it.
+    Session open(Session session, Clock::time_point now = Clock::now());
+    std::optional<Session> find(const std::string &token, Clock::time_point now = Clock::now()) const;
+    void close(const std::string &token);
+    std::size_t size() const;
+
+    void setLimits(const SessionLimits &limits);
+    SessionLimits limits() const;
+
+private:
+    struct Entry
+    {
+        Session session;
+        Clock::time_point lastUsed;
+    };
+
+    mutable std::mutex m_mutex;
+    SessionLimits m_limits;
+    // Last use is bookkeeping, so lookups may refresh it.
+    mutable std::unordered_map<std::string, Entry> m_sessions;
+    Clock::time_point m_nextSweep{};
+
+    void sweep(Clock::time_point now);
+};
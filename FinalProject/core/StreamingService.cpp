@@ -1,75 +1,243 @@
 #include "StreamingService.h"
 
+#include "Trace.h"
+
 #include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
 #include <utility>
 
 StreamingService::StreamingService(std::unique_ptr<IDataProvider> provider)
     : m_provider(std::move(provider))
+    , m_snapshot(std::make_shared<const CatalogSnapshot>())
 {
-    reload();
 }
 
 void StreamingService::reload()
 {
-    m_categories.clear();
-    m_featured = {};
+    TRACE_SCOPE("StreamingService::reload");
+    publish(buildSnapshot());
+}
+
+StreamingService::Snapshot StreamingService::buildSnapshot(const std::function<bool()> &isCancelled) const
+{
+    TRACE_SCOPE("StreamingService::buildSnapshot");
+    const auto cancelled = [&isCancelled]() { return isCancelled && isCancelled(); };
 
+    auto snapshot = std::make_shared<CatalogSnapshot>();
     if (!m_provider)
     {
-        return;
+        return snapshot;
+    }
+
+    const auto categories = [this]() {
+        TRACE_SCOPE("StreamingService::fetchCategories");
+        return m_provider->fetchCategories();
+    }();
+    if (cancelled())
+    {
+        return nullptr;
     }
 
-    const auto categories = m_provider->fetchCategories();
-    m_categories.reserve(categories.size());
+#if FINALPROJECT_TRACING
+    Trace::Span rowsSpan("StreamingService::buildRows");
+#endif
+    snapshot->strings = std::make_shared<StringPool>();
+    StringPool &strings = *snapshot->strings;
+    std::unordered_map<int, std::uint32_t> indexById;
+    const auto indexOf = [&](const RawMediaItem &raw) {
+        const auto next = static_cast<std::uint32_t>(snapshot->items.size());
+        if (raw.id > 0)
+        {
+            const auto [it, inserted] = indexById.try_emplace(raw.id, next);
+            if (!inserted)
+            {
+                return it->second;
+            }
+        }
+        snapshot->items.push_back(std::make_shared<const MediaItem>(toMediaItem(raw, strings)));
+        return next;
+    };
+
+    snapshot->categories.reserve(categories.size());
     for (const auto &category : categories)
     {
+        if (cancelled())
+        {
+            return nullptr;
+        }
+
         MediaCategory mediaCategory;
-        mediaCategory.name = category.category.name;
+        mediaCategory.id = category.category.id;
+        mediaCategory.name = strings.intern(category.category.name);
         mediaCategory.items.reserve(category.items.size());
         for (const auto &rawItem : category.items)
         {
-            mediaCategory.items.push_back(toMediaItem(rawItem));
+            mediaCategory.items.push_back(indexOf(rawItem));
         }
 
         if (!mediaCategory.items.empty())
         {
-            m_categories.push_back(std::move(mediaCategory));
+            snapshot->categories.push_back(std::move(mediaCategory));
         }
     }
 
-    const auto featured = m_provider->fetchFeatured();
+#if FINALPROJECT_TRACING
+    rowsSpan.end();
+#endif
+
+    const auto featured = [this]() {
+        TRACE_SCOPE("StreamingService::fetchFeatured");
+        return m_provider->fetchFeatured();
+    }();
+    if (cancelled())
+    {
+        return nullptr;
+    }
+
     if (featured.has_value())
     {
-        m_featured = toMediaItem(*featured);
+        snapshot->featured = indexOf(*featured);
+    }
+    else if (!snapshot->categories.empty() && !snapshot->categories.front().items.empty())
+    {
+        snapshot->featured = snapshot->categories.front().items.front();
+    }
+
+    return snapshot;
+}
+
+void StreamingService::publish(Snapshot snapshot)
+{
+    TRACE_SCOPE("StreamingService::publish");
+    if (!snapshot)
+    {
+        return;
     }
-    else if (!m_categories.empty() && !m_categories.front().items.empty())
+    std::atomic_store(&m_snapshot, std::move(snapshot));
+}
+
+CatalogDelta StreamingService::insertTitles(const std::vector<TitleWithGenres> &titles)
+{
+    TRACE_SCOPE("StreamingService::insertTitles");
+    CatalogDelta delta;
+    if (titles.empty())
     {
-        m_featured = m_categories.front().items.front();
+        return delta;
     }
+
+    // Copying the snapshot copies record pointers and row indices only; the records
+    // themselves are shared with the previous snapshot.
+    auto next = std::make_shared<CatalogSnapshot>(*snapshot());
+    if (!next->strings)
+    {
+        next->strings = std::make_shared<StringPool>();
+    }
+    StringPool &strings = *next->strings;
+
+    const auto rowOrder = [](const MediaCategory &lhs, const MediaCategory &rhs) {
+        const int order = textOf(lhs.name).compare(textOf(rhs.name));
+        return order != 0 ? order < 0 : lhs.id < rhs.id;
+    };
+
+    std::unordered_set<int> created;
+    for (const auto &title : titles)
+    {
+        for (const auto &genre : title.genres)
+        {
+            const bool known = std::any_of(next->categories.begin(), next->categories.end(),
+                                           [&genre](const MediaCategory &row) { return row.id == genre.id; });
+            if (known || created.count(genre.id) != 0)
+            {
+                continue;
+            }
+
+            MediaCategory row;
+            row.id = genre.id;
+            row.name = strings.intern(genre.name);
+            next->categories.insert(std::upper_bound(next->categories.begin(), next->categories.end(), row, rowOrder),
+                                    std::move(row));
+            created.insert(genre.id);
+        }
+    }
+
+    std::unordered_map<int, std::uint32_t> rowById;
+    for (std::uint32_t row = 0; row < next->categories.size(); ++row)
+    {
+        rowById.emplace(next->categories[row].id, row);
+    }
+
+    // Newest first within each row, matching the provider's created_at DESC ordering.
+    std::unordered_map<std::uint32_t, std::vector<std::uint32_t>> additions;
+    for (const auto &title : titles)
+    {
+        RawMediaItem raw = title.item;
+        const auto primary = std::min_element(title.genres.begin(), title.genres.end(),
+                                              [](const RawCategory &lhs, const RawCategory &rhs) { return lhs.name < rhs.name; });
+        if (primary != title.genres.end())
+        {
+            raw.genre = primary->name;
+        }
+
+        const auto index = static_cast<std::uint32_t>(next->items.size());
+        next->items.push_back(std::make_shared<const MediaItem>(toMediaItem(raw, strings)));
+        next->featured = index;
+
+        for (const auto &genre : title.genres)
+        {
+            auto &rowAdditions = additions[rowById.at(genre.id)];
+            rowAdditions.insert(rowAdditions.begin(), index);
+        }
+    }
+
+    for (std::uint32_t row = 0; row < next->categories.size(); ++row)
+    {
+        const auto it = additions.find(row);
+        if (it == additions.end())
+        {
+            continue;
+        }
+
+        auto &items = next->categories[row].items;
+        items.insert(items.begin(), it->second.begin(), it->second.end());
+        if (created.count(next->categories[row].id) != 0)
+        {
+            delta.insertedCategories.push_back(row);
+        }
+        else
+        {
+            delta.insertedItems.push_back({row, 0, static_cast<std::uint32_t>(it->second.size())});
+        }
+    }
+
+    delta.featuredChanged = true;
+    publish(std::move(next));
+    return delta;
 }
 
-const MediaItem &StreamingService::featuredItem() const
+StreamingService::Snapshot StreamingService::snapshot() const
 {
-    return m_featured;
+    return std::atomic_load(&m_snapshot);
 }
 
-const std::vector<MediaCategory> &StreamingService::categories() const
+std::optional<std::uint64_t> StreamingService::catalogVersion() const
 {
-    return m_categories;
+    return m_provider ? m_provider->catalogVersion() : std::nullopt;
 }
 
-MediaItem StreamingService::toMediaItem(const RawMediaItem &raw) const
+MediaItem StreamingService::toMediaItem(const RawMediaItem &raw, StringPool &strings) const
 {
     MediaItem item;
-    item.type = raw.type;
+    item.id = raw.id;
+    item.type = strings.intern(raw.type);
     item.title = raw.title;
-    item.genre = raw.genre;
+    item.genre = strings.intern(raw.genre);
     item.description = raw.description;
-    item.rating = raw.rating;
-    item.duration = formatDuration(raw.durationMinutes);
-    item.accentColor = raw.accentColor;
-    item.thumbnailUrl = raw.thumbnailUrl;
-    item.videoUrl = raw.videoUrl;
+    item.rating = strings.intern(raw.rating);
+    item.duration = strings.intern(formatDuration(raw.durationMinutes));
+    item.accentColor = strings.intern(raw.accentColor);
+    item.thumbnailUrl = MediaUrl::split(raw.thumbnailUrl, strings);
+    item.videoUrl = MediaUrl::split(raw.videoUrl, strings);
     return item;
 }
 
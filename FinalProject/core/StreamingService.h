@@ -2,23 +2,74 @@
 
 #include "DataProvider.h"
 
+#include <functional>
 #include <memory>
 
+// One canonical record per title; category rows refer to titles by index into items.
+struct CatalogSnapshot
+{
+    std::vector<std::shared_ptr<const MediaItem>> items;
+    std::vector<MediaCategory> categories;
+    std::optional<std::uint32_t> featured;
+
+    // Interning state carried forward when a snapshot is derived from this one. Only the
+    // thread that publishes snapshots may touch it.
+    std::shared_ptr<StringPool> strings;
+
+    const MediaItem &item(std::uint32_t index) const { return *items[index]; }
+    const MediaItem *featuredItem() const { return featured ? items[*featured].get() : nullptr; }
+};
+
+// Describes how a published snapshot differs from its predecessor after insertTitles.
+// Row numbers refer to the new snapshot; new categories are listed in ascending order and
+// already contain their items.
+struct CatalogDelta
+{
+    struct RowInsert
+    {
+        std::uint32_t category{};
+        std::uint32_t first{};
+        std::uint32_t count{};
+    };
+
+    std::vector<std::uint32_t> insertedCategories;
+    std::vector<RowInsert> insertedItems;
+    bool featuredChanged = false;
+
+    bool empty() const { return insertedCategories.empty() && insertedItems.empty() && !featuredChanged; }
+};
+
 class StreamingService
 {
 public:
+    using Snapshot = std::shared_ptr<const CatalogSnapshot>;
+
     explicit StreamingService(std::unique_ptr<IDataProvider> provider);
 
+    // Builds and publishes a snapshot on the calling thread.
     void reload();
 
-    const MediaItem &featuredItem() const;
-    const std::vector<MediaCategory> &categories() const;
+    // Reads the provider and builds a detached snapshot without publishing it. Safe to call
+    // from a worker thread as long as only one build runs at a time. Returns nullptr when
+    // isCancelled reports true part-way through.
+    Snapshot buildSnapshot(const std::function<bool()> &isCancelled = {}) const;
+    void publish(Snapshot snapshot);
+
+    // Adds freshly created titles (ordered oldest to newest) to the published snapshot
+    // without going back to the provider. Each title lands at the front of its genre rows,
+    // unknown genres get new rows, and the newest title becomes the featured item.
+    CatalogDelta insertTitles(const std::vector<TitleWithGenres> &titles);
+
+    // Readers keep the returned snapshot alive; it never changes after publication.
+    Snapshot snapshot() const;
+
+    // The provider's catalog change counter; see IDataProvider::catalogVersion.
+    std::optional<std::uint64_t> catalogVersion() const;
 
 private:
     std::unique_ptr<IDataProvider> m_provider;
-    MediaItem m_featured;
-    std::vector<MediaCategory> m_categories;
+    Snapshot m_snapshot;
 
-    MediaItem toMediaItem(const RawMediaItem &raw) const;
+    MediaItem toMediaItem(const RawMediaItem &raw, StringPool &strings) const;
     static std::string formatDuration(int minutes);
 };
@@ -0,0 +1,260 @@
+#include "Trace.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Trace
+{
+namespace detail
+{
+std::atomic<bool> g_enabled{false};
+}
+}
+
+namespace
+{
+struct Event
+{
+    const char *name;
+    const char *category;
+    std::int64_t startNs;
+    std::int64_t durationNs;
+    char detail[Trace::kDetailSize];
+};
+
+// Written only by its own thread; the mutex is there for export and clear, so it is
+// uncontended on the hot path.
+struct Buffer
+{
+    std::mutex mutex;
+    std::vector<Event> events;
+    std::uint64_t written = 0;
+    int threadId = 0;
+};
+
+struct Registry
+{
+    std::mutex mutex;
+    std::vector<std::shared_ptr<Buffer>> buffers;
+    // Buffers of exited threads. Their spans stay exportable until a new thread takes the
+    // buffer over or clear() frees it, so pool threads that come and go reuse a bounded set.
+    std::vector<std::shared_ptr<Buffer>> idle;
+    int nextThreadId = 1;
+};
+
+Registry &registry()
+{
+    // Never destroyed: threads may still exit after static destruction has begun.
+    static Registry *instance = new Registry;
+    return *instance;
+}
+
+std::int64_t nowNs()
+{
+    static const auto origin = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - origin).count();
+}
+
+// Owns the calling thread's buffer and hands it back to the registry when the thread exits.
+struct ThreadSlot
+{
+    std::shared_ptr<Buffer> buffer;
+
+    ~ThreadSlot()
+    {
+        if (buffer)
+        {
+            Registry &all = registry();
+            std::lock_guard<std::mutex> lock(all.mutex);
+            all.idle.push_back(std::move(buffer));
+        }
+    }
+};
+
+Buffer &threadBuffer()
+{
+    thread_local ThreadSlot slot;
+    if (!slot.buffer)
+    {
+        Registry &all = registry();
+        std::lock_guard<std::mutex> lock(all.mutex);
+        if (!all.idle.empty())
+        {
+            slot.buffer = std::move(all.idle.back());
+            all.idle.pop_back();
+        }
+        else
+        {
+            slot.buffer = std::make_shared<Buffer>();
+            slot.buffer->events.resize(Trace::kCapacity);
+            slot.buffer->threadId = all.nextThreadId++;
+            all.buffers.push_back(slot.buffer);
+        }
+    }
+    return *slot.buffer;
+}
+
+void appendEscaped(std::string &out, const char *text)
+{
+    for (const char *c = text; *c; ++c)
+    {
+        switch (*c)
+        {
+        case '"':
+            out += "\\\"";
+            break;
+        case '\\':
+            out += "\\\\";
+            break;
+        case '\n':
+            out += "\\n";
+            break;
+        case '\t':
+            out += "\\t";
+            break;
+        default:
+            if (static_cast<unsigned char>(*c) < 0x20)
+            {
+                char escaped[8];
+                std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned>(*c));
+                out += escaped;
+            }
+            else
+            {
+                out += *c;
+            }
+        }
+    }
+}
+
+void appendMicros(std::string &out, std::int64_t ns)
+{
+    char number[32];
+    std::snprintf(number, sizeof(number), "%.3f", static_cast<double>(ns) / 1000.0);
+    out += number;
+}
+} // namespace
+
+namespace Trace
+{
+void setEnabled(bool enabled)
+{
+    detail::g_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void clear()
+{
+    Registry &all = registry();
+    std::lock_guard<std::mutex> lock(all.mutex);
+    for (const auto &buffer : all.idle)
+    {
+        all.buffers.erase(std::find(all.buffers.begin(), all.buffers.end(), buffer));
+    }
+    all.idle.clear();
+    for (const auto &buffer : all.buffers)
+    {
+        std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+        buffer->written = 0;
+    }
+}
+
+std::string chromeJson()
+{
+    std::vector<std::shared_ptr<Buffer>> buffers;
+    {
+        Registry &all = registry();
+        std::lock_guard<std::mutex> lock(all.mutex);
+        buffers = all.buffers;
+    }
+
+    std::string out = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    std::vector<Event> events;
+    for (const auto &buffer : buffers)
+    {
+        {
+            std::lock_guard<std::mutex> lock(buffer->mutex);
+            const std::uint64_t count = std::min<std::uint64_t>(buffer->written, kCapacity);
+            events.clear();
+            for (std::uint64_t i = buffer->written - count; i < buffer->written; ++i)
+            {
+                events.push_back(buffer->events[i % kCapacity]);
+            }
+        }
+
+        out += first ? "" : ",";
+        first = false;
+        out += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" + std::to_string(buffer->threadId)
+               + ",\"args\":{\"name\":\"thread " + std::to_string(buffer->threadId) + "\"}}";
+        for (const Event &event : events)
+        {
+            out += ",{\"name\":\"";
+            appendEscaped(out, event.name);
+            out += "\",\"cat\":\"";
+            appendEscaped(out, event.category);
+            out += "\",\"ph\":\"X\",\"pid\":1,\"tid\":" + std::to_string(buffer->threadId) + ",\"ts\":";
+            appendMicros(out, event.startNs);
+            out += ",\"dur\":";
+            appendMicros(out, event.durationNs);
+            if (event.detail[0])
+            {
+                out += ",\"args\":{\"detail\":\"";
+                appendEscaped(out, event.detail);
+                out += "\"}";
+            }
+            out += "}";
+        }
+    }
+    out += "]}\n";
+    return out;
+}
+
+bool writeChromeJson(const std::string &path)
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file << chromeJson();
+    return static_cast<bool>(file);
+}
+
+void Span::setDetail(std::string_view detail)
+{
+    if (!m_name)
+    {
+        return;
+    }
+    const std::size_t size = std::min(detail.size(), kDetailSize - 1);
+    std::memcpy(m_detail, detail.data(), size);
+    m_detail[size] = '\0';
+}
+
+void Span::begin(const char *name, const char *category)
+{
+    m_name = name;
+    m_category = category;
+    m_detail[0] = '\0';
+    m_startNs = nowNs();
+}
+
+void Span::finish()
+{
+    const std::int64_t endNs = nowNs();
+    Buffer &buffer = threadBuffer();
+    {
+        std::lock_guard<std::mutex> lock(buffer.mutex);
+        Event &event = buffer.events[buffer.written % kCapacity];
+        event.name = m_name;
+        event.category = m_category;
+        event.startNs = m_startNs;
+        event.durationNs = endNs - m_startNs;
+        std::memcpy(event.detail, m_detail, kDetailSize);
+        ++buffer.written;
+    }
+    m_name = nullptr;
+}
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// Scoped timing spans collected into per-thread ring buffers and exported as Chrome trace
+// JSON, which chrome://tracing and ui.perfetto.dev open directly. Each thread keeps its most
+// recent kCapacity spans; the buffer of a thread that exits passes to the next new thread, so
+// memory follows the number of live threads. Spans cost one relaxed load while tracing is
+// off, and nothing at all when built with FINALPROJECT_TRACING=0.
+#ifndef FINALPROJECT_TRACING
+#define FINALPROJECT_TRACING 1
+#endif
+
+namespace Trace
+{
+constexpr std::size_t kCapacity = 8192;
+// Longer details, such as SQL text, are cut to this many bytes.
+constexpr std::size_t kDetailSize = 96;
+
+namespace detail
+{
+extern std::atomic<bool> g_enabled;
+}
+
+inline bool enabled()
+{
+    return detail::g_enabled.load(std::memory_order_relaxed);
+}
+
+void setEnabled(bool enabled);
+
+// Drops every span collected so far and frees the buffers of threads that have exited.
+void clear();
+
+// Writes the collected spans of every thread, including threads that have exited.
+std::string chromeJson();
+bool writeChromeJson(const std::string &path);
+
+// Times the enclosing scope, or until end(). name and category must outlive the trace:
+// pass string literals.
+class Span
+{
+public:
+    explicit Span(const char *name, const char *category = "app")
+    {
+        if (enabled())
+        {
+            begin(name, category);
+        }
+    }
+    ~Span() { end(); }
+
+    Span(const Span &) = delete;
+    Span &operator=(const Span &) = delete;
+
+    // True while recording; check before building an expensive detail.
+    explicit operator bool() const { return m_name != nullptr; }
+
+    void setDetail(std::string_view detail);
+    void end()
+    {
+        if (m_name)
+        {
+            finish();
+        }
+    }
+
+private:
+    const char *m_name = nullptr;
+    const char *m_category = nullptr;
+    std::int64_t m_startNs = 0;
+    // Left uninitialised so a disabled span costs no more than the enabled() check.
+    char m_detail[kDetailSize];
+
+    void begin(const char *name, const char *category);
+    void finish();
+};
+}
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+
+#if FINALPROJECT_TRACING
+#define TRACE_SCOPE(name) ::Trace::Span TRACE_CONCAT(traceSpan, __LINE__)(name)
+#define TRACE_SCOPE_CATEGORY(name, category) ::Trace::Span TRACE_CONCAT(traceSpan, __LINE__)(name, category)
+#else
+#define TRACE_SCOPE(name) ((void)0)
+#define TRACE_SCOPE_CATEGORY(name, category) ((void)0)
+#endif
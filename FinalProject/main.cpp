@@ -8,6 +8,9 @@
 #include <cstdio>
 
 #include "backend/Backend.h"
+#include "backend/MetricsServer.h"
+#include "backend/ThumbnailProvider.h"
+#include "core/Metrics.h"
 
 namespace
 {
@@ -37,10 +40,41 @@ int main(int argc, char *argv[])
     qInstallMessageHandler(logMessage);
 
     Backend backend(Backend::createSqlProvider());
+    // Set FINALPROJECT_CALL_TRACE to a file path to record this session for CallReplay.
+    const QString callTrace = qEnvironmentVariable("FINALPROJECT_CALL_TRACE");
+    if (!callTrace.isEmpty())
+    {
+        backend.startCallRecording(callTrace);
+    }
+    // Set FINALPROJECT_TRACE to a file path to collect spans and write them there on exit.
+    const QString spanTrace = qEnvironmentVariable("FINALPROJECT_TRACE");
+    if (!spanTrace.isEmpty())
+    {
+        backend.setTracingEnabled(true);
+        QObject::connect(&app, &QCoreApplication::aboutToQuit, &backend, [&backend, spanTrace]() {
+            backend.writeTrace(spanTrace);
+        });
+    }
+    backend.loadCachedCatalog();
     backend.reload();
 
     QQmlApplicationEngine engine;
     engine.rootContext()->setContextProperty(QStringLiteral("backend"), &backend);
+    auto *thumbnails = new ThumbnailProvider;
+    engine.addImageProvider(QStringLiteral("thumbnails"), thumbnails);
+
+    // Set FINALPROJECT_METRICS_PORT to serve GET /metrics on localhost for scrapers.
+    MetricsServer metrics;
+    const QString metricsPort = qEnvironmentVariable("FINALPROJECT_METRICS_PORT");
+    if (!metricsPort.isEmpty() && metrics.listen(static_cast<quint16>(metricsPort.toUInt())))
+    {
+        metrics.setBeforeScrape([&backend, thumbnails]() {
+            backend.updateMetrics();
+            const ThumbnailCacheStats cache = thumbnails->stats();
+            Metrics::gauge("finalproject_image_cache_bytes", "Decoded thumbnails held in memory").set(cache.cachedBytes);
+            Metrics::gauge("finalproject_image_cache_budget_bytes", "Thumbnail cache budget").set(cache.budgetBytes);
+        });
+    }
 
     const QUrl url(QStringLiteral("qrc:/qt/qml/finalproject/main.qml"));
     QObject::connect(&engine, &QQmlApplicationEngine::warnings, [](const QList<QQmlError> &warnings) {
@@ -13,6 +13,7 @@ Window {
     property string activeAuthMode: "login"
     property string activePage: "home"
     property string activeUserIdentifier: ""
+    property string sessionToken: ""
     property bool showFullPlayer: false
     property string fullPlayerUrl: ""
     property bool showSubPrompt: false
@@ -57,6 +58,7 @@ Window {
                 root.activePage = "profile"
             }
         }
+        onPlayRequested: function(url, titleId) { root.handlePlay(url, titleId) }
     }
 
     HomePage {
@@ -67,9 +69,9 @@ Window {
         anchors.bottom: parent.bottom
         visible: root.authenticated && root.activeRole !== "admin" && root.activePage === "home"
         heroItem: backend.heroItem
-        categoriesModel: backend.categories
-        userEmail: root.activeUserIdentifier
-        playHandler: function(url) { if (url && url.length > 0) root.handlePlay(url) }
+        categoriesModel: backend.catalog
+        sessionToken: root.sessionToken
+        playHandler: function(url, titleId) { if (url && url.length > 0) root.handlePlay(url, titleId) }
     }
 
     SeriesPage {
@@ -79,9 +81,9 @@ Window {
         anchors.right: parent.right
         anchors.bottom: parent.bottom
         visible: root.authenticated && root.activeRole !== "admin" && root.activePage === "series"
-        categoriesModel: backend.categories
-        userEmail: root.activeUserIdentifier
-        playHandler: function(url) { if (url && url.length > 0) root.handlePlay(url) }
+        categoriesModel: backend.seriesCatalog
+        sessionToken: root.sessionToken
+        playHandler: function(url, titleId) { if (url && url.length > 0) root.handlePlay(url, titleId) }
     }
 
     MoviesPage {
@@ -91,9 +93,9 @@ Window {
         anchors.right: parent.right
         anchors.bottom: parent.bottom
         visible: root.authenticated && root.activeRole !== "admin" && root.activePage === "movies"
-        categoriesModel: backend.categories
-        userEmail: root.activeUserIdentifier
-        playHandler: function(url) { if (url && url.length > 0) root.handlePlay(url) }
+        categoriesModel: backend.movieCatalog
+        sessionToken: root.sessionToken
+        playHandler: function(url, titleId) { if (url && url.length > 0) root.handlePlay(url, titleId) }
     }
 
     MyListPage {
@@ -103,7 +105,7 @@ Window {
         anchors.right: parent.right
         anchors.bottom: parent.bottom
         visible: root.authenticated && root.activeRole !== "admin" && root.activePage === "mylist"
-        userEmail: root.activeUserIdentifier
+        sessionToken: root.sessionToken
     }
 
     AdminPage {
@@ -123,6 +125,7 @@ Window {
         anchors.bottom: parent.bottom
         visible: root.authenticated && root.activeRole !== "admin" && root.activePage === "profile"
         userEmail: root.activeUserIdentifier
+        sessionToken: root.sessionToken
     }
 
     LoginPage {
@@ -130,11 +133,12 @@ Window {
         anchors.fill: parent
         visible: !root.authenticated
         z: 2
-        onLoginSucceeded: function(mode, role, identifier) {
+        onLoginSucceeded: function(mode, role, identifier, token) {
             root.activeAuthMode = mode
             root.activeRole = role
             root.authenticated = true
             root.activeUserIdentifier = identifier
+            root.sessionToken = token
             if (role !== "admin") {
                 root.activePage = "home"
             }
@@ -149,7 +153,7 @@ Window {
         fullVideo.play()
     }
 
-    function handlePlay(url, title) {
+    function handlePlay(url, titleId) {
         if (!url || url.length === 0) return
         if (!root.authenticated) {
             startFullPlayer(url)
@@ -159,14 +163,20 @@ Window {
             startFullPlayer(url)
             return
         }
-        const profile = backend.userProfile(root.activeUserIdentifier) || {}
-        if (profile.subscription && profile.subscription.active) {
-            backend.logPlayback(root.activeUserIdentifier, title || "", 0, false)
-            startFullPlayer(url)
-        } else {
-            pendingPlayUrl = url
-            showSubPrompt = true
-        }
+        // A newer play request replaces one still waiting on its entitlement check.
+        backend.cancelRequests("player")
+        const token = root.sessionToken
+        backend.canPlayAsync(token, function(allowed) {
+            if (token !== root.sessionToken)
+                return
+            if (allowed) {
+                backend.logPlayback(token, titleId || 0, 0, false)
+                startFullPlayer(url)
+            } else {
+                pendingPlayUrl = url
+                showSubPrompt = true
+            }
+        }, "player")
     }
 
     Rectangle {
@@ -45,13 +45,13 @@ void StreamingDataModel::loadData()
         "FROM titles t LEFT JOIN media_files m ON m.title_id = t.id "
         "ORDER BY t.created_at DESC LIMIT 1"
     );
-    if (heroQuery.exec(heroSql) && heroQuery.next())
+    if (DatabaseUtils::exec(heroQuery, heroSql) && heroQuery.next())
     {
         m_featured = buildItemFromQuery(heroQuery, heroQuery.value(8).toString());
     }
 
     QSqlQuery genresQuery(db);
-    if (!genresQuery.exec(QStringLiteral("SELECT id, name FROM genres ORDER BY name")))
+    if (!DatabaseUtils::exec(genresQuery, QStringLiteral("SELECT id, name FROM genres ORDER BY name")))
     {
         return;
     }
@@ -102,7 +102,7 @@ QVector<MediaItem> StreamingDataModel::itemsForGenre(int genreId, const QString
         "WHERE tg.genre_id = ? ORDER BY t.created_at DESC"));
     query.addBindValue(genreId);
 
-    if (!query.exec())
+    if (!DatabaseUtils::exec(query))
     {
         return items;
     }
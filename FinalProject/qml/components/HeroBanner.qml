@@ -2,6 +2,7 @@ import QtQuick 2.15
 import QtQuick.Controls 2.15
 import QtQuick.Layouts 1.15
 import "../utils/Formatting.js" as Formatting
+import "../utils/Thumbnails.js" as Thumbnails
 
 Rectangle {
     id: heroBanner
@@ -25,7 +26,9 @@ Rectangle {
 
     Image {
         anchors.fill: parent
-        source: heroItem.thumbnailUrl
+        source: Thumbnails.source(heroItem.thumbnailUrl, "hero")
+        sourceSize: Qt.size(width, height)
+        asynchronous: true
         visible: heroItem && heroItem.thumbnailUrl && heroItem.thumbnailUrl.length > 0
         fillMode: Image.PreserveAspectCrop
         opacity: 0.35
@@ -1,6 +1,7 @@
 import QtQuick 2.15
 import QtQuick.Controls 2.15
 import "../utils/Formatting.js" as Formatting
+import "../utils/Thumbnails.js" as Thumbnails
 
 Item {
     id: mediaCard
@@ -28,7 +29,8 @@ Item {
 
             Image {
                 anchors.fill: parent
-                source: card && card.thumbnailUrl ? card.thumbnailUrl : ""
+                source: Thumbnails.source(card ? card.thumbnailUrl : "", "card")
+                sourceSize: Qt.size(width, height)
                 fillMode: Image.PreserveAspectCrop
                 opacity: 0.95
                 asynchronous: true
@@ -1,6 +1,8 @@
 import QtQuick 2.15
 import QtQuick.Controls 2.15
 import QtQuick.Layouts 1.15
+import "../utils/Formatting.js" as Formatting
+import "../utils/Thumbnails.js" as Thumbnails
 
 Rectangle {
     id: navigationBar
@@ -10,6 +12,7 @@ Rectangle {
     signal openMovies()
     signal openMyList()
     signal openProfile()
+    signal playRequested(string url, int titleId)
     color: Qt.rgba(0, 0, 0, 0.85)
     height: 72
     implicitHeight: height
@@ -87,6 +90,81 @@ Rectangle {
                 radius: 18
                 border.color: Qt.rgba(1, 1, 1, 0.2)
             }
+            onTextChanged: {
+                searchResults.model = text.trim().length > 0 ? backend.search(text, 8) : []
+                if (searchResults.count > 0) searchPopup.open()
+                else searchPopup.close()
+            }
+            Keys.onEscapePressed: searchPopup.close()
+
+            Popup {
+                id: searchPopup
+                y: searchField.height + 8
+                width: 360
+                x: searchField.width - width
+                padding: 6
+                closePolicy: Popup.CloseOnEscape | Popup.CloseOnPressOutsideParent
+                background: Rectangle {
+                    color: "#161B22"
+                    radius: 12
+                    border.color: Qt.rgba(1, 1, 1, 0.12)
+                }
+
+                ListView {
+                    id: searchResults
+                    implicitHeight: contentHeight
+                    width: parent.width
+                    clip: true
+                    interactive: false
+                    delegate: Rectangle {
+                        width: searchResults.width
+                        height: 56
+                        radius: 8
+                        color: resultArea.containsMouse ? Qt.rgba(1, 1, 1, 0.08) : "transparent"
+                        Row {
+                            anchors.fill: parent
+                            anchors.margins: 6
+                            spacing: 10
+                            Image {
+                                width: 72
+                                height: 44
+                                fillMode: Image.PreserveAspectCrop
+                                source: Thumbnails.source(modelData.thumbnailUrl, "list")
+                                sourceSize: Qt.size(width, height)
+                                asynchronous: true
+                            }
+                            Column {
+                                anchors.verticalCenter: parent.verticalCenter
+                                width: parent.width - 82
+                                Text {
+                                    width: parent.width
+                                    text: modelData.title
+                                    color: "white"
+                                    font.weight: Font.DemiBold
+                                    elide: Text.ElideRight
+                                }
+                                Text {
+                                    width: parent.width
+                                    text: Formatting.joinWithBullet(modelData.genre, modelData.duration)
+                                    color: "#9CA3AF"
+                                    font.pixelSize: 12
+                                    elide: Text.ElideRight
+                                }
+                            }
+                        }
+                        MouseArea {
+                            id: resultArea
+                            anchors.fill: parent
+                            hoverEnabled: true
+                            cursorShape: Qt.PointingHandCursor
+                            onClicked: {
+                                searchPopup.close()
+                                navigationBar.playRequested(modelData.videoUrl, modelData.titleId)
+                            }
+                        }
+                    }
+                }
+            }
         }
 
         Button {
@@ -17,21 +17,53 @@ Rectangle {
     property string selectedVideoPath: ""
     property int currentSection: 0 // 0 = add movie, 1 = users
 
+    ListModel { id: uploadsModel }
+
+    function uploadRow(jobId) {
+        for (let i = 0; i < uploadsModel.count; ++i) {
+            if (uploadsModel.get(i).jobId === jobId)
+                return i
+        }
+        return -1
+    }
+
+    Connections {
+        target: backend
+        function onIngestionProgress(jobId, title, copiedBytes, totalBytes) {
+            const fraction = totalBytes > 0 ? copiedBytes / totalBytes : 1
+            const row = uploadRow(jobId)
+            if (row < 0)
+                uploadsModel.append({ jobId: jobId, title: title, progress: fraction })
+            else
+                uploadsModel.setProperty(row, "progress", fraction)
+        }
+        function onIngestionFinished(jobId, title, result) {
+            const row = uploadRow(jobId)
+            if (row >= 0)
+                uploadsModel.remove(row)
+            addStatus.text = title + ": " + (result.message || "")
+        }
+    }
+
     function refreshUsers() {
-        usersModel = backend.listUsers()
+        backend.listUsersAsync(function(users) { usersModel = users || [] }, "admin")
     }
 
     function loadGenres() {
-        genresModel = backend.listGenres() || []
-        if (genreCombo && genresModel.length > 0) {
-            genreCombo.currentIndex = 0
-        }
+        backend.listGenresAsync(function(genres) {
+            genresModel = genres || []
+            if (genreCombo && genresModel.length > 0) {
+                genreCombo.currentIndex = 0
+            }
+        }, "admin")
     }
 
     Component.onCompleted: {
         refreshUsers()
         loadGenres()
     }
+    Component.onDestruction: backend.cancelRequests("admin")
+    onVisibleChanged: if (!visible) backend.cancelRequests("admin")
 
     Platform.FileDialog {
         id: thumbnailDialog
@@ -293,12 +325,13 @@ Rectangle {
                                     verticalAlignment: Text.AlignVCenter
                                 }
                                 onClicked: {
-                                    const response = backend.addGenre(newGenreField.text)
-                                    genreStatus.text = response.message || ""
-                                    if (response.success) {
-                                        newGenreField.text = ""
-                                        loadGenres()
-                                    }
+                                    backend.addGenreAsync(newGenreField.text, function(response) {
+                                        genreStatus.text = response.message || ""
+                                        if (response.success) {
+                                            newGenreField.text = ""
+                                            loadGenres()
+                                        }
+                                    }, "admin")
                                 }
                             }
                             Button {
@@ -424,6 +457,31 @@ Rectangle {
                                 wrapMode: Text.WordWrap
                                 Layout.fillWidth: true
                             }
+
+                            Repeater {
+                                model: uploadsModel
+                                delegate: RowLayout {
+                                    Layout.fillWidth: true
+                                    spacing: 10
+                                    Text {
+                                        text: model.title
+                                        color: "white"
+                                        font.pixelSize: 13
+                                        elide: Text.ElideRight
+                                        Layout.preferredWidth: 180
+                                    }
+                                    ProgressBar {
+                                        from: 0
+                                        to: 1
+                                        value: model.progress
+                                        Layout.fillWidth: true
+                                    }
+                                    Button {
+                                        text: qsTr("Cancel")
+                                        onClicked: backend.cancelIngestion(model.jobId)
+                                    }
+                                }
+                            }
                         }
                     }
                 }
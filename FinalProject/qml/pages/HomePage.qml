@@ -2,18 +2,22 @@ import QtQuick 2.15
 import QtQuick.Controls 2.15
 import QtQuick.Layouts 1.15
 import "../components"
+import "../utils/Thumbnails.js" as Thumbnails
 
 Item {
     id: homePage
     property var heroItem: ({})
-    property var categoriesModel: []
+    property var categoriesModel: null
     property var selectedItem: ({})
     property bool showDetails: false
     readonly property bool isSeries: (selectedItem && selectedItem.type && selectedItem.type.toLowerCase && selectedItem.type.toLowerCase() === "series")
-    property string userEmail: ""
+    property string sessionToken: ""
     property string actionStatus: ""
     property var playHandler: null
 
+    Component.onDestruction: backend.cancelRequests("home")
+    onVisibleChanged: if (!visible) backend.cancelRequests("home")
+
     Flickable {
         id: contentArea
         anchors.fill: parent
@@ -36,11 +40,12 @@ Item {
             }
 
             Repeater {
-                model: homePage.categoriesModel || []
+                model: homePage.categoriesModel
                 delegate: Column {
                     width: contentColumn.width
                     spacing: 12
-                    property var category: modelData || ({})
+                    property string categoryName: model.name || ""
+                    property var categoryItems: model.items
 
                     Item {
                         width: parent.width - contentColumn.horizontalPadding * 2
@@ -49,7 +54,7 @@ Item {
 
                         Text {
                             id: titleLabel
-                            text: category.name || ""
+                            text: categoryName
                             color: "white"
                             font.pixelSize: 20
                             font.bold: true
@@ -64,18 +69,19 @@ Item {
                     }
 
                     ListView {
+                        id: rowView
                         width: parent.width - contentColumn.horizontalPadding * 2
                         height: 320
                         anchors.horizontalCenter: parent.horizontalCenter
                         spacing: 16
                         orientation: ListView.Horizontal
-                        model: category.items || []
+                        model: categoryItems
                         clip: true
                         boundsBehavior: Flickable.StopAtBounds
                         delegate: MediaCard {
-                            card: modelData || ({})
+                            card: model
                             onClicked: {
-                        homePage.selectedItem = modelData || ({})
+                        homePage.selectedItem = rowView.model.get(index)
                         homePage.actionStatus = ""
                         homePage.showDetails = true
                     }
@@ -133,7 +139,9 @@ Item {
                         Image {
                             anchors.fill: parent
                             fillMode: Image.PreserveAspectCrop
-                            source: selectedItem.thumbnailUrl || ""
+                            asynchronous: true
+                            sourceSize: Qt.size(width, height)
+                            source: Thumbnails.source(selectedItem.thumbnailUrl, "card")
                             visible: selectedItem.thumbnailUrl && selectedItem.thumbnailUrl !== ""
                         }
                     }
@@ -216,17 +224,19 @@ Item {
                         enabled: selectedItem && selectedItem.videoUrl && selectedItem.videoUrl.length > 0
                         onClicked: {
                             if (playHandler && selectedItem && selectedItem.videoUrl) {
-                                playHandler(selectedItem.videoUrl, selectedItem.title || "")
+                                playHandler(selectedItem.videoUrl, selectedItem.titleId || 0)
                             }
                         }
                     }
                     Button {
                         text: qsTr("Add to My List")
-                        enabled: userEmail && userEmail.length > 0
+                        enabled: sessionToken.length > 0
                         Layout.preferredWidth: 150
                         onClicked: {
-                            const resp = backend.addToMyList(userEmail, selectedItem.title || "")
-                            actionStatus = resp.message || ""
+                            actionStatus = ""
+                            backend.addToMyListAsync(sessionToken, selectedItem.titleId || 0, function(resp) {
+                                actionStatus = resp.message || ""
+                            }, "home")
                         }
                     }
                     Button {
@@ -6,7 +6,8 @@ Rectangle {
     id: loginPage
     property string mode: "login" // "login" or "signup"
     property string role: "user" // "user" or "admin"
-    signal loginSucceeded(string mode, string role, string identifier)
+    property bool busy: false
+    signal loginSucceeded(string mode, string role, string identifier, string token)
 
     color: "#0B0F1A"
     gradient: Gradient {
@@ -140,18 +141,26 @@ Rectangle {
                     horizontalAlignment: Text.AlignHCenter
                     verticalAlignment: Text.AlignVCenter
                 }
+                enabled: !loginPage.busy
                 onClicked: {
-                    const result = backend.authenticate(loginPage.mode,
-                                                        loginPage.role,
-                                                        emailField.text,
-                                                        passwordField.text,
-                                                        confirmField.text)
-                    statusLabel.text = result.message || ""
-                    if (result.success) {
-                        statusLabel.text = ""
-                        const resolvedRole = result.role || loginPage.role
-                        loginPage.loginSucceeded(loginPage.mode, resolvedRole, emailField.text)
-                    }
+                    const mode = loginPage.mode
+                    const identifier = emailField.text
+                    loginPage.busy = true
+                    backend.authenticateAsync(mode,
+                                              loginPage.role,
+                                              identifier,
+                                              passwordField.text,
+                                              confirmField.text,
+                                              function(result) {
+                                                  loginPage.busy = false
+                                                  statusLabel.text = result.message || ""
+                                                  if (result.success) {
+                                                      statusLabel.text = ""
+                                                      const resolvedRole = result.role || loginPage.role
+                                                      loginPage.loginSucceeded(mode, resolvedRole, identifier, result.token || "")
+                                                  }
+                                              },
+                                              "login")
                 }
             }
 
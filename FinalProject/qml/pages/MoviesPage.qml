@@ -2,31 +2,19 @@ import QtQuick 2.15
 import QtQuick.Controls 2.15
 import QtQuick.Layouts 1.15
 import "../components"
+import "../utils/Thumbnails.js" as Thumbnails
 
 Item {
     id: moviesPage
-    property var categoriesModel: []
-    property string userEmail: ""
+    property var categoriesModel: null
+    property string sessionToken: ""
     property var selectedItem: ({})
     property bool showDetails: false
     property string actionStatus: ""
     property var playHandler: null
 
-    function filteredCategories() {
-        const result = []
-        const list = categoriesModel || []
-        for (let i = 0; i < list.length; i++) {
-            const cat = list[i] || {}
-            const items = (cat.items || []).filter(function(it) {
-                const t = (it.type || "").toLowerCase()
-                return t === "" || t === "movie"
-            })
-            if (items.length > 0) {
-                result.push({ name: cat.name, items: items })
-            }
-        }
-        return result
-    }
+    Component.onDestruction: backend.cancelRequests("movies")
+    onVisibleChanged: if (!visible) backend.cancelRequests("movies")
 
     Flickable {
         id: contentArea
@@ -64,11 +52,12 @@ Item {
             }
 
             Repeater {
-                model: filteredCategories()
+                model: categoriesModel
                 delegate: Column {
                     width: contentColumn.width
                     spacing: 12
-                    property var category: modelData || ({})
+                    property string categoryName: model.name || ""
+                    property var categoryItems: model.items
 
                     Item {
                         width: parent.width - contentColumn.horizontalPadding * 2
@@ -77,7 +66,7 @@ Item {
 
                         Text {
                             id: titleLabel
-                            text: category.name || ""
+                            text: categoryName
                             color: "white"
                             font.pixelSize: 20
                             font.bold: true
@@ -86,18 +75,19 @@ Item {
                     }
 
                     ListView {
+                        id: rowView
                         width: parent.width - contentColumn.horizontalPadding * 2
                         height: 320
                         anchors.horizontalCenter: parent.horizontalCenter
                         spacing: 16
                         orientation: ListView.Horizontal
-                        model: category.items || []
+                        model: categoryItems
                         clip: true
                         boundsBehavior: Flickable.StopAtBounds
                         delegate: MediaCard {
-                            card: modelData || ({})
+                            card: model
                             onClicked: {
-                                selectedItem = modelData || ({})
+                                selectedItem = rowView.model.get(index)
                                 actionStatus = ""
                                 showDetails = true
                             }
@@ -153,7 +143,9 @@ Item {
                         Image {
                             anchors.fill: parent
                             fillMode: Image.PreserveAspectCrop
-                            source: selectedItem.thumbnailUrl || ""
+                            asynchronous: true
+                            sourceSize: Qt.size(width, height)
+                            source: Thumbnails.source(selectedItem.thumbnailUrl, "card")
                             visible: selectedItem.thumbnailUrl && selectedItem.thumbnailUrl !== ""
                         }
                     }
@@ -207,17 +199,19 @@ Item {
                         enabled: selectedItem && selectedItem.videoUrl && selectedItem.videoUrl.length > 0
                         onClicked: {
                             if (playHandler && selectedItem && selectedItem.videoUrl) {
-                                playHandler(selectedItem.videoUrl, selectedItem.title || "")
+                                playHandler(selectedItem.videoUrl, selectedItem.titleId || 0)
                             }
                         }
                     }
                     Button {
                         text: qsTr("Add to My List")
-                        enabled: userEmail && userEmail.length > 0
+                        enabled: sessionToken.length > 0
                         Layout.preferredWidth: 150
                         onClicked: {
-                            const resp = backend.addToMyList(userEmail, selectedItem.title || "")
-                            actionStatus = resp.message || ""
+                            actionStatus = ""
+                            backend.addToMyListAsync(sessionToken, selectedItem.titleId || 0, function(resp) {
+                                actionStatus = resp.message || ""
+                            }, "movies")
                         }
                     }
                     Button {
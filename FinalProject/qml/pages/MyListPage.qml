@@ -11,24 +11,33 @@ Rectangle {
         GradientStop { position: 1.0; color: "#0B0F1A" }
     }
 
-    property string userEmail: ""
+    property string sessionToken: ""
     property var myListModel: []
     property string statusMessage: ""
 
     function refreshList() {
-        if (!userEmail || userEmail.trim() === "")
+        if (sessionToken.length === 0)
             return
-        const resp = backend.userProfile(userEmail)
-        if (resp && resp.myList) {
-            myListModel = resp.myList
-            statusMessage = ""
-        } else {
-            statusMessage = qsTr("Unable to load My List")
-        }
+        backend.userProfileAsync(sessionToken, function(resp) {
+            if (resp && resp.myList) {
+                myListModel = resp.myList
+                statusMessage = ""
+            } else {
+                statusMessage = qsTr("Unable to load My List")
+            }
+        }, "mylist")
     }
 
     Component.onCompleted: refreshList()
-    onUserEmailChanged: refreshList()
+    Component.onDestruction: backend.cancelRequests("mylist")
+    onSessionTokenChanged: refreshList()
+    onVisibleChanged: {
+        if (visible) {
+            refreshList()
+        } else {
+            backend.cancelRequests("mylist")
+        }
+    }
 
     Flickable {
         anchors.fill: parent
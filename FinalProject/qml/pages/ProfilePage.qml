@@ -1,11 +1,14 @@
 import QtQuick 2.15
 import QtQuick.Controls 2.15
 import QtQuick.Layouts 1.15
+import "../utils/Thumbnails.js" as Thumbnails
 
 Rectangle {
     id: profilePage
     property string userEmail: ""
+    property string sessionToken: ""
     property var profileData: ({})
+    property var plansModel: []
 
     color: "#0B0F1A"
     gradient: Gradient {
@@ -14,13 +17,28 @@ Rectangle {
     }
 
     function refreshProfile() {
-        if (!userEmail || userEmail.trim() === "")
+        if (sessionToken.length === 0)
             return
-        profileData = backend.userProfile(userEmail)
+        backend.userProfileAsync(sessionToken, function(resp) { profileData = resp }, "profile")
     }
 
-    onUserEmailChanged: refreshProfile()
-    Component.onCompleted: refreshProfile()
+    function loadPlans() {
+        backend.listPlansAsync(function(plans) { plansModel = plans || [] }, "profile")
+    }
+
+    onSessionTokenChanged: refreshProfile()
+    onVisibleChanged: {
+        if (visible) {
+            refreshProfile()
+        } else {
+            backend.cancelRequests("profile")
+        }
+    }
+    Component.onCompleted: {
+        refreshProfile()
+        loadPlans()
+    }
+    Component.onDestruction: backend.cancelRequests("profile")
 
     Flickable {
         anchors.fill: parent
@@ -176,7 +194,7 @@ Rectangle {
                             ComboBox {
                                 id: planCombo
                                 Layout.fillWidth: true
-                                model: backend.listPlans()
+                                model: profilePage.plansModel
                                 textRole: "name"
                             }
                             Button {
@@ -185,9 +203,10 @@ Rectangle {
                                 onClicked: {
                                     if (planCombo.currentIndex >= 0) {
                                         const plan = planCombo.model[planCombo.currentIndex]
-                                        const resp = backend.subscribePlan(profilePage.userEmail, plan.id)
-                                        statusMessage.text = resp.message || ""
-                                        if (resp.success) refreshProfile()
+                                        backend.subscribePlanAsync(profilePage.sessionToken, plan.id, function(resp) {
+                                            statusMessage.text = resp.message || ""
+                                            if (resp.success) refreshProfile()
+                                        }, "profile")
                                     }
                                 }
                             }
@@ -301,7 +320,9 @@ Rectangle {
                                         Image {
                                             anchors.fill: parent
                                             fillMode: Image.PreserveAspectCrop
-                                            source: modelData.thumbnailUrl || ""
+                                            asynchronous: true
+                                            sourceSize: Qt.size(width, height)
+                                            source: Thumbnails.source(modelData.thumbnailUrl, "list")
                                             visible: (modelData.thumbnailUrl && modelData.thumbnailUrl !== "")
                                         }
                                     }
@@ -361,7 +382,9 @@ Rectangle {
                                         Image {
                                             anchors.fill: parent
                                             fillMode: Image.PreserveAspectCrop
-                                            source: modelData.thumbnailUrl || ""
+                                            asynchronous: true
+                                            sourceSize: Qt.size(width, height)
+                                            source: Thumbnails.source(modelData.thumbnailUrl, "list")
                                             visible: (modelData.thumbnailUrl && modelData.thumbnailUrl !== "")
                                         }
                                     }
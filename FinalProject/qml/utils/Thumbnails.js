@@ -0,0 +1,11 @@
+// Routes a thumbnail through the image://thumbnails provider, which serves a downscaled
+// variant ("list", "card" or "hero") instead of decoding the full-size file.
+function source(url, variant) {
+    if (!url) {
+        return "";
+    }
+    if (url.indexOf("file:") !== 0) {
+        return url;
+    }
+    return "image://thumbnails/" + variant + "/" + url;
+}
@@ -0,0 +1,273 @@
+#include "ConnectionPool.h"
+
+#include "DatabaseUtils.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QSqlError>
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace
+{
+struct CachedStatement
+{
+    explicit CachedStatement(const QSqlDatabase &db)
+        : query(db)
+    {
+        query.setForwardOnly(true);
+    }
+
+    QSqlQuery query;
+    bool prepared = false;
+    bool active = false;
+};
+
+struct ThreadConnection
+{
+    QString name;
+    int depth = 0;
+    // Statements are owned by the thread's connection, so the SQL text alone is the key.
+    // Call sites pass string literals, which keeps the cache bounded without eviction.
+    QHash<QString, std::shared_ptr<CachedStatement>> statements;
+    std::vector<CachedStatement *> active;
+
+    void resetActive()
+    {
+        for (auto *statement : active)
+        {
+            statement->query.finish();
+            statement->active = false;
+        }
+        active.clear();
+    }
+
+    ~ThreadConnection()
+    {
+        if (!name.isEmpty())
+        {
+            ConnectionPool::instance().closeThreadConnection();
+        }
+    }
+};
+
+thread_local ThreadConnection t_connection;
+} // namespace
+
+ConnectionPool::Lease::Lease(ConnectionPool *pool, QSqlDatabase db)
+    : m_pool(pool)
+    , m_db(std::move(db))
+{
+}
+
+ConnectionPool::Lease::Lease(Lease &&other) noexcept
+    : m_pool(std::exchange(other.m_pool, nullptr))
+    , m_db(std::move(other.m_db))
+{
+}
+
+ConnectionPool::Lease &ConnectionPool::Lease::operator=(Lease &&other) noexcept
+{
+    if (this != &other)
+    {
+        release();
+        m_pool = std::exchange(other.m_pool, nullptr);
+        m_db = std::move(other.m_db);
+    }
+    return *this;
+}
+
+ConnectionPool::Lease::~Lease()
+{
+    release();
+}
+
+QSqlQuery &ConnectionPool::Lease::prepare(const QString &sql)
+{
+    Q_ASSERT(m_pool);
+    return m_pool->statement(m_db, sql);
+}
+
+void ConnectionPool::Lease::release()
+{
+    if (m_pool)
+    {
+        m_db = QSqlDatabase();
+        std::exchange(m_pool, nullptr)->release();
+    }
+}
+
+ConnectionPool &ConnectionPool::instance()
+{
+    static ConnectionPool pool;
+    return pool;
+}
+
+void ConnectionPool::setMaxConnections(int maxConnections)
+{
+    QMutexLocker lock(&m_mutex);
+    m_maxConnections = qMax(1, maxConnections);
+    m_available.wakeAll();
+}
+
+ConnectionPool::Lease ConnectionPool::acquire()
+{
+    ThreadConnection &local = t_connection;
+    if (local.depth == 0)
+    {
+        QElapsedTimer timer;
+        timer.start();
+        bool contended = false;
+        {
+            QMutexLocker lock(&m_mutex);
+            while (m_leased >= m_maxConnections)
+            {
+                contended = true;
+                m_available.wait(&m_mutex);
+            }
+            ++m_leased;
+        }
+
+        const auto waitedNs = static_cast<quint64>(timer.nsecsElapsed());
+        ++m_acquisitions;
+        if (contended)
+        {
+            ++m_contended;
+        }
+        m_totalWaitNs += waitedNs;
+        quint64 previousMax = m_maxWaitNs.load();
+        while (waitedNs > previousMax && !m_maxWaitNs.compare_exchange_weak(previousMax, waitedNs))
+        {
+        }
+    }
+    ++local.depth;
+
+    if (local.name.isEmpty())
+    {
+        local.name = QStringLiteral("finalproject-pool-%1").arg(++m_serial);
+    }
+
+    if (QSqlDatabase::contains(local.name))
+    {
+        return Lease(this, QSqlDatabase::database(local.name));
+    }
+
+    QSqlDatabase db = DatabaseUtils::openDatabase(local.name);
+    ++m_open;
+    if (db.isOpen())
+    {
+        configure(db);
+    }
+    return Lease(this, db);
+}
+
+void ConnectionPool::release()
+{
+    ThreadConnection &local = t_connection;
+    if (--local.depth > 0)
+    {
+        return;
+    }
+
+    // Finished statements release their read snapshot so WAL checkpoints can make progress.
+    local.resetActive();
+
+    // Idle connections stay with their thread for reuse unless the pool is over budget.
+    if (m_open.load() > m_maxConnections)
+    {
+        closeThreadConnection();
+    }
+
+    QMutexLocker lock(&m_mutex);
+    --m_leased;
+    m_available.wakeOne();
+}
+
+ConnectionPoolStats ConnectionPool::stats() const
+{
+    ConnectionPoolStats stats;
+    stats.acquisitions = m_acquisitions.load();
+    stats.contendedAcquisitions = m_contended.load();
+    stats.totalWaitNs = m_totalWaitNs.load();
+    stats.maxWaitNs = m_maxWaitNs.load();
+    stats.openConnections = m_open.load();
+    stats.statementHits = m_statementHits.load();
+    stats.statementMisses = m_statementMisses.load();
+
+    QMutexLocker lock(&m_mutex);
+    stats.leasedConnections = m_leased;
+    stats.maxConnections = m_maxConnections;
+    return stats;
+}
+
+void ConnectionPool::closeThreadConnection()
+{
+    ThreadConnection &local = t_connection;
+    if (local.name.isEmpty() || !QSqlDatabase::contains(local.name))
+    {
+        return;
+    }
+
+    local.active.clear();
+    local.statements.clear();
+    {
+        QSqlDatabase db = QSqlDatabase::database(local.name, false);
+        db.close();
+    }
+    QSqlDatabase::removeDatabase(local.name);
+    --m_open;
+}
+
+QSqlQuery &ConnectionPool::statement(const QSqlDatabase &db, const QString &sql)
+{
+    ThreadConnection &local = t_connection;
+    auto &cached = local.statements[sql];
+    if (cached && cached->prepared)
+    {
+        ++m_statementHits;
+        cached->query.finish();
+    }
+    else
+    {
+        ++m_statementMisses;
+        if (!cached)
+        {
+            cached = std::make_shared<CachedStatement>(db);
+        }
+        cached->prepared = cached->query.prepare(sql);
+        if (!cached->prepared)
+        {
+            qWarning() << "Failed to prepare statement:" << sql << cached->query.lastError().text();
+        }
+    }
+
+    if (!cached->active)
+    {
+        cached->active = true;
+        local.active.push_back(cached.get());
+    }
+    return cached->query;
+}
+
+void ConnectionPool::configure(QSqlDatabase &db)
+{
+    static const char *pragmas[] = {
+        "PRAGMA journal_mode = WAL",
+        "PRAGMA synchronous = NORMAL",
+        "PRAGMA busy_timeout = 5000",
+        "PRAGMA mmap_size = 268435456",
+        "PRAGMA cache_size = -16000",
+    };
+
+    for (const char *pragma : pragmas)
+    {
+        QSqlQuery query(db);
+        if (!DatabaseUtils::exec(query, QString::fromLatin1(pragma)))
+        {
+            qWarning() << "Failed to configure connection:" << pragma << query.lastError().text();
+        }
+    }
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <QMutex>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QString>
+#include <QWaitCondition>
+
+#include <atomic>
+
+struct ConnectionPoolStats
+{
+    quint64 acquisitions{};
+    quint64 contendedAcquisitions{};
+    quint64 totalWaitNs{};
+    quint64 maxWaitNs{};
+    int openConnections{};
+    int leasedConnections{};
+    int maxConnections{};
+    quint64 statementHits{};
+    quint64 statementMisses{};
+};
+
+// Hands out SQLite connections that belong to the calling thread. QSqlDatabase handles may
+// only be used on the thread that opened them, so each thread keeps its own connection for
+// as long as it lives; the pool bounds how many threads may hold one at the same time and
+// closes surplus idle connections. Every connection is configured once when it is opened and
+// keeps a cache of its prepared statements keyed by SQL text.
+class ConnectionPool
+{
+public:
+    class Lease
+    {
+    public:
+        Lease() = default;
+        Lease(Lease &&other) noexcept;
+        Lease &operator=(Lease &&other) noexcept;
+        Lease(const Lease &) = delete;
+        Lease &operator=(const Lease &) = delete;
+        ~Lease();
+
+        QSqlDatabase database() const { return m_db; }
+
+        // Returns this connection's compiled statement for sql, preparing it on first use.
+        // Bind values with addBindValue() as usual; the query is reset when handed out again
+        // and when the outermost lease on the thread is released.
+        QSqlQuery &prepare(const QString &sql);
+
+    private:
+        friend class ConnectionPool;
+        Lease(ConnectionPool *pool, QSqlDatabase db);
+
+        void release();
+
+        ConnectionPool *m_pool = nullptr;
+        QSqlDatabase m_db;
+    };
+
+    static ConnectionPool &instance();
+
+    void setMaxConnections(int maxConnections);
+
+    // Blocks while maxConnections other threads hold a lease. Nested acquisitions on the
+    // same thread reuse the outer lease and never wait.
+    Lease acquire();
+
+    ConnectionPoolStats stats() const;
+
+    // Closes the calling thread's connection; called automatically when a thread exits.
+    void closeThreadConnection();
+
+private:
+    ConnectionPool() = default;
+
+    void release();
+    QSqlQuery &statement(const QSqlDatabase &db, const QString &sql);
+    static void configure(QSqlDatabase &db);
+
+    mutable QMutex m_mutex;
+    QWaitCondition m_available;
+    int m_maxConnections = 8;
+    int m_leased = 0;
+
+    std::atomic<int> m_open{0};
+    std::atomic<int> m_serial{0};
+    std::atomic<quint64> m_acquisitions{0};
+    std::atomic<quint64> m_contended{0};
+    std::atomic<quint64> m_totalWaitNs{0};
+    std::atomic<quint64> m_maxWaitNs{0};
+    std::atomic<quint64> m_statementHits{0};
+    std::atomic<quint64> m_statementMisses{0};
+};
@@ -1,105 +1,111 @@
 #include "DatabaseUtils.h"
 
+#include "ConnectionPool.h"
+#include "Migrations.h"
+#include "../core/Metrics.h"
+#include "../core/Trace.h"
+
 #include <QCoreApplication>
 #include <QDebug>
 #include <QDir>
-#include <QFile>
 #include <QFileInfo>
+#include <QHash>
+#include <QMutex>
+#include <QSet>
 #include <QSqlError>
 #include <QSqlQuery>
-#include <QTextStream>
 #include <QUrl>
 
 namespace
 {
 static const char *kDefaultConnectionName = "nebula-shared";
 
-QString findProjectRoot()
+QString &databasePathOverride()
 {
-    QDir dir(QCoreApplication::applicationDirPath());
-    for (int i = 0; i < 6; ++i)
-    {
-        if (dir.exists(QStringLiteral("FinalProject.sln")))
-        {
-            return dir.absolutePath();
-        }
-        if (!dir.cdUp())
-        {
-            break;
-        }
-    }
-    return QCoreApplication::applicationDirPath();
+    static QString path;
+    return path;
 }
 
-bool executeSqlScript(const QString &path, QSqlDatabase &db)
+// Database file that has already been brought up to date in this process.
+QMutex &migrationMutex()
 {
-    QFile file(path);
-    if (!file.exists())
-    {
-        return false;
-    }
-
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
-    {
-        return false;
-    }
-
-    QTextStream stream(&file);
-    QString statement;
-
-    auto executeStatement = [&db](QString stmt) -> bool {
-        stmt = stmt.trimmed();
-        if (stmt.isEmpty())
-        {
-            return true;
-        }
+    static QMutex mutex;
+    return mutex;
+}
 
-        if (stmt.endsWith(QLatin1Char(';')))
-        {
-            stmt.chop(1);
-        }
+QString &migratedDatabasePath()
+{
+    static QString path;
+    return path;
+}
 
-        QSqlQuery query(db);
-        if (!query.exec(stmt))
-        {
-            qWarning() << "SQL error:" << query.lastError().text() << "while executing" << stmt;
-            return false;
-        }
-        return true;
-    };
+// Statements are labelled by their text, so the label set stays bounded as long as values are
+// bound rather than spliced in; past the cap the rest share one "other" series.
+const int kMaxStatementLabels = 256;
+const int kStatementLabelLength = 160;
 
-    while (!stream.atEnd())
+Metrics::Histogram &statementDuration(const QString &sql)
+{
+    thread_local QHash<QString, Metrics::Histogram *> cache;
+    if (Metrics::Histogram *cached = cache.value(sql))
     {
-        const QString line = stream.readLine();
-        const QString trimmed = line.trimmed();
-
-        if (trimmed.startsWith(QStringLiteral("--")) || trimmed.startsWith(QStringLiteral("//")))
-        {
-            continue;
-        }
-
-        statement += line;
-        statement.append(QLatin1Char('\n'));
+        return *cached;
+    }
 
-        if (trimmed.endsWith(QLatin1Char(';')))
+    static QMutex mutex;
+    static QSet<QString> labelled;
+    QString label = sql.simplified().left(kStatementLabelLength);
+    {
+        QMutexLocker lock(&mutex);
+        if (!labelled.contains(label))
         {
-            if (!executeStatement(statement))
+            if (labelled.size() < kMaxStatementLabels)
+            {
+                labelled.insert(label);
+            }
+            else
             {
-                return false;
+                label = QStringLiteral("other");
             }
-            statement.clear();
         }
     }
 
-    if (!statement.trimmed().isEmpty())
+    Metrics::Histogram &histogram = Metrics::histogram("finalproject_sql_statement_duration_seconds",
+                                                       "Time spent executing SQL statements",
+                                                       {{"statement", label.toStdString()}});
+    if (cache.size() >= kMaxStatementLabels)
+    {
+        cache.clear();
+    }
+    cache.insert(sql, &histogram);
+    return histogram;
+}
+
+bool countFailure(bool ok)
+{
+    if (!ok)
+    {
+        static Metrics::Counter &failures = Metrics::counter("finalproject_sql_errors_total", "SQL statements that failed");
+        failures.add();
+    }
+    return ok;
+}
+
+QString findProjectRoot()
+{
+    QDir dir(QCoreApplication::applicationDirPath());
+    for (int i = 0; i < 6; ++i)
     {
-        if (!executeStatement(statement))
+        if (dir.exists(QStringLiteral("FinalProject.sln")))
+        {
+            return dir.absolutePath();
+        }
+        if (!dir.cdUp())
         {
-            return false;
+            break;
         }
     }
-
-    return true;
+    return QCoreApplication::applicationDirPath();
 }
 } // namespace
 
@@ -111,17 +117,27 @@ QString projectRoot()
     return root;
 }
 
-QString schemaFilePath()
-{
-    return QDir(projectRoot()).filePath(QStringLiteral("AdminDashboard/sourcefiles/.sql"));
-}
-
 QString databaseFilePath()
 {
+    if (!databasePathOverride().isEmpty())
+    {
+        return databasePathOverride();
+    }
+
     QDir root(projectRoot());
     return root.filePath(QStringLiteral("FinalProject/data/streaming.db"));
 }
 
+QString catalogSnapshotPath()
+{
+    return databaseFilePath() + QStringLiteral(".catalog");
+}
+
+void setDatabaseFilePath(const QString &path)
+{
+    databasePathOverride() = path;
+}
+
 QString imagesDirectory()
 {
     QDir root(projectRoot());
@@ -150,6 +166,12 @@ QString toAbsoluteMediaPath(const QString &relativePath)
     return base.filePath(relativePath);
 }
 
+QString toRelativeMediaPath(const QString &absolutePath)
+{
+    const QDir base(QDir(projectRoot()).filePath(QStringLiteral("FinalProject")));
+    return base.relativeFilePath(absolutePath);
+}
+
 QString toFileUrl(const QString &relativePath)
 {
     const QString absolute = toAbsoluteMediaPath(relativePath);
@@ -176,30 +198,38 @@ bool ensureStorageDirectories()
 
 bool ensureDatabase()
 {
+    const QString path = databaseFilePath();
+    QMutexLocker lock(&migrationMutex());
+    if (migratedDatabasePath() == path)
+    {
+        return true;
+    }
+
     if (!ensureStorageDirectories())
     {
         return false;
     }
 
-    auto db = openDatabase(QStringLiteral("initializer"));
+    auto connection = ConnectionPool::instance().acquire();
+    QSqlDatabase db = connection.database();
     if (!db.isValid())
     {
         return false;
     }
 
-    if (!db.isOpen() && !db.open())
+    if (!db.isOpen())
     {
         qWarning() << "Unable to open SQLite database" << db.lastError().text();
         return false;
     }
 
-    const QString schemaPath = schemaFilePath();
-    if (!executeSqlScript(schemaPath, db))
+    if (!Migrations::migrate(db))
     {
-        qWarning() << "Failed to execute schema" << schemaPath;
+        qWarning() << "Failed to migrate database" << path;
         return false;
     }
 
+    migratedDatabasePath() = path;
     return true;
 }
 
@@ -227,4 +257,30 @@ QSqlDatabase openDatabase(const QString &connectionName)
     }
     return db;
 }
+
+bool exec(QSqlQuery &query)
+{
+#if FINALPROJECT_TRACING
+    Trace::Span span("sql", "sql");
+    if (span)
+    {
+        span.setDetail(query.lastQuery().toUtf8().toStdString());
+    }
+#endif
+    const Metrics::ScopedTimer timer(statementDuration(query.lastQuery()));
+    return countFailure(query.exec());
+}
+
+bool exec(QSqlQuery &query, const QString &sql)
+{
+#if FINALPROJECT_TRACING
+    Trace::Span span("sql", "sql");
+    if (span)
+    {
+        span.setDetail(sql.toUtf8().toStdString());
+    }
+#endif
+    const Metrics::ScopedTimer timer(statementDuration(sql));
+    return countFailure(query.exec(sql));
+}
 }
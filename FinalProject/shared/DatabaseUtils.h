@@ -3,18 +3,26 @@
 #include <QString>
 #include <QSqlDatabase>
 
+class QSqlQuery;
+
 namespace DatabaseUtils
 {
 QString projectRoot();
-QString schemaFilePath();
 QString databaseFilePath();
+QString catalogSnapshotPath();
+void setDatabaseFilePath(const QString &path);
 QString imagesDirectory();
 QString videosDirectory();
 QString toAbsoluteMediaPath(const QString &relativePath);
+QString toRelativeMediaPath(const QString &absolutePath);
 QString toFileUrl(const QString &relativePath);
 
 bool ensureStorageDirectories();
 bool ensureDatabase();
 QSqlDatabase openDatabase(const QString &connectionName = QString());
+
+// QSqlQuery::exec inside a trace span that carries the statement text.
+bool exec(QSqlQuery &query);
+bool exec(QSqlQuery &query, const QString &sql);
 }
 
@@ -0,0 +1,380 @@
+#include "FileCopy.h"
+
+#include "../core/Trace.h"
+
+#include <fstream>
+#include <optional>
+#include <system_error>
+#include <vector>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#elif defined(__linux__)
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#elif defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/clonefile.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+constexpr std::size_t kChunkBytes = 4u << 20;
+
+using FileCopy::Method;
+using FileCopy::Progress;
+using FileCopy::Result;
+
+bool report(const Progress &progress, std::uint64_t copied, std::uint64_t total)
+{
+    return !progress || progress(copied, total);
+}
+
+Result failure(std::string error)
+{
+    Result result;
+    result.error = std::move(error);
+    return result;
+}
+
+Result success(Method method, std::uint64_t bytes)
+{
+    Result result;
+    result.success = true;
+    result.method = method;
+    result.bytes = bytes;
+    return result;
+}
+
+#if defined(_WIN32)
+bool cloneFile(const std::filesystem::path &, const std::filesystem::path &)
+{
+    return false;
+}
+
+DWORD CALLBACK copyProgress(LARGE_INTEGER total, LARGE_INTEGER transferred, LARGE_INTEGER, LARGE_INTEGER,
+                            DWORD, DWORD, HANDLE, HANDLE, LPVOID data)
+{
+    const auto *progress = static_cast<const Progress *>(data);
+    return report(*progress, static_cast<std::uint64_t>(transferred.QuadPart), static_cast<std::uint64_t>(total.QuadPart))
+               ? PROGRESS_CONTINUE
+               : PROGRESS_CANCEL;
+}
+
+// Returns nothing when the kernel path does not apply, so the caller falls back to a
+// streamed copy; failures that a streamed copy would hit as well are returned as is.
+std::optional<Result> kernelCopy(const std::filesystem::path &source,
+                                 const std::filesystem::path &target,
+                                 std::uint64_t size,
+                                 const Progress &progress)
+{
+    // CopyFileEx lets the file system offload the copy (block cloning on ReFS, server-side
+    // copies on SMB shares) and reports progress through the callback.
+    BOOL cancel = FALSE;
+    if (CopyFileExW(source.c_str(), target.c_str(), copyProgress, const_cast<Progress *>(&progress), &cancel, 0))
+    {
+        return success(Method::Kernel, size);
+    }
+    if (GetLastError() == ERROR_REQUEST_ABORTED)
+    {
+        return failure("Copy cancelled");
+    }
+    return std::nullopt;
+}
+
+bool syncFile(const std::filesystem::path &path)
+{
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_WRITE, 0, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+    const bool flushed = FlushFileBuffers(file) != 0;
+    CloseHandle(file);
+    return flushed;
+}
+#elif defined(__linux__)
+class FileDescriptor
+{
+public:
+    explicit FileDescriptor(int fd)
+        : m_fd(fd)
+    {
+    }
+    ~FileDescriptor()
+    {
+        if (m_fd >= 0)
+        {
+            ::close(m_fd);
+        }
+    }
+    FileDescriptor(const FileDescriptor &) = delete;
+    FileDescriptor &operator=(const FileDescriptor &) = delete;
+
+    int get() const { return m_fd; }
+
+private:
+    int m_fd;
+};
+
+bool cloneFile(const std::filesystem::path &source, const std::filesystem::path &target)
+{
+#ifdef FICLONE
+    // Btrfs, XFS and friends share the extents instead of copying any data.
+    FileDescriptor in(::open(source.c_str(), O_RDONLY | O_CLOEXEC));
+    FileDescriptor out(::open(target.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644));
+    return in.get() >= 0 && out.get() >= 0 && ::ioctl(out.get(), FICLONE, in.get()) == 0;
+#else
+    (void)source;
+    (void)target;
+    return false;
+#endif
+}
+
+std::optional<Result> kernelCopy(const std::filesystem::path &source,
+                                 const std::filesystem::path &target,
+                                 std::uint64_t size,
+                                 const Progress &progress)
+{
+    FileDescriptor in(::open(source.c_str(), O_RDONLY | O_CLOEXEC));
+    if (in.get() < 0)
+    {
+        return failure(std::strerror(errno));
+    }
+    FileDescriptor out(::open(target.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644));
+    if (out.get() < 0)
+    {
+        return failure(std::strerror(errno));
+    }
+
+    std::uint64_t copied = 0;
+    while (copied < size)
+    {
+        const ssize_t written = ::copy_file_range(in.get(), nullptr, out.get(), nullptr, kChunkBytes, 0);
+        if (written < 0)
+        {
+            if (copied == 0 && (errno == EXDEV || errno == ENOSYS || errno == EOPNOTSUPP || errno == EINVAL))
+            {
+                return std::nullopt;
+            }
+            return failure(std::strerror(errno));
+        }
+        if (written == 0)
+        {
+            break;
+        }
+        copied += static_cast<std::uint64_t>(written);
+        if (!report(progress, copied, size))
+        {
+            return failure("Copy cancelled");
+        }
+    }
+
+    return success(Method::Kernel, copied);
+}
+
+bool syncFile(const std::filesystem::path &path)
+{
+    FileDescriptor file(::open(path.c_str(), O_WRONLY | O_CLOEXEC));
+    return file.get() >= 0 && ::fdatasync(file.get()) == 0;
+}
+#elif defined(__APPLE__)
+bool cloneFile(const std::filesystem::path &source, const std::filesystem::path &target)
+{
+    return ::clonefile(source.c_str(), target.c_str(), 0) == 0;
+}
+
+std::optional<Result> kernelCopy(const std::filesystem::path &,
+                                 const std::filesystem::path &,
+                                 std::uint64_t,
+                                 const Progress &)
+{
+    return std::nullopt;
+}
+
+bool syncFile(const std::filesystem::path &path)
+{
+    // fsync alone leaves the data in the drive's cache on macOS.
+    const int fd = ::open(path.c_str(), O_WRONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        return false;
+    }
+    const bool synced = ::fcntl(fd, F_FULLFSYNC) == 0 || ::fsync(fd) == 0;
+    ::close(fd);
+    return synced;
+}
+#else
+bool cloneFile(const std::filesystem::path &, const std::filesystem::path &)
+{
+    return false;
+}
+
+std::optional<Result> kernelCopy(const std::filesystem::path &,
+                                 const std::filesystem::path &,
+                                 std::uint64_t,
+                                 const Progress &)
+{
+    return std::nullopt;
+}
+
+bool syncFile(const std::filesystem::path &)
+{
+    return true;
+}
+#endif
+
+// Reads source in chunks, handing each one to the sink and, when given, writing it to target.
+Result streamedCopy(const std::filesystem::path &source,
+                    const std::filesystem::path *target,
+                    std::uint64_t size,
+                    const Progress &progress,
+                    const FileCopy::Sink &sink)
+{
+    std::ifstream in(source, std::ios::binary);
+    std::ofstream out;
+    if (target)
+    {
+        out.open(*target, std::ios::binary | std::ios::trunc);
+    }
+    if (!in || (target && !out))
+    {
+        return failure("Unable to open files for copying");
+    }
+
+    std::vector<char> buffer(kChunkBytes);
+    std::uint64_t copied = 0;
+    while (in)
+    {
+        in.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        const std::streamsize count = in.gcount();
+        if (count <= 0)
+        {
+            break;
+        }
+        if (sink)
+        {
+            sink(buffer.data(), static_cast<std::size_t>(count));
+        }
+        if (target && !out.write(buffer.data(), count))
+        {
+            return failure("Write failed");
+        }
+        copied += static_cast<std::uint64_t>(count);
+        if (!report(progress, copied, size))
+        {
+            return failure("Copy cancelled");
+        }
+    }
+
+    if (in.bad() || (target && !out.flush()))
+    {
+        return failure("Copy failed");
+    }
+    return success(Method::Streamed, copied);
+}
+} // namespace
+
+namespace FileCopy
+{
+Result copy(const std::filesystem::path &source,
+            const std::filesystem::path &destination,
+            const Progress &progress,
+            const Sink &sink)
+{
+#if FINALPROJECT_TRACING
+    Trace::Span span("FileCopy::copy", "io");
+    if (span)
+    {
+        span.setDetail(destination.filename().string());
+    }
+#endif
+
+    std::error_code error;
+    const std::uint64_t size = std::filesystem::file_size(source, error);
+    if (error)
+    {
+        return failure(error.message());
+    }
+
+    std::filesystem::path partial = destination;
+    partial += ".part";
+    std::filesystem::remove(partial, error);
+
+    std::optional<Result> result;
+    if (cloneFile(source, partial))
+    {
+        // The clone shares the source's blocks, so reading it back for the sink is the only pass.
+        result = sink ? streamedCopy(partial, nullptr, size, progress, sink) : success(Method::Clone, size);
+        if (result->success)
+        {
+            result->method = Method::Clone;
+            report(progress, size, size);
+        }
+    }
+    else
+    {
+        result = kernelCopy(source, partial, size, progress);
+        // The copy just landed in the page cache, so reading it back for the sink is cheap
+        // next to pushing every byte of the copy itself through user space.
+        if (result && result->success && sink)
+        {
+            const Result hashed = streamedCopy(partial, nullptr, size, {}, sink);
+            if (!hashed.success)
+            {
+                result = hashed;
+            }
+        }
+    }
+
+    if (!result)
+    {
+        result = streamedCopy(source, &partial, size, progress, sink);
+    }
+
+    // Durable before it becomes visible under its final name.
+    if (result->success && !syncFile(partial))
+    {
+        result = failure("Unable to flush the copy to disk");
+    }
+
+    if (result->success)
+    {
+        std::filesystem::rename(partial, destination, error);
+        if (error)
+        {
+            result = failure(error.message());
+        }
+    }
+
+    if (!result->success)
+    {
+        std::filesystem::remove(partial, error);
+    }
+    return *result;
+}
+
+const char *methodName(Method method)
+{
+    switch (method)
+    {
+    case Method::Clone:
+        return "clone";
+    case Method::Kernel:
+        return "kernel";
+    case Method::Streamed:
+        return "streamed";
+    case Method::None:
+        break;
+    }
+    return "none";
+}
+}
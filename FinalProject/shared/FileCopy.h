@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <string>
+
+// Copies large media files with the cheapest mechanism the platform and file system offer:
+// a copy-on-write clone where supported, an in-kernel copy otherwise, and a chunked
+// read/write loop as the last resort. The data is written next to the destination and
+// renamed into place once complete, so readers never observe a partial file.
+//
+// When a sink is given every byte of the file is also handed to it, for hashing. Clones and
+// kernel copies still apply and the sink reads the landed copy back from the page cache;
+// only the streamed fallback feeds it while copying. Every copy is flushed to disk before
+// the rename.
+namespace FileCopy
+{
+enum class Method
+{
+    None,
+    Clone,
+    Kernel,
+    Streamed
+};
+
+struct Result
+{
+    bool success = false;
+    Method method = Method::None;
+    std::uint64_t bytes = 0;
+    std::string error;
+};
+
+// Called as data lands; returning false cancels the copy.
+using Progress = std::function<bool(std::uint64_t copied, std::uint64_t total)>;
+using Sink = std::function<void(const char *data, std::size_t size)>;
+
+Result copy(const std::filesystem::path &source,
+            const std::filesystem::path &destination,
+            const Progress &progress = {},
+            const Sink &sink = {});
+
+const char *methodName(Method method);
+}
@@ -0,0 +1,239 @@
+#include "MediaStore.h"
+
+#include "DatabaseUtils.h"
+#include "../core/Metrics.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QMutex>
+#include <QRegularExpression>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QUuid>
+
+namespace
+{
+const char *kStagingDir = ".staging";
+// Files younger than this may belong to an import that has not committed yet.
+const qint64 kGraceSecs = 3600;
+
+QMutex &storeMutex()
+{
+    static QMutex mutex;
+    return mutex;
+}
+
+QHash<QString, int> &pinned()
+{
+    static QHash<QString, int> paths;
+    return paths;
+}
+
+std::filesystem::path toPath(const QString &path)
+{
+    return std::filesystem::path(path.toStdU16String());
+}
+
+void touch(const QString &path)
+{
+    QFile file(path);
+    if (file.open(QIODevice::ReadWrite))
+    {
+        file.setFileTime(QDateTime::currentDateTimeUtc(), QFileDevice::FileModificationTime);
+    }
+}
+
+bool isStoreFile(const QFileInfo &info)
+{
+    static const QRegularExpression bucket(QStringLiteral("^[0-9a-f]{2}$"));
+    static const QRegularExpression blob(QStringLiteral("^[0-9a-f]{64}$"));
+    return bucket.match(info.dir().dirName()).hasMatch() && blob.match(info.completeBaseName()).hasMatch();
+}
+} // namespace
+
+namespace MediaStore
+{
+std::optional<StoredBlob> import(const QString &source,
+                                 const QString &rootDir,
+                                 const FileCopy::Progress &progress,
+                                 QString *error)
+{
+    QDir root(rootDir);
+    if (!root.mkpath(QString::fromLatin1(kStagingDir)))
+    {
+        *error = QStringLiteral("Unable to create %1").arg(root.filePath(QString::fromLatin1(kStagingDir)));
+        return std::nullopt;
+    }
+
+    const QString staging = root.filePath(QStringLiteral("%1/%2").arg(QString::fromLatin1(kStagingDir),
+                                                                      QUuid::createUuid().toString(QUuid::WithoutBraces)));
+    QCryptographicHash hash(QCryptographicHash::Blake2b_256);
+    const auto copy = FileCopy::copy(toPath(source), toPath(staging), progress, [&hash](const char *data, std::size_t size) {
+        hash.addData(QByteArrayView(data, static_cast<qsizetype>(size)));
+    });
+    if (!copy.success)
+    {
+        *error = QString::fromStdString(copy.error);
+        return std::nullopt;
+    }
+    Metrics::counter("finalproject_media_imports_total", "Files imported into the media store, by copy method",
+                     {{"method", FileCopy::methodName(copy.method)}})
+        .add();
+
+    StoredBlob blob;
+    blob.hash = QString::fromLatin1(hash.result().toHex());
+    blob.size = static_cast<qint64>(copy.bytes);
+
+    const QString suffix = QFileInfo(source).suffix().toLower();
+    const QString bucket = blob.hash.left(2);
+    const QString relative = QStringLiteral("%1/%2.%3").arg(bucket, blob.hash, suffix.isEmpty() ? QStringLiteral("dat") : suffix);
+    const QString destination = root.filePath(relative);
+
+    QMutexLocker lock(&storeMutex());
+    if (QFileInfo::exists(destination))
+    {
+        // Refresh the timestamp so a concurrent collection treats the blob as new again.
+        QFile::remove(staging);
+        touch(destination);
+        blob.reused = true;
+    }
+    else if (!root.mkpath(bucket) || !QFile::rename(staging, destination))
+    {
+        QFile::remove(staging);
+        *error = QStringLiteral("Unable to store %1").arg(relative);
+        return std::nullopt;
+    }
+
+    blob.path = DatabaseUtils::toRelativeMediaPath(destination);
+    ++pinned()[blob.path];
+    return blob;
+}
+
+void release(const QString &path)
+{
+    QMutexLocker lock(&storeMutex());
+    auto it = pinned().find(path);
+    if (it != pinned().end() && --it.value() <= 0)
+    {
+        pinned().erase(it);
+    }
+}
+
+GarbageReport collectGarbage(QSqlDatabase &db, const QStringList &rootDirs)
+{
+    GarbageReport report;
+    QMutexLocker lock(&storeMutex());
+
+    QStringList doomed;
+    if (!db.transaction())
+    {
+        return report;
+    }
+
+    QSqlQuery unreferenced(db);
+    unreferenced.prepare(QStringLiteral(
+        "SELECT path FROM media_blobs WHERE ref_count <= 0 AND created_at < datetime('now', ?)"));
+    unreferenced.addBindValue(QStringLiteral("-%1 seconds").arg(kGraceSecs));
+    if (DatabaseUtils::exec(unreferenced))
+    {
+        while (unreferenced.next())
+        {
+            const QString path = unreferenced.value(0).toString();
+            if (!pinned().contains(path))
+            {
+                doomed.append(path);
+            }
+        }
+    }
+    unreferenced.finish();
+
+    QSqlQuery remove(db);
+    remove.prepare(QStringLiteral("DELETE FROM media_blobs WHERE path = ? AND ref_count <= 0"));
+    for (const QString &path : std::as_const(doomed))
+    {
+        remove.addBindValue(path);
+        DatabaseUtils::exec(remove);
+    }
+    if (!db.commit())
+    {
+        qWarning() << "Media garbage collection failed:" << db.lastError().text();
+        db.rollback();
+        return report;
+    }
+
+    // Files that never made it into media_blobs: interrupted imports and failed commits.
+    const QDateTime cutoff = QDateTime::currentDateTimeUtc().addSecs(-kGraceSecs);
+    QSqlQuery known(db);
+    known.prepare(QStringLiteral("SELECT 1 FROM media_blobs WHERE path = ?"));
+    QStringList stray;
+    for (const QString &rootDir : rootDirs)
+    {
+        QDirIterator it(rootDir, QDir::Files | QDir::Hidden, QDirIterator::Subdirectories);
+        while (it.hasNext())
+        {
+            const QFileInfo info(it.next());
+            if (info.lastModified().toUTC() >= cutoff)
+            {
+                continue;
+            }
+            if (info.dir().dirName() == QLatin1String(kStagingDir))
+            {
+                stray.append(info.absoluteFilePath());
+                continue;
+            }
+            if (!isStoreFile(info))
+            {
+                continue;
+            }
+
+            const QString path = DatabaseUtils::toRelativeMediaPath(info.absoluteFilePath());
+            known.addBindValue(path);
+            const bool registered = DatabaseUtils::exec(known) && known.next();
+            known.finish();
+            if (!registered && !pinned().contains(path))
+            {
+                doomed.append(path);
+            }
+        }
+    }
+
+    const auto removeFile = [&report](const QString &file) {
+        const qint64 size = QFileInfo(file).size();
+        if (!QFile::remove(file))
+        {
+            return false;
+        }
+        report.removedBytes += size;
+        return true;
+    };
+
+    for (const QString &path : std::as_const(doomed))
+    {
+        const QFileInfo blob(DatabaseUtils::toAbsoluteMediaPath(path));
+        if (removeFile(blob.absoluteFilePath()))
+        {
+            ++report.removedBlobs;
+        }
+        // Derived files such as thumbnail variants share the blob's name and go with it.
+        const QDir dir = blob.dir();
+        for (const QString &name : dir.entryList({blob.completeBaseName() + QStringLiteral(".*")}, QDir::Files))
+        {
+            stray.append(dir.filePath(name));
+        }
+    }
+    for (const QString &file : std::as_const(stray))
+    {
+        if (removeFile(file))
+        {
+            ++report.removedFiles;
+        }
+    }
+    return report;
+}
+}
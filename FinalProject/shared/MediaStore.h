@@ -0,0 +1,46 @@
+#pragma once
+
+#include "FileCopy.h"
+
+#include <QSqlDatabase>
+#include <QString>
+#include <QStringList>
+
+#include <optional>
+
+struct StoredBlob
+{
+    // Relative to the project media root, as stored in media_files.
+    QString path;
+    QString hash;
+    qint64 size = 0;
+    // True when identical content was already in the store and the copy was discarded.
+    bool reused = false;
+};
+
+struct GarbageReport
+{
+    int removedBlobs = 0;
+    // Thumbnail variants of removed blobs and leftovers of interrupted imports.
+    int removedFiles = 0;
+    // Across blobs and other files.
+    qint64 removedBytes = 0;
+};
+
+// Content-addressed media storage. Files live at <root>/<h[0..1]>/<h>.<ext>, where h is the
+// BLAKE2b-256 digest of the content computed while the file is copied in, so importing the
+// same trailer or poster twice stores it once. media_blobs tracks how many media_files rows
+// reference each blob; collectGarbage() removes blobs nobody references any more.
+namespace MediaStore
+{
+// The returned blob is pinned, which keeps garbage collection away from it until the row
+// that references it is committed and release() is called.
+std::optional<StoredBlob> import(const QString &source,
+                                 const QString &rootDir,
+                                 const FileCopy::Progress &progress,
+                                 QString *error);
+void release(const QString &path);
+
+// Deletes unreferenced blobs and stray store files older than the grace period.
+GarbageReport collectGarbage(QSqlDatabase &db, const QStringList &rootDirs);
+}
@@ -0,0 +1,100 @@
+#include "Migrations.h"
+
+#include "DatabaseUtils.h"
+#include "SchemaSql.h"
+
+#include <QDebug>
+#include <QSqlError>
+#include <QSqlQuery>
+
+namespace
+{
+bool execute(QSqlDatabase &db, const QString &sql)
+{
+    QSqlQuery query(db);
+    if (!DatabaseUtils::exec(query, sql))
+    {
+        qWarning() << "SQL error:" << query.lastError().text() << "while executing" << sql;
+        return false;
+    }
+    return true;
+}
+
+bool shouldSkip(QSqlDatabase &db, const SchemaSql::Statement &statement)
+{
+    if (!statement.skipWhen)
+    {
+        return false;
+    }
+
+    QSqlQuery query(db);
+    return DatabaseUtils::exec(query, QString::fromUtf8(statement.skipWhen)) && query.next() && query.value(0).toInt() != 0;
+}
+
+bool apply(QSqlDatabase &db, const SchemaSql::Migration &migration)
+{
+    for (const auto &statement : migration.statements)
+    {
+        if (shouldSkip(db, statement))
+        {
+            continue;
+        }
+        if (!execute(db, QString::fromUtf8(statement.sql)))
+        {
+            return false;
+        }
+    }
+    return execute(db, QStringLiteral("PRAGMA user_version = %1").arg(migration.version));
+}
+} // namespace
+
+namespace Migrations
+{
+int schemaVersion(QSqlDatabase &db)
+{
+    QSqlQuery query(db);
+    if (DatabaseUtils::exec(query, QStringLiteral("PRAGMA user_version")) && query.next())
+    {
+        return query.value(0).toInt();
+    }
+    return -1;
+}
+
+bool migrate(QSqlDatabase &db)
+{
+    if (schemaVersion(db) >= SchemaSql::latestVersion())
+    {
+        return true;
+    }
+
+    for (const auto &migration : SchemaSql::migrations())
+    {
+        // IMMEDIATE takes the write lock up front, so a second process racing through the
+        // same upgrade waits here and then sees the bumped version.
+        if (!execute(db, QStringLiteral("BEGIN IMMEDIATE")))
+        {
+            return false;
+        }
+
+        const int current = schemaVersion(db);
+        if (current < 0)
+        {
+            execute(db, QStringLiteral("ROLLBACK"));
+            return false;
+        }
+        if (current >= migration.version)
+        {
+            execute(db, QStringLiteral("ROLLBACK"));
+            continue;
+        }
+
+        if (!apply(db, migration) || !execute(db, QStringLiteral("COMMIT")))
+        {
+            qWarning() << "Migration" << migration.version << migration.description << "failed";
+            execute(db, QStringLiteral("ROLLBACK"));
+            return false;
+        }
+    }
+    return true;
+}
+}
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <QSqlDatabase>
+
+// Brings a database up to the schema in SchemaSql. Every migration newer than the stored
+// PRAGMA user_version runs once, inside its own write transaction together with the
+// version bump, so a failed step leaves the database at the previous version.
+namespace Migrations
+{
+int schemaVersion(QSqlDatabase &db);
+bool migrate(QSqlDatabase &db);
+}
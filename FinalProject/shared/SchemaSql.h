@@ -0,0 +1,203 @@
+#pragma once
+
+#include <vector>
+
+// The database schema as an ordered list of migrations. Plain SQL with no Qt dependency so
+// that tools talking to SQLite directly can build the same schema as the application.
+namespace SchemaSql
+{
+struct Statement
+{
+    const char *sql;
+    // Optional scalar query; the statement is skipped when it returns a non-zero value.
+    const char *skipWhen = nullptr;
+};
+
+struct Migration
+{
+    // Value stored in PRAGMA user_version once the migration has been applied.
+    int version;
+    const char *description;
+    std::vector<Statement> statements;
+};
+
+inline const std::vector<Migration> &migrations()
+{
+    static const std::vector<Migration> steps = {
+        {1,
+         "Base schema",
+         {
+             {"CREATE TABLE IF NOT EXISTS users ("
+              "    id          INTEGER PRIMARY KEY AUTOINCREMENT,"
+              "    email       TEXT NOT NULL UNIQUE,"
+              "    password    TEXT NOT NULL,"
+              "    created_at  TEXT NOT NULL DEFAULT (datetime('now')),"
+              "    role        TEXT NOT NULL DEFAULT 'user'"
+              ")"},
+             {"CREATE TABLE IF NOT EXISTS profiles ("
+              "    id          INTEGER PRIMARY KEY AUTOINCREMENT,"
+              "    user_id     INTEGER NOT NULL,"
+              "    name        TEXT NOT NULL,"
+              "    avatar_url  TEXT,"
+              "    is_kid      INTEGER NOT NULL DEFAULT 0,"
+              "    created_at  TEXT NOT NULL DEFAULT (datetime('now')),"
+              "    FOREIGN KEY (user_id) REFERENCES users(id) ON DELETE CASCADE"
+              ")"},
+             {"CREATE TABLE IF NOT EXISTS titles ("
+              "    id           INTEGER PRIMARY KEY AUTOINCREMENT,"
+              "    type         TEXT NOT NULL,"
+              "    name         TEXT NOT NULL,"
+              "    description  TEXT,"
+              "    release_year INTEGER,"
+              "    age_rating   TEXT,"
+              "    runtime_min  INTEGER,"
+              "    accent_color TEXT,"
+              "    created_at   TEXT NOT NULL DEFAULT (datetime('now'))"
+              ")"},
+             {"CREATE TABLE IF NOT EXISTS genres ("
+              "    id    INTEGER PRIMARY KEY AUTOINCREMENT,"
+              "    name  TEXT NOT NULL UNIQUE"
+              ")"},
+             {"CREATE TABLE IF NOT EXISTS title_genres ("
+              "    title_id INTEGER NOT NULL,"
+              "    genre_id INTEGER NOT NULL,"
+              "    PRIMARY KEY (title_id, genre_id),"
+              "    FOREIGN KEY (title_id) REFERENCES titles(id) ON DELETE CASCADE,"
+              "    FOREIGN KEY (genre_id) REFERENCES genres(id) ON DELETE CASCADE"
+              ")"},
+             {"CREATE TABLE IF NOT EXISTS media_files ("
+              "    id            INTEGER PRIMARY KEY AUTOINCREMENT,"
+              "    title_id      INTEGER NOT NULL,"
+              "    video_url     TEXT NOT NULL,"
+              "    thumbnail_url TEXT NOT NULL,"
+              "    created_at    TEXT NOT NULL DEFAULT (datetime('now')),"
+              "    FOREIGN KEY (title_id) REFERENCES titles(id) ON DELETE CASCADE"
+              ")"},
+             {"CREATE TABLE IF NOT EXISTS watch_history ("
+              "    id           INTEGER PRIMARY KEY AUTOINCREMENT,"
+              "    profile_id   INTEGER NOT NULL,"
+              "    title_id     INTEGER NOT NULL,"
+              "    position_sec INTEGER NOT NULL DEFAULT 0,"
+              "    is_finished  INTEGER NOT NULL DEFAULT 0,"
+              "    updated_at   TEXT NOT NULL DEFAULT (datetime('now')),"
+              "    FOREIGN KEY (profile_id) REFERENCES profiles(id) ON DELETE CASCADE,"
+              "    FOREIGN KEY (title_id) REFERENCES titles(id) ON DELETE CASCADE"
+              ")"},
+             {"CREATE TABLE IF NOT EXISTS my_list ("
+              "    profile_id INTEGER NOT NULL,"
+              "    title_id   INTEGER NOT NULL,"
+              "    added_at   TEXT NOT NULL DEFAULT (datetime('now')),"
+              "    PRIMARY KEY (profile_id, title_id),"
+              "    FOREIGN KEY (profile_id) REFERENCES profiles(id) ON DELETE CASCADE,"
+              "    FOREIGN KEY (title_id) REFERENCES titles(id) ON DELETE CASCADE"
+              ")"},
+             {"CREATE TABLE IF NOT EXISTS subscription_plans ("
+              "    id             INTEGER PRIMARY KEY AUTOINCREMENT,"
+              "    name           TEXT NOT NULL UNIQUE,"
+              "    price_month    REAL NOT NULL,"
+              "    duration_days  INTEGER NOT NULL,"
+              "    max_profiles   INTEGER NOT NULL,"
+              "    max_quality    TEXT NOT NULL"
+              ")"},
+             {"CREATE TABLE IF NOT EXISTS user_subscriptions ("
+              "    id          INTEGER PRIMARY KEY AUTOINCREMENT,"
+              "    user_id     INTEGER NOT NULL,"
+              "    plan_id     INTEGER NOT NULL,"
+              "    start_date  TEXT NOT NULL,"
+              "    end_date    TEXT NOT NULL,"
+              "    is_active   INTEGER NOT NULL DEFAULT 1,"
+              "    created_at  TEXT NOT NULL DEFAULT (datetime('now')),"
+              "    FOREIGN KEY (user_id) REFERENCES users(id) ON DELETE CASCADE,"
+              "    FOREIGN KEY (plan_id) REFERENCES subscription_plans(id) ON DELETE CASCADE"
+              ")"},
+         }},
+        {2,
+         "Add users.role to databases created before roles existed",
+         {
+             {"ALTER TABLE users ADD COLUMN role TEXT NOT NULL DEFAULT 'user'",
+              "SELECT COUNT(*) FROM pragma_table_info('users') WHERE name = 'role'"},
+         }},
+        {3,
+         "Indexes for profile, catalog and media lookups",
+         {
+             {"CREATE INDEX IF NOT EXISTS idx_watch_history_profile_updated ON watch_history(profile_id, updated_at)"},
+             {"CREATE INDEX IF NOT EXISTS idx_my_list_profile_added ON my_list(profile_id, added_at)"},
+             {"CREATE INDEX IF NOT EXISTS idx_title_genres_genre ON title_genres(genre_id)"},
+             {"CREATE INDEX IF NOT EXISTS idx_media_files_title ON media_files(title_id)"},
+             {"CREATE INDEX IF NOT EXISTS idx_titles_created_at ON titles(created_at)"},
+         }},
+        {4,
+         "One watch_history row per profile and title",
+         {
+             {"DELETE FROM watch_history WHERE id NOT IN "
+              "(SELECT MAX(id) FROM watch_history GROUP BY profile_id, title_id)"},
+             {"CREATE UNIQUE INDEX IF NOT EXISTS ux_watch_history_profile_title ON watch_history(profile_id, title_id)"},
+         }},
+        {5,
+         "Content-addressed media blobs, reference counted from media_files",
+         {
+             {"CREATE TABLE IF NOT EXISTS media_blobs ("
+              "    path       TEXT PRIMARY KEY,"
+              "    hash       TEXT NOT NULL,"
+              "    size       INTEGER NOT NULL,"
+              "    ref_count  INTEGER NOT NULL DEFAULT 0,"
+              "    created_at TEXT NOT NULL DEFAULT (datetime('now'))"
+              ")"},
+             {"CREATE INDEX IF NOT EXISTS idx_media_blobs_unreferenced ON media_blobs(created_at) WHERE ref_count <= 0"},
+             {"CREATE TRIGGER IF NOT EXISTS media_files_blob_insert AFTER INSERT ON media_files BEGIN "
+              "UPDATE media_blobs SET ref_count = ref_count + 1 WHERE path = NEW.video_url; "
+              "UPDATE media_blobs SET ref_count = ref_count + 1 WHERE path = NEW.thumbnail_url; "
+              "END"},
+             {"CREATE TRIGGER IF NOT EXISTS media_files_blob_delete AFTER DELETE ON media_files BEGIN "
+              "UPDATE media_blobs SET ref_count = ref_count - 1 WHERE path = OLD.video_url; "
+              "UPDATE media_blobs SET ref_count = ref_count - 1 WHERE path = OLD.thumbnail_url; "
+              "END"},
+             {"CREATE TRIGGER IF NOT EXISTS media_files_blob_update AFTER UPDATE OF video_url, thumbnail_url ON media_files BEGIN "
+              "UPDATE media_blobs SET ref_count = ref_count - 1 WHERE path = OLD.video_url; "
+              "UPDATE media_blobs SET ref_count = ref_count - 1 WHERE path = OLD.thumbnail_url; "
+              "UPDATE media_blobs SET ref_count = ref_count + 1 WHERE path = NEW.video_url; "
+              "UPDATE media_blobs SET ref_count = ref_count + 1 WHERE path = NEW.thumbnail_url; "
+              "END"},
+         }},
+        {6,
+         "Catalog change counter for cached catalog snapshots",
+         {
+             {"CREATE TABLE IF NOT EXISTS catalog_version ("
+              "    id      INTEGER PRIMARY KEY CHECK (id = 1),"
+              "    version INTEGER NOT NULL"
+              ")"},
+             {"INSERT OR IGNORE INTO catalog_version (id, version) VALUES (1, 0)"},
+             {"CREATE TRIGGER IF NOT EXISTS titles_catalog_insert AFTER INSERT ON titles "
+              "BEGIN UPDATE catalog_version SET version = version + 1; END"},
+             {"CREATE TRIGGER IF NOT EXISTS titles_catalog_update AFTER UPDATE ON titles "
+              "BEGIN UPDATE catalog_version SET version = version + 1; END"},
+             {"CREATE TRIGGER IF NOT EXISTS titles_catalog_delete AFTER DELETE ON titles "
+              "BEGIN UPDATE catalog_version SET version = version + 1; END"},
+             {"CREATE TRIGGER IF NOT EXISTS genres_catalog_insert AFTER INSERT ON genres "
+              "BEGIN UPDATE catalog_version SET version = version + 1; END"},
+             {"CREATE TRIGGER IF NOT EXISTS genres_catalog_update AFTER UPDATE ON genres "
+              "BEGIN UPDATE catalog_version SET version = version + 1; END"},
+             {"CREATE TRIGGER IF NOT EXISTS genres_catalog_delete AFTER DELETE ON genres "
+              "BEGIN UPDATE catalog_version SET version = version + 1; END"},
+             {"CREATE TRIGGER IF NOT EXISTS title_genres_catalog_insert AFTER INSERT ON title_genres "
+              "BEGIN UPDATE catalog_version SET version = version + 1; END"},
+             {"CREATE TRIGGER IF NOT EXISTS title_genres_catalog_update AFTER UPDATE ON title_genres "
+              "BEGIN UPDATE catalog_version SET version = version + 1; END"},
+             {"CREATE TRIGGER IF NOT EXISTS title_genres_catalog_delete AFTER DELETE ON title_genres "
+              "BEGIN UPDATE catalog_version SET version = version + 1; END"},
+             {"CREATE TRIGGER IF NOT EXISTS media_files_catalog_insert AFTER INSERT ON media_files "
+              "BEGIN UPDATE catalog_version SET version = version + 1; END"},
+             {"CREATE TRIGGER IF NOT EXISTS media_files_catalog_update AFTER UPDATE ON media_files "
+              "BEGIN UPDATE catalog_version SET version = version + 1; END"},
+             {"CREATE TRIGGER IF NOT EXISTS media_files_catalog_delete AFTER DELETE ON media_files "
+              "BEGIN UPDATE catalog_version SET version = version + 1; END"},
+         }},
+    };
+    return steps;
+}
+
+inline int latestVersion()
+{
+    return migrations().empty() ? 0 : migrations().back().version;
+}
+} // namespace SchemaSql